@@ -0,0 +1,402 @@
+#include "streamup-hotkey-core-actions.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+constexpr uint32_t MAX_SEED_ATTEMPTS = 1u << 20;
+constexpr size_t ENTRIES_PER_BUCKET = 4;
+
+// 64-bit finaliser (MurmurHash3 fmix64)
+uint64_t finaliseHash(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+uint32_t bucketOf(uint64_t key, uint32_t bucketCount)
+{
+	return (uint32_t)((key >> 32) % bucketCount);
+}
+
+uint32_t slotOf(uint64_t key, uint32_t seed, uint32_t slotCount)
+{
+	return (uint32_t)(finaliseHash(key ^ ((uint64_t)seed * 0x9E3779B97F4A7C15ull)) % slotCount);
+}
+
+std::string_view trimSpaces(std::string_view text)
+{
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) {
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+		text.remove_suffix(1);
+	}
+	return text;
+}
+
+char asciiLower(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+template<typename T> void appendLittleEndian(std::string &out, T value)
+{
+	for (size_t i = 0; i < sizeof(T); i++) {
+		out.push_back((char)((uint64_t)value >> (8 * i)));
+	}
+}
+
+} // namespace
+
+uint64_t actionDictionaryKey(uint64_t chordHash, std::string_view application)
+{
+	uint64_t applicationHash = 0;
+	if (!application.empty()) {
+		applicationHash = 14695981039346656037ull;
+		for (char c : application) {
+			applicationHash ^= (unsigned char)asciiLower(c);
+			applicationHash *= 1099511628211ull;
+		}
+	}
+	return finaliseHash(chordHash ^ (applicationHash * 0x9E3779B97F4A7C15ull));
+}
+
+std::vector<ActionDictionaryEntry> parseActionDictionarySource(std::string_view text, std::vector<std::string> *errors)
+{
+	std::vector<ActionDictionaryEntry> entries;
+	std::string application;
+	size_t lineNumber = 0;
+
+	auto reportError = [&](const char *message) {
+		if (errors) {
+			errors->push_back("line " + std::to_string(lineNumber) + ": " + message);
+		}
+	};
+
+	while (!text.empty()) {
+		size_t end = text.find('\n');
+		std::string_view line = trimSpaces(text.substr(0, end));
+		text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+		lineNumber++;
+
+		if (line.empty() || line.front() == '#') {
+			continue;
+		}
+
+		if (line.front() == '[') {
+			if (line.back() != ']') {
+				reportError("unterminated section name");
+				continue;
+			}
+			std::string_view name = trimSpaces(line.substr(1, line.size() - 2));
+			application.clear();
+			if (name != "*") {
+				for (char c : name) {
+					application.push_back(asciiLower(c));
+				}
+			}
+			continue;
+		}
+
+		// The last " = " separates the label, so a chord like "Ctrl + =" still parses
+		size_t separator = line.rfind(" = ");
+		if (separator == std::string_view::npos) {
+			reportError("expected 'chord = action'");
+			continue;
+		}
+
+		ActionDictionaryEntry entry;
+		entry.application = application;
+		entry.chord = normaliseChordText(line.substr(0, separator));
+		entry.label = std::string(trimSpaces(line.substr(separator + 3)));
+		if (entry.chord.empty() || entry.label.empty()) {
+			reportError("empty chord or action");
+			continue;
+		}
+		entries.push_back(std::move(entry));
+	}
+
+	return entries;
+}
+
+bool buildActionDictionary(const std::vector<ActionDictionaryEntry> &entries, std::string &out)
+{
+	// Unique keys (later duplicates win) and a deduplicated label pool
+	std::unordered_map<uint64_t, size_t> keyIndex;
+	std::vector<uint64_t> keys;
+	std::vector<uint32_t> labelOffsets;
+	std::vector<uint32_t> labelLengths;
+	std::unordered_map<std::string, uint32_t> labelPool;
+	std::string labels;
+
+	for (const ActionDictionaryEntry &entry : entries) {
+		auto pooled = labelPool.find(entry.label);
+		uint32_t offset;
+		if (pooled != labelPool.end()) {
+			offset = pooled->second;
+		} else {
+			offset = (uint32_t)labels.size();
+			labels += entry.label;
+			labelPool.emplace(entry.label, offset);
+		}
+
+		uint64_t key = actionDictionaryKey(hashChordText(entry.chord), entry.application);
+		auto existing = keyIndex.find(key);
+		if (existing != keyIndex.end()) {
+			labelOffsets[existing->second] = offset;
+			labelLengths[existing->second] = (uint32_t)entry.label.size();
+			continue;
+		}
+		keyIndex.emplace(key, keys.size());
+		keys.push_back(key);
+		labelOffsets.push_back(offset);
+		labelLengths.push_back((uint32_t)entry.label.size());
+	}
+
+	// Hash and displace: place the largest buckets first, each with the first seed that maps all of
+	// its keys to free slots. A slot table 10% larger than the key count keeps the search short.
+	uint32_t entryCount = (uint32_t)keys.size();
+	uint32_t slotCount = std::max<uint32_t>(1, entryCount + entryCount / 10 + 1);
+	uint32_t bucketCount = std::max<uint32_t>(1, (uint32_t)((entryCount + ENTRIES_PER_BUCKET - 1) / ENTRIES_PER_BUCKET));
+
+	std::vector<std::vector<uint32_t>> buckets(bucketCount);
+	for (uint32_t i = 0; i < entryCount; i++) {
+		buckets[bucketOf(keys[i], bucketCount)].push_back(i);
+	}
+	std::vector<uint32_t> order(bucketCount);
+	for (uint32_t i = 0; i < bucketCount; i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(),
+			 [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+	std::vector<uint32_t> seeds(bucketCount, 0);
+	std::vector<int64_t> slotEntry(slotCount, -1);
+	std::vector<uint32_t> candidate;
+	for (uint32_t bucket : order) {
+		const std::vector<uint32_t> &members = buckets[bucket];
+		if (members.empty()) {
+			break;
+		}
+
+		bool placed = false;
+		for (uint32_t seed = 0; seed < MAX_SEED_ATTEMPTS && !placed; seed++) {
+			candidate.clear();
+			placed = true;
+			for (uint32_t member : members) {
+				uint32_t slot = slotOf(keys[member], seed, slotCount);
+				bool taken = slotEntry[slot] >= 0 ||
+					     std::find(candidate.begin(), candidate.end(), slot) != candidate.end();
+				if (taken) {
+					placed = false;
+					break;
+				}
+				candidate.push_back(slot);
+			}
+			if (placed) {
+				seeds[bucket] = seed;
+				for (size_t i = 0; i < members.size(); i++) {
+					slotEntry[candidate[i]] = members[i];
+				}
+			}
+		}
+		if (!placed) {
+			return false;
+		}
+	}
+
+	ActionDictionaryHeader header{};
+	memcpy(header.magic, ACTION_DICTIONARY_MAGIC, sizeof(header.magic));
+	header.version = ACTION_DICTIONARY_VERSION;
+	header.entryCount = entryCount;
+	header.bucketCount = bucketCount;
+	header.slotCount = slotCount;
+	header.seedsOffset = sizeof(ActionDictionaryHeader);
+	// Slots start 8-byte aligned after the seeds
+	header.slotsOffset = (header.seedsOffset + (uint64_t)bucketCount * sizeof(uint32_t) + 7) & ~7ull;
+	header.labelsOffset = header.slotsOffset + (uint64_t)slotCount * sizeof(ActionDictionarySlot);
+	header.labelsSize = labels.size();
+
+	out.clear();
+	out.reserve((size_t)(header.labelsOffset + header.labelsSize));
+	out.append(header.magic, sizeof(header.magic));
+	appendLittleEndian(out, header.version);
+	appendLittleEndian(out, header.entryCount);
+	appendLittleEndian(out, header.bucketCount);
+	appendLittleEndian(out, header.slotCount);
+	appendLittleEndian(out, header.seedsOffset);
+	appendLittleEndian(out, header.slotsOffset);
+	appendLittleEndian(out, header.labelsOffset);
+	appendLittleEndian(out, header.labelsSize);
+
+	for (uint32_t seed : seeds) {
+		appendLittleEndian(out, seed);
+	}
+	out.resize((size_t)header.slotsOffset, '\0');
+
+	for (uint32_t slot = 0; slot < slotCount; slot++) {
+		int64_t entry = slotEntry[slot];
+		appendLittleEndian<uint64_t>(out, entry >= 0 ? keys[(size_t)entry] : 0);
+		appendLittleEndian<uint32_t>(out, entry >= 0 ? labelOffsets[(size_t)entry] : EMPTY_SLOT);
+		appendLittleEndian<uint32_t>(out, entry >= 0 ? labelLengths[(size_t)entry] : 0);
+	}
+
+	out += labels;
+	return true;
+}
+
+ActionDictionary::~ActionDictionary()
+{
+	close();
+}
+
+bool ActionDictionary::open(const std::string &path)
+{
+	close();
+
+	// Map the whole file read-only; only the header is touched here
+#ifdef _WIN32
+	int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+	std::wstring widePath(wideLength > 0 ? (size_t)wideLength : 0, L'\0');
+	if (wideLength <= 0 || MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength) <= 0) {
+		return false;
+	}
+
+	HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(ActionDictionaryHeader)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!handle) {
+		return false;
+	}
+
+	const void *view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(handle);
+		return false;
+	}
+
+	mapping = view;
+	mappingHandle = handle;
+	mappedSize = (size_t)fileSize.QuadPart;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ActionDictionaryHeader)) {
+		::close(fd);
+		return false;
+	}
+
+	void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+
+	// Lookups are scattered; do not read ahead pages that will never be used
+	madvise(view, (size_t)info.st_size, MADV_RANDOM);
+
+	mapping = view;
+	mappedSize = (size_t)info.st_size;
+#endif
+
+	const char *base = static_cast<const char *>(mapping);
+	const ActionDictionaryHeader *mappedHeader = reinterpret_cast<const ActionDictionaryHeader *>(base);
+	// Written so that offsets and sizes from a corrupt file cannot overflow
+	auto fits = [&](uint64_t offset, uint64_t count, uint64_t size) {
+		return offset <= mappedSize && count <= (mappedSize - offset) / size;
+	};
+	bool valid = memcmp(mappedHeader->magic, ACTION_DICTIONARY_MAGIC, sizeof(ACTION_DICTIONARY_MAGIC)) == 0 &&
+		     mappedHeader->version == ACTION_DICTIONARY_VERSION && mappedHeader->bucketCount > 0 &&
+		     mappedHeader->slotCount > 0 && mappedHeader->seedsOffset % alignof(uint32_t) == 0 &&
+		     mappedHeader->slotsOffset % alignof(ActionDictionarySlot) == 0 &&
+		     fits(mappedHeader->seedsOffset, mappedHeader->bucketCount, sizeof(uint32_t)) &&
+		     fits(mappedHeader->slotsOffset, mappedHeader->slotCount, sizeof(ActionDictionarySlot)) &&
+		     fits(mappedHeader->labelsOffset, mappedHeader->labelsSize, 1);
+	if (!valid) {
+		close();
+		return false;
+	}
+
+	header = mappedHeader;
+	seeds = reinterpret_cast<const uint32_t *>(base + header->seedsOffset);
+	slotTable = reinterpret_cast<const ActionDictionarySlot *>(base + header->slotsOffset);
+	labels = base + header->labelsOffset;
+	return true;
+}
+
+void ActionDictionary::close()
+{
+	if (mapping) {
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+#else
+		munmap(const_cast<void *>(mapping), mappedSize);
+#endif
+	}
+	mapping = nullptr;
+	mappedSize = 0;
+	header = nullptr;
+	seeds = nullptr;
+	slotTable = nullptr;
+	labels = nullptr;
+}
+
+std::string_view ActionDictionary::lookup(uint64_t chordHash, std::string_view application) const
+{
+	if (!header) {
+		return {};
+	}
+
+	if (!application.empty()) {
+		std::string_view label = find(actionDictionaryKey(chordHash, application));
+		if (!label.empty()) {
+			return label;
+		}
+	}
+	return find(actionDictionaryKey(chordHash, {}));
+}
+
+std::string_view ActionDictionary::find(uint64_t key) const
+{
+	uint32_t seed = seeds[bucketOf(key, header->bucketCount)];
+	const ActionDictionarySlot &slot = slotTable[slotOf(key, seed, header->slotCount)];
+	if (slot.labelOffset == EMPTY_SLOT || slot.key != key ||
+	    (uint64_t)slot.labelOffset + slot.labelLength > header->labelsSize) {
+		return {};
+	}
+	return std::string_view(labels + slot.labelOffset, slot.labelLength);
+}
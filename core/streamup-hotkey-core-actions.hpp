@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_ACTIONS_HPP
+#define STREAMUP_HOTKEY_CORE_ACTIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shortcut-to-action dictionary ("Ctrl + Shift + P" -> "Command Palette"). Dictionaries are
+// written by hand in a text format and converted once into a compact binary file that the
+// plugin memory-maps; loading only validates the header, pages are faulted in by lookups.
+//
+// Source format, one entry per line. Entries before the first section apply everywhere:
+//
+//   # Comment
+//   Ctrl + Shift + P = Command Palette
+//   [code]
+//   Ctrl + K = Chord prefix
+//
+// Chords are written exactly as they are displayed. Section names are application names,
+// matched case-insensitively.
+//
+// Binary layout (version 1, little endian):
+//   ActionDictionaryHeader
+//   uint32 seeds[bucketCount]        Displacement seed per bucket
+//   ActionDictionarySlot slots[slotCount]
+//   char labels[labelsSize]          UTF-8, not NUL-terminated
+//
+// The key of an entry is actionDictionaryKey(chord hash, application). Lookups use hash and
+// displace perfect hashing: bucket = (key >> 32) % bucketCount, slot = mix(key, seeds[bucket]) % slotCount,
+// then one key comparison. Every lookup touches exactly one seed and one slot.
+
+constexpr char ACTION_DICTIONARY_MAGIC[8] = {'S', 'U', 'H', 'K', 'A', 'C', 'T', '1'};
+constexpr uint32_t ACTION_DICTIONARY_VERSION = 1;
+
+struct ActionDictionaryHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t bucketCount;
+	uint32_t slotCount;
+	uint64_t seedsOffset;
+	uint64_t slotsOffset;
+	uint64_t labelsOffset;
+	uint64_t labelsSize;
+};
+
+struct ActionDictionarySlot {
+	uint64_t key;
+	uint32_t labelOffset; // UINT32_MAX for an empty slot
+	uint32_t labelLength;
+};
+
+static_assert(sizeof(ActionDictionaryHeader) == 56, "ActionDictionaryHeader layout is part of the file format");
+static_assert(sizeof(ActionDictionarySlot) == 16, "ActionDictionarySlot layout is part of the file format");
+
+// Combines a chord hash (hashChordText) with an application name; an empty name is the global scope
+uint64_t actionDictionaryKey(uint64_t chordHash, std::string_view application);
+
+struct ActionDictionaryEntry {
+	std::string application; // Empty = global
+	std::string chord;
+	std::string label;
+};
+
+// Parses the source format. Malformed lines are reported through errors as "line N: ..." and
+// skipped.
+std::vector<ActionDictionaryEntry> parseActionDictionarySource(std::string_view text, std::vector<std::string> *errors = nullptr);
+
+// Builds the binary file contents. Later duplicates win. Returns false if no perfect hash was
+// found, which only happens for pathological inputs.
+bool buildActionDictionary(const std::vector<ActionDictionaryEntry> &entries, std::string &out);
+
+// Read-only view of a memory-mapped dictionary file. lookup() is safe from any thread.
+class ActionDictionary {
+public:
+	ActionDictionary() = default;
+	~ActionDictionary();
+	ActionDictionary(const ActionDictionary &) = delete;
+	ActionDictionary &operator=(const ActionDictionary &) = delete;
+
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const { return mapping != nullptr; }
+	uint32_t entryCount() const { return header ? header->entryCount : 0; }
+
+	// Label for the chord in the given application, falling back to the global scope.
+	// The view points into the mapping and stays valid until close().
+	std::string_view lookup(uint64_t chordHash, std::string_view application = {}) const;
+
+private:
+	std::string_view find(uint64_t key) const;
+
+	const void *mapping = nullptr;
+	size_t mappedSize = 0;
+#ifdef _WIN32
+	void *mappingHandle = nullptr;
+#endif
+	const ActionDictionaryHeader *header = nullptr;
+	const uint32_t *seeds = nullptr;
+	const ActionDictionarySlot *slotTable = nullptr;
+	const char *labels = nullptr;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_ACTIONS_HPP
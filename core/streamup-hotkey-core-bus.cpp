@@ -0,0 +1,34 @@
+#include "streamup-hotkey-core-bus.hpp"
+
+bool ChordEventBus::subscribe(Sink sink, void *userData)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (sinkCount >= MAX_SINKS) {
+		return false;
+	}
+	sinks[sinkCount++] = {sink, userData};
+	return true;
+}
+
+void ChordEventBus::unsubscribe(Sink sink, void *userData)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < sinkCount; i++) {
+		if (sinks[i].sink == sink && sinks[i].userData == userData) {
+			// Keep registration order for the remaining sinks
+			for (size_t j = i + 1; j < sinkCount; j++) {
+				sinks[j - 1] = sinks[j];
+			}
+			sinkCount--;
+			return;
+		}
+	}
+}
+
+void ChordEventBus::publish(const ChordEvent &chord)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < sinkCount; i++) {
+		sinks[i].sink(chord, sinks[i].userData);
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_BUS_HPP
+#define STREAMUP_HOTKEY_CORE_BUS_HPP
+
+#include <array>
+#include <mutex>
+#include "streamup-hotkey-core-chord.hpp"
+
+// Fans shown chords out to every registered sink (display, websocket, history, ...). Sinks run
+// in registration order on the publishing thread, which is the dispatcher thread. A sink must
+// not subscribe or unsubscribe from inside its callback.
+class ChordEventBus {
+public:
+	using Sink = void (*)(const ChordEvent &chord, void *userData);
+	static constexpr size_t MAX_SINKS = 16;
+
+	// Returns false if the sink table is full
+	bool subscribe(Sink sink, void *userData);
+	void unsubscribe(Sink sink, void *userData);
+
+	void publish(const ChordEvent &chord);
+
+private:
+	struct Entry {
+		Sink sink = nullptr;
+		void *userData = nullptr;
+	};
+
+	std::mutex mutex;
+	std::array<Entry, MAX_SINKS> sinks;
+	size_t sinkCount = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_BUS_HPP
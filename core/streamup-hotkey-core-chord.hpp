@@ -0,0 +1,251 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_CHORD_HPP
+#define STREAMUP_HOTKEY_CORE_CHORD_HPP
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "streamup-hotkey-core-format.hpp"
+
+// Everything in this header is used on the capture path (keyboard/mouse hooks). None of it
+// allocates after construction: strings are inline, containers are fixed-size.
+
+constexpr size_t COMBINATION_BUFFER_SIZE = 256;
+constexpr size_t MAX_COMBINATION_KEYS = 16;
+constexpr size_t ACTION_LABEL_SIZE = 128;
+constexpr size_t MAX_GESTURE_POINTS = 16;
+constexpr int KEY_STATE_SIZE = 256; // Covers Windows virtual keys, macOS key codes and X keycodes
+
+// Fixed-capacity, always NUL-terminated string. Appends past the capacity are truncated.
+template<size_t Capacity> class InlineString {
+public:
+	InlineString() { buffer[0] = '\0'; }
+
+	void clear()
+	{
+		length = 0;
+		buffer[0] = '\0';
+	}
+
+	void append(std::string_view text) { length = appendKeyText(buffer, Capacity, length, text); }
+	void assign(std::string_view text)
+	{
+		clear();
+		append(text);
+	}
+
+	// For APIs that format directly into the buffer (e.g. formatKeyCombination)
+	char *writableData() { return buffer; }
+	void setLength(size_t newLength) { length = newLength < Capacity ? newLength : Capacity - 1; }
+
+	const char *c_str() const { return buffer; }
+	size_t size() const { return length; }
+	bool empty() const { return length == 0; }
+	static constexpr size_t capacity() { return Capacity; }
+	std::string_view view() const { return std::string_view(buffer, length); }
+
+private:
+	char buffer[Capacity];
+	size_t length = 0;
+};
+
+using ChordText = InlineString<COMBINATION_BUFFER_SIZE>;
+using ActionText = InlineString<ACTION_LABEL_SIZE>;
+
+// Monotonic timestamp in nanoseconds used for every core event
+inline uint64_t hotkeyCoreTimeNs()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+// 64-bit FNV-1a, used as the identity of a formatted chord
+constexpr uint64_t hashChordText(std::string_view text)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : text) {
+		hash ^= (unsigned char)c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Pressed keys and modifiers as bitsets indexed by platform key code. Autorepeat is folded into
+// a per-key counter: a key that repeats is marked as held instead of being pressed again.
+class KeyState {
+public:
+	// Returns false if the key was already down, in which case the press is treated as an
+	// autorepeat and only bumps the key's repeat counter
+	bool press(int keyCode, bool modifier, uint64_t timestamp)
+	{
+		if (!inRange(keyCode)) {
+			return false;
+		}
+		if (pressed.test(keyCode)) {
+			recordRepeat(keyCode);
+			return false;
+		}
+		pressed.set(keyCode);
+		if (modifier) {
+			modifiers.set(keyCode);
+		}
+		repeatCounts[keyCode] = 0;
+		pressTimes[keyCode] = timestamp;
+		return true;
+	}
+
+	void recordRepeat(int keyCode)
+	{
+		if (!inRange(keyCode) || !pressed.test(keyCode)) {
+			return;
+		}
+		held.set(keyCode);
+		if (repeatCounts[keyCode] < UINT16_MAX) {
+			repeatCounts[keyCode]++;
+		}
+	}
+
+	void release(int keyCode)
+	{
+		if (!inRange(keyCode)) {
+			return;
+		}
+		pressed.reset(keyCode);
+		modifiers.reset(keyCode);
+		held.reset(keyCode);
+	}
+
+	void clear()
+	{
+		pressed.reset();
+		modifiers.reset();
+		held.reset();
+	}
+
+	bool isPressed(int keyCode) const { return inRange(keyCode) && pressed.test(keyCode); }
+	size_t pressedCount() const { return pressed.count(); }
+	size_t modifierCount() const { return modifiers.count(); }
+	bool anyModifierPressed() const { return modifiers.any(); }
+
+	// Held = pressed and autorepeating
+	bool isHeld(int keyCode) const { return inRange(keyCode) && held.test(keyCode); }
+	size_t heldCount() const { return held.count(); }
+	uint16_t repeatCount(int keyCode) const { return isPressed(keyCode) ? repeatCounts[keyCode] : 0; }
+	uint64_t pressTime(int keyCode) const { return isPressed(keyCode) ? pressTimes[keyCode] : 0; }
+
+	// Visits pressed keys in ascending key code order
+	template<typename Visitor> void forEachPressed(Visitor visit) const
+	{
+		for (int keyCode = 0; keyCode < KEY_STATE_SIZE; keyCode++) {
+			if (pressed.test(keyCode)) {
+				visit(keyCode);
+			}
+		}
+	}
+
+	template<typename Visitor> void forEachModifier(Visitor visit) const
+	{
+		for (int keyCode = 0; keyCode < KEY_STATE_SIZE; keyCode++) {
+			if (modifiers.test(keyCode)) {
+				visit(keyCode);
+			}
+		}
+	}
+
+private:
+	static bool inRange(int keyCode) { return keyCode >= 0 && keyCode < KEY_STATE_SIZE; }
+
+	std::bitset<KEY_STATE_SIZE> pressed;
+	std::bitset<KEY_STATE_SIZE> modifiers;
+	std::bitset<KEY_STATE_SIZE> held;
+	std::array<uint16_t, KEY_STATE_SIZE> repeatCounts{};
+	std::array<uint64_t, KEY_STATE_SIZE> pressTimes{};
+};
+
+// Remembers which chords were already shown while the current modifiers are held. Stores
+// chord hashes in a fixed array; when full the oldest entry is overwritten.
+class ChordDeduplicator {
+public:
+	// Returns true if the chord has not been seen since the last clear()
+	bool insert(uint64_t hash)
+	{
+		for (size_t i = 0; i < count; i++) {
+			if (hashes[i] == hash) {
+				return false;
+			}
+		}
+		hashes[next] = hash;
+		next = (next + 1) % hashes.size();
+		if (count < hashes.size()) {
+			count++;
+		}
+		return true;
+	}
+
+	void clear()
+	{
+		count = 0;
+		next = 0;
+	}
+
+private:
+	std::array<uint64_t, 64> hashes{};
+	size_t count = 0;
+	size_t next = 0;
+};
+
+enum class ChordKind : uint8_t {
+	Keyboard,
+	Mouse,
+	Scroll,
+	Release, // First key of a shown keyboard or gamepad chord went up; text and keys repeat the chord
+	Gamepad, // Controller buttons, stick directions and triggers (keys are gamepad key codes)
+	Gesture, // Mouse drag, "Ctrl + Drag ↘ 240px"; keys are the held modifiers and path is set
+};
+
+// Simplified pointer path of a gesture, relative to where it started
+struct GesturePoint {
+	int32_t x = 0;
+	int32_t y = 0;
+	uint32_t ms = 0; // Since the gesture started
+};
+
+struct GesturePath {
+	size_t count = 0;
+	GesturePoint points[MAX_GESTURE_POINTS];
+};
+
+// A formatted chord as it leaves the capture path
+struct ChordEvent {
+	ChordKind kind = ChordKind::Keyboard;
+	uint64_t timestamp = 0; // hotkeyCoreTimeNs() at capture
+	uint64_t hash = 0;
+	size_t keyCount = 0;
+	int keys[MAX_COMBINATION_KEYS];
+	ChordText text;
+	ActionText action;        // What the chord does (sequence or action dictionary), usually empty
+	uint32_t repeatCount = 1; // Merged repeats; above 1 the text ends in " ×N"
+	// A newer count of the last shown (non-release) chord, which it replaces rather than follows.
+	// Sinks that keep a record overwrite their newest entry instead of appending.
+	bool replacesPrevious = false;
+	GesturePath path;         // ChordKind::Gesture only
+};
+
+// Text shown for a chord: "Ctrl + Shift + P (Command Palette)", or just the chord without an action
+inline void formatChordDisplay(const ChordEvent &chord, ChordText &out)
+{
+	out.assign(chord.text.view());
+	if (!chord.action.empty()) {
+		out.append(" (");
+		out.append(chord.action.view());
+		out.append(")");
+	}
+}
+
+#endif // STREAMUP_HOTKEY_CORE_CHORD_HPP
@@ -0,0 +1,81 @@
+#include "streamup-hotkey-core-coalesce.hpp"
+#include <cstdio>
+
+namespace {
+
+constexpr uint64_t MIN_UPDATE_INTERVAL_NS = 1000000000ull / COALESCED_UPDATES_PER_SECOND;
+
+} // namespace
+
+void ChordCoalescer::push(const ChordEvent &chord, uint64_t now)
+{
+	if (chord.kind == ChordKind::Release) {
+		// Releases are not shown, so they neither merge nor end a burst
+		output(chord);
+		return;
+	}
+
+	if (chord.kind != ChordKind::Mouse && chord.kind != ChordKind::Scroll) {
+		// A key chord ends the burst; show its final count first so the order is preserved
+		if (burstActive && shownCount != repeatCount) {
+			show(now);
+		}
+		burstActive = false;
+		output(chord);
+		return;
+	}
+
+	uint64_t window = windowNs.load(std::memory_order_relaxed);
+	if (burstActive && window > 0 && chord.hash == burst.hash && chord.timestamp - lastActionTime <= window) {
+		repeatCount++;
+		lastActionTime = chord.timestamp;
+		flush(now);
+		return;
+	}
+
+	if (burstActive && shownCount != repeatCount) {
+		show(now);
+	}
+
+	burst = chord;
+	burstActive = true;
+	repeatCount = 1;
+	shownCount = 0;
+	lastActionTime = chord.timestamp;
+
+	// The first action of a burst is always shown immediately
+	show(now);
+}
+
+uint64_t ChordCoalescer::flush(uint64_t now)
+{
+	if (!burstActive || shownCount == repeatCount) {
+		return 0;
+	}
+
+	if (now - lastShownTime < MIN_UPDATE_INTERVAL_NS) {
+		return lastShownTime + MIN_UPDATE_INTERVAL_NS;
+	}
+
+	show(now);
+	return 0;
+}
+
+void ChordCoalescer::show(uint64_t now)
+{
+	if (repeatCount <= 1) {
+		output(burst);
+	} else {
+		char countText[16];
+		snprintf(countText, sizeof(countText), " \xC3\x97%u", repeatCount);
+
+		displayChord = burst;
+		displayChord.text.append(countText);
+		displayChord.repeatCount = repeatCount;
+		displayChord.replacesPrevious = true; // The burst's first action was shown immediately
+		output(displayChord);
+	}
+
+	shownCount = repeatCount;
+	lastShownTime = now;
+}
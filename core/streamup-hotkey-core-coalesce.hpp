@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_COALESCE_HPP
+#define STREAMUP_HOTKEY_CORE_COALESCE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include "streamup-hotkey-core-chord.hpp"
+
+// Upper bound on how often a growing burst ("Ctrl + Scroll Up ×14") is re-rendered
+constexpr uint64_t COALESCED_UPDATES_PER_SECOND = 15;
+
+// Merges bursts of the same mouse action (scroll notches, repeated clicks) into one entry with a
+// repeat counter. The entry is updated in place while the burst continues, at most
+// COALESCED_UPDATES_PER_SECOND times per second; each update is output with replacesPrevious set.
+// Keyboard chords pass straight through and end the current burst. Only used from the dispatcher
+// thread, except setWindow().
+class ChordCoalescer {
+public:
+	using Output = void (*)(const ChordEvent &chord);
+
+	explicit ChordCoalescer(Output output) : output(output) {}
+
+	// Maximum gap between two actions of one burst. 0 disables merging.
+	void setWindow(uint64_t windowMs) { windowNs.store(windowMs * 1000000ull, std::memory_order_relaxed); }
+
+	void push(const ChordEvent &chord, uint64_t now);
+
+	// Shows a pending count update if the rate limit allows it. Returns the time (hotkeyCoreTimeNs)
+	// at which flush() should be called again, or 0 if nothing is pending.
+	uint64_t flush(uint64_t now);
+
+private:
+	void show(uint64_t now);
+
+	Output output;
+	std::atomic<uint64_t> windowNs{0};
+
+	bool burstActive = false;
+	ChordEvent burst;        // First action of the current burst
+	ChordEvent displayChord; // Reused for the "×N" text
+	uint32_t repeatCount = 0;
+	uint32_t shownCount = 0;
+	uint64_t lastActionTime = 0;
+	uint64_t lastShownTime = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_COALESCE_HPP
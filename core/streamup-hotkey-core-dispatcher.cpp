@@ -0,0 +1,174 @@
+#include "streamup-hotkey-core-dispatcher.hpp"
+#include <chrono>
+
+void ChordDispatcher::start(Handler eventHandler, FlushHandler eventFlushHandler)
+{
+	if (running) {
+		return;
+	}
+
+	handler = eventHandler;
+	flushHandler = eventFlushHandler;
+	head = 0;
+	tail = 0;
+	ringLocked = false;
+	{
+		// A new thread starts with default scheduling
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		latencyConfigPending = latencyConfig.enabled;
+	}
+	running = true;
+	thread = std::thread(&ChordDispatcher::run, this);
+}
+
+uint64_t ChordDispatcher::stop()
+{
+	if (!running) {
+		return 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		running = false;
+	}
+	wakeCondition.notify_one();
+	passCondition.notify_all();
+
+	if (thread.joinable()) {
+		thread.join();
+	}
+	if (ringLocked) {
+		unlockMemoryRange(ring.data(), sizeof(ring));
+		ringLocked = false;
+	}
+	appliedLevel = (uint8_t)ThreadPriorityLevel::Normal;
+	appliedPinned = false;
+
+	return dropped.exchange(0);
+}
+
+bool ChordDispatcher::publish(const ChordEvent &event)
+{
+	if (!running) {
+		return false;
+	}
+
+	size_t currentHead = head.load(std::memory_order_relaxed);
+	if (currentHead - tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	ring[currentHead % RING_CAPACITY] = event;
+	head.store(currentHead + 1, std::memory_order_release);
+
+	// Taking the mutex before notifying avoids a lost wakeup against the consumer's wait
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+	}
+	wakeCondition.notify_one();
+	return true;
+}
+
+void ChordDispatcher::setLowLatency(const LowLatencyConfig &config)
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		latencyConfig = config;
+		latencyConfigPending = true;
+	}
+	wakeCondition.notify_one();
+}
+
+void ChordDispatcher::quiesce()
+{
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	if (!running) {
+		return;
+	}
+
+	// The thread is either waiting or in the middle of a pass; either way the pass it completes
+	// next starts or ends after this call, and nothing it handles later can predate it
+	uint64_t target = completedPasses + 1;
+	quiescePending = true;
+	wakeCondition.notify_one();
+	passCondition.wait(lock, [this, target] { return !running || completedPasses >= target; });
+}
+
+ThreadLatencyResult ChordDispatcher::appliedLatency() const
+{
+	ThreadLatencyResult result;
+	result.level = (ThreadPriorityLevel)appliedLevel.load(std::memory_order_relaxed);
+	result.pinned = appliedPinned.load(std::memory_order_relaxed);
+	return result;
+}
+
+void ChordDispatcher::run()
+{
+	uint64_t deadline = 0;
+
+	while (true) {
+		bool applyLatency = false;
+		LowLatencyConfig config;
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			completedPasses++;
+			passCondition.notify_all();
+
+			auto ready = [this] {
+				return !running || latencyConfigPending || quiescePending ||
+				       tail.load(std::memory_order_relaxed) != head.load(std::memory_order_acquire);
+			};
+			if (deadline == 0) {
+				wakeCondition.wait(lock, ready);
+			} else {
+				uint64_t now = hotkeyCoreTimeNs();
+				if (deadline > now) {
+					wakeCondition.wait_for(lock, std::chrono::nanoseconds(deadline - now), ready);
+				}
+			}
+			if (!running) {
+				break;
+			}
+			applyLatency = latencyConfigPending;
+			latencyConfigPending = false;
+			quiescePending = false;
+			config = latencyConfig;
+		}
+
+		if (applyLatency) {
+			ThreadLatencyResult result = applyThreadLatencyMode(config);
+			appliedLevel = (uint8_t)result.level;
+			appliedPinned = result.pinned;
+			if (config.enabled && !ringLocked) {
+				ringLocked = lockMemoryRange(ring.data(), sizeof(ring));
+			} else if (!config.enabled && ringLocked) {
+				unlockMemoryRange(ring.data(), sizeof(ring));
+				ringLocked = false;
+			}
+		}
+
+		// One clock read per batch
+		uint64_t handleTime = hotkeyCoreTimeNs();
+		size_t currentTail = tail.load(std::memory_order_relaxed);
+		while (currentTail != head.load(std::memory_order_acquire)) {
+			const ChordEvent &event = ring[currentTail % RING_CAPACITY];
+			if (handleTime > event.timestamp) {
+				dispatchDelay.record(handleTime - event.timestamp);
+			}
+			if (handler) {
+				handler(event);
+			}
+			currentTail++;
+			tail.store(currentTail, std::memory_order_release);
+		}
+
+		deadline = flushHandler ? flushHandler(hotkeyCoreTimeNs()) : 0;
+	}
+}
+
+ChordDispatcher &chordDispatcher()
+{
+	static ChordDispatcher dispatcher;
+	return dispatcher;
+}
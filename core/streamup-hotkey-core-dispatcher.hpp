@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_DISPATCHER_HPP
+#define STREAMUP_HOTKEY_CORE_DISPATCHER_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-latency.hpp"
+
+// Hands chord events from the capture thread to a dispatcher thread that does the allocating
+// work (UI updates, websocket, OBS sources). The ring is single-producer/single-consumer: every
+// platform delivers keyboard and mouse events on one thread.
+class ChordDispatcher {
+public:
+	using Handler = void (*)(const ChordEvent &event);
+	// Called after each batch and when a deadline passes. Returns the next deadline
+	// (hotkeyCoreTimeNs) or 0 to sleep until the next event.
+	using FlushHandler = uint64_t (*)(uint64_t now);
+
+	void start(Handler eventHandler, FlushHandler eventFlushHandler = nullptr);
+	// Returns the number of events dropped since start() because the ring was full
+	uint64_t stop();
+
+	// Capture side. Never blocks on the consumer and never allocates; returns false (and
+	// counts a drop) when the ring is full.
+	bool publish(const ChordEvent &event);
+
+	uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+	// Blocks until the dispatcher thread has finished whatever it was handling when called, so
+	// data its handlers may still reference can be freed. Returns at once when not running.
+	// Must not be called from a handler.
+	void quiesce();
+
+	// Applied by the dispatcher thread itself at its next wakeup, together with locking the ring
+	// into memory. appliedLatency() reports what the thread actually got.
+	void setLowLatency(const LowLatencyConfig &config);
+	ThreadLatencyResult appliedLatency() const;
+
+	// Time from capture (ChordEvent::timestamp) to the dispatcher handling the event
+	LatencyHistogram::Summary takeDispatchDelay() { return dispatchDelay.takeSummary(); }
+
+private:
+	static constexpr size_t RING_CAPACITY = 128; // Power of two
+
+	void run();
+
+	std::array<ChordEvent, RING_CAPACITY> ring;
+	std::atomic<size_t> head{0}; // Next slot to write (producer)
+	std::atomic<size_t> tail{0}; // Next slot to read (consumer)
+	std::atomic<uint64_t> dropped{0};
+
+	Handler handler = nullptr;
+	FlushHandler flushHandler = nullptr;
+	std::thread thread;
+	std::atomic<bool> running{false};
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable passCondition; // Signalled when completedPasses advances
+
+	// Protected by wakeMutex
+	LowLatencyConfig latencyConfig;
+	bool latencyConfigPending = false;
+	bool quiescePending = false;
+	uint64_t completedPasses = 0;
+
+	std::atomic<uint8_t> appliedLevel{0}; // ThreadPriorityLevel
+	std::atomic<bool> appliedPinned{false};
+	bool ringLocked = false; // Dispatcher thread only
+	LatencyHistogram dispatchDelay;
+};
+
+ChordDispatcher &chordDispatcher();
+
+#endif // STREAMUP_HOTKEY_CORE_DISPATCHER_HPP
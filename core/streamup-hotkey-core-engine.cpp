@@ -0,0 +1,183 @@
+#include "streamup-hotkey-core-engine.hpp"
+
+HotkeyEngine::HotkeyEngine(KeyClassifier classify, KeyNameFunction keyName, ChordDispatcher &dispatcher)
+	: classify(classify),
+	  keyName(keyName),
+	  dispatcher(dispatcher)
+{
+}
+
+void HotkeyEngine::setFilterSettings(const HotkeyFilterSettings &settings)
+{
+	std::lock_guard<std::mutex> lock(stateMutex);
+	filter.setSettings(settings);
+}
+
+void HotkeyEngine::setProfileSwitcher(const CaptureProfileSwitcher *switcher)
+{
+	std::lock_guard<std::mutex> lock(stateMutex);
+	profileSwitcher = switcher;
+}
+
+bool HotkeyEngine::keyEvent(int keyCode, bool keyDown, bool autoRepeat, uint64_t timestamp)
+{
+	ChordEvent chord;
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		if (!keyDown) {
+			keyState.release(keyCode);
+
+			// Combinations may be shown again once every modifier has been released
+			if (!keyState.anyModifierPressed()) {
+				shownCombinations.clear();
+			}
+
+			if (!chordActive || !chordContains(activeChord, keyCode)) {
+				return false;
+			}
+			chordActive = false;
+			chord = activeChord;
+			chord.kind = ChordKind::Release;
+			chord.timestamp = timestamp;
+		} else {
+			if (autoRepeat) {
+				keyState.recordRepeat(keyCode);
+				return false;
+			}
+
+			KeyInfo key = classify(keyCode);
+			if (!keyState.press(keyCode, (key.classes & KEY_CLASS_MODIFIER) != 0, timestamp)) {
+				return false;
+			}
+
+			// One acquire load; the profile itself was compiled when the window changed
+			const CaptureProfile *profile = profileSwitcher ? profileSwitcher->active() : nullptr;
+			const HotkeyFilterSettings &settings = profile ? profile->filter : filter.getSettings();
+			if (!filter.completesCombination(keyState, classify) &&
+			    !(HotkeyFilter::capturesSingleKey(key, settings) && !shiftModifierActive())) {
+				return true;
+			}
+
+			chord.kind = ChordKind::Keyboard;
+			chord.timestamp = timestamp;
+			buildChord(chord);
+			chord.hash = hashChordText(chord.text.view());
+			if (!shownCombinations.insert(chord.hash)) {
+				return true;
+			}
+			chordActive = true;
+			activeChord = chord;
+		}
+	}
+
+	dispatcher.publish(chord);
+	return keyDown;
+}
+
+void HotkeyEngine::mouseAction(std::string_view action, uint64_t timestamp, bool scroll)
+{
+	ChordEvent chord;
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		if (!keyState.anyModifierPressed()) {
+			return;
+		}
+		chord.kind = scroll ? ChordKind::Scroll : ChordKind::Mouse;
+		chord.timestamp = timestamp;
+		buildChord(chord);
+	}
+
+	chord.text.append(action);
+	chord.hash = hashChordText(chord.text.view());
+	dispatcher.publish(chord);
+}
+
+void HotkeyEngine::mouseGesture(const MotionGesture &gesture, uint64_t timestamp)
+{
+	ChordEvent chord;
+	chord.kind = ChordKind::Gesture;
+	chord.timestamp = timestamp;
+	{
+		std::lock_guard<std::mutex> lock(stateMutex);
+		if (keyState.pressedCount() > 0) {
+			buildChord(chord);
+		}
+	}
+
+	if (!chord.text.empty()) {
+		chord.text.append(" + ");
+	}
+	formatGestureAction(gesture, chord.text);
+	chord.hash = hashChordText(chord.text.view());
+	chord.path = gesture.path;
+	dispatcher.publish(chord);
+}
+
+bool HotkeyEngine::anyModifierPressed() const
+{
+	std::lock_guard<std::mutex> lock(stateMutex);
+	return keyState.anyModifierPressed();
+}
+
+bool HotkeyEngine::isKeyHeld(int keyCode) const
+{
+	std::lock_guard<std::mutex> lock(stateMutex);
+	return keyState.isHeld(keyCode);
+}
+
+void HotkeyEngine::reset()
+{
+	std::lock_guard<std::mutex> lock(stateMutex);
+	keyState.clear();
+	shownCombinations.clear();
+	chordActive = false;
+}
+
+void HotkeyEngine::quiesce() const
+{
+	// Profiles are only read under the lock
+	std::lock_guard<std::mutex> lock(stateMutex);
+}
+
+void HotkeyEngine::buildChord(ChordEvent &chord) const
+{
+	chord.keyCount = 0;
+
+	// Add modifier keys in order: Ctrl, Super, Alt, Shift
+	for (int rank = 0; rank < MODIFIER_RANK_COUNT; rank++) {
+		keyState.forEachModifier([this, &chord, rank](int key) {
+			if (chord.keyCount < MAX_COMBINATION_KEYS && classify(key).modifierRank == rank) {
+				chord.keys[chord.keyCount++] = key;
+			}
+		});
+	}
+
+	// Add non-modifier keys
+	keyState.forEachPressed([this, &chord](int key) {
+		if (chord.keyCount < MAX_COMBINATION_KEYS && !(classify(key).classes & KEY_CLASS_MODIFIER)) {
+			chord.keys[chord.keyCount++] = key;
+		}
+	});
+
+	chord.text.setLength(formatKeyCombination(chord.keys, chord.keyCount, keyName, chord.text.writableData(),
+						  chord.text.capacity()));
+}
+
+bool HotkeyEngine::chordContains(const ChordEvent &chord, int keyCode)
+{
+	for (size_t i = 0; i < chord.keyCount; i++) {
+		if (chord.keys[i] == keyCode) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HotkeyEngine::shiftModifierActive() const
+{
+	bool shiftActive = false;
+	keyState.forEachModifier([this, &shiftActive](int key) {
+		shiftActive = shiftActive || (classify(key).classes & KEY_CLASS_SHIFT) != 0;
+	});
+	return shiftActive;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_ENGINE_HPP
+#define STREAMUP_HOTKEY_CORE_ENGINE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-dispatcher.hpp"
+#include "streamup-hotkey-core-filter.hpp"
+#include "streamup-hotkey-core-format.hpp"
+#include "streamup-hotkey-core-motion.hpp"
+#include "streamup-hotkey-core-profile.hpp"
+
+// Key-state engine. The platform hooks feed raw key and mouse events in; the engine tracks the
+// pressed keys, decides through the filter when a press completes a chord, formats it and
+// publishes it to the dispatcher. Safe to call from any thread and never allocates.
+class HotkeyEngine {
+public:
+	HotkeyEngine(KeyClassifier classify, KeyNameFunction keyName, ChordDispatcher &dispatcher);
+
+	void setFilterSettings(const HotkeyFilterSettings &settings);
+
+	// While the switcher has an active profile, its filter replaces the one set above. The
+	// switcher must outlive the engine or be detached with nullptr first.
+	void setProfileSwitcher(const CaptureProfileSwitcher *switcher);
+
+	// Returns true for a new key press. Autorepeats (reported by the backend, or a press of a key
+	// that is already down) only bump the key's repeat counter and are not published again.
+	// Releasing the first key of a published chord publishes a ChordKind::Release for it.
+	bool keyEvent(int keyCode, bool keyDown, bool autoRepeat, uint64_t timestamp);
+
+	// Publishes "<modifiers> + <action>" if a modifier is held
+	void mouseAction(std::string_view action, uint64_t timestamp, bool scroll = false);
+
+	// Publishes "<modifiers> + Drag ↘ 240px" with the gesture's path; modifiers are optional
+	void mouseGesture(const MotionGesture &gesture, uint64_t timestamp);
+
+	bool anyModifierPressed() const;
+	bool isKeyHeld(int keyCode) const;
+
+	// Forgets every pressed key and shown combination; called once the hooks are stopped
+	void reset();
+
+	// Returns once every event that was being handled when it was called is done, so no hook
+	// thread still holds a profile it loaded before
+	void quiesce() const;
+
+private:
+	// Fills the chord's keys (modifiers first, by rank) and text. Caller holds stateMutex.
+	void buildChord(ChordEvent &chord) const;
+	bool shiftModifierActive() const;
+	static bool chordContains(const ChordEvent &chord, int keyCode);
+
+	KeyClassifier classify;
+	KeyNameFunction keyName;
+	ChordDispatcher &dispatcher;
+
+	mutable std::mutex stateMutex; // Protects everything below
+	KeyState keyState;
+	ChordDeduplicator shownCombinations;
+	HotkeyFilter filter;
+	const CaptureProfileSwitcher *profileSwitcher = nullptr;
+
+	// Last published keyboard chord, until one of its keys is released
+	bool chordActive = false;
+	ChordEvent activeChord;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_ENGINE_HPP
@@ -0,0 +1,394 @@
+#include "streamup-hotkey-core-evdev.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+enum class AxisRole : uint8_t {
+	Unused,
+	Axis, // Normalised and passed to the tracker
+	HatX, // D-pad reported as an axis
+	HatY,
+};
+
+struct AxisMapping {
+	AxisRole role = AxisRole::Unused;
+	GamepadAxis axis = GamepadAxis::Count;
+	int32_t minimum = 0;
+	int32_t maximum = 0;
+};
+
+template<size_t N> bool testBit(const unsigned long (&bits)[N], unsigned bit)
+{
+	constexpr unsigned BITS_PER_LONG = sizeof(unsigned long) * 8;
+	return bit / BITS_PER_LONG < N && (bits[bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1ul;
+}
+
+bool isEventNode(const char *name)
+{
+	return std::strncmp(name, "event", 5) == 0;
+}
+
+} // namespace
+
+int evdevButtonControl(uint16_t code)
+{
+	switch (code) {
+	case BTN_SOUTH:
+		return GAMEPAD_A;
+	case BTN_EAST:
+		return GAMEPAD_B;
+	// The kernel's BTN_X / BTN_Y are BTN_NORTH / BTN_WEST; Xbox-style drivers put X on BTN_NORTH
+	case BTN_NORTH:
+		return GAMEPAD_X;
+	case BTN_WEST:
+		return GAMEPAD_Y;
+	case BTN_TL:
+		return GAMEPAD_LB;
+	case BTN_TR:
+		return GAMEPAD_RB;
+	case BTN_TL2:
+		return GAMEPAD_LT;
+	case BTN_TR2:
+		return GAMEPAD_RT;
+	case BTN_SELECT:
+		return GAMEPAD_BACK;
+	case BTN_START:
+		return GAMEPAD_START;
+	case BTN_MODE:
+		return GAMEPAD_GUIDE;
+	case BTN_THUMBL:
+		return GAMEPAD_L3;
+	case BTN_THUMBR:
+		return GAMEPAD_R3;
+	case BTN_DPAD_UP:
+		return GAMEPAD_DPAD_UP;
+	case BTN_DPAD_DOWN:
+		return GAMEPAD_DPAD_DOWN;
+	case BTN_DPAD_LEFT:
+		return GAMEPAD_DPAD_LEFT;
+	case BTN_DPAD_RIGHT:
+		return GAMEPAD_DPAD_RIGHT;
+	case BTN_C:
+		return GAMEPAD_EXTRA_BUTTON_FIRST + GAMEPAD_EXTRA_BUTTON_COUNT - 2;
+	case BTN_Z:
+		return GAMEPAD_EXTRA_BUTTON_FIRST + GAMEPAD_EXTRA_BUTTON_COUNT - 1;
+	default:
+		break;
+	}
+
+	// Joysticks number their buttons: BTN_TRIGGER ... BTN_BASE6, then BTN_TRIGGER_HAPPY1 ...
+	constexpr int JOYSTICK_BUTTONS = BTN_BASE6 - BTN_TRIGGER + 1;
+	if (code >= BTN_TRIGGER && code <= BTN_BASE6) {
+		return GAMEPAD_EXTRA_BUTTON_FIRST + (code - BTN_TRIGGER);
+	}
+	if (code >= BTN_TRIGGER_HAPPY1 && code - BTN_TRIGGER_HAPPY1 < GAMEPAD_EXTRA_BUTTON_COUNT - 2 - JOYSTICK_BUTTONS) {
+		return GAMEPAD_EXTRA_BUTTON_FIRST + JOYSTICK_BUTTONS + (code - BTN_TRIGGER_HAPPY1);
+	}
+	return -1;
+}
+
+struct GamepadDeviceMonitor::Device {
+	explicit Device(ChordDispatcher &dispatcher) : tracker(dispatcher) {}
+
+	int fd = -1;
+	GamepadDeviceInfo info;
+	GamepadTracker tracker;
+	AxisMapping axes[ABS_CNT];
+	// After SYN_DROPPED everything up to the next SYN_REPORT is stale
+	bool dropping = false;
+};
+
+GamepadDeviceMonitor::GamepadDeviceMonitor(ChordDispatcher &dispatcher) : dispatcher(dispatcher) {}
+
+GamepadDeviceMonitor::~GamepadDeviceMonitor()
+{
+	stop();
+}
+
+bool GamepadDeviceMonitor::start(const std::string &watchDirectory, GamepadDeviceCallback deviceCallback, void *param)
+{
+	stop();
+	directory = watchDirectory;
+	callback = deviceCallback;
+	callbackParam = param;
+
+	watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watchFd < 0) {
+		return false;
+	}
+	// IN_ATTRIB: udev often creates the node first and grants access to it a moment later
+	if (inotify_add_watch(watchFd, directory.c_str(), IN_CREATE | IN_ATTRIB | IN_DELETE) < 0) {
+		close(watchFd);
+		watchFd = -1;
+		return false;
+	}
+
+	scan();
+	return true;
+}
+
+void GamepadDeviceMonitor::stop()
+{
+	while (!devices.empty()) {
+		closeDevice(devices.size() - 1);
+	}
+	if (watchFd >= 0) {
+		close(watchFd);
+		watchFd = -1;
+	}
+	inaccessibleNodes = 0;
+}
+
+void GamepadDeviceMonitor::setAxisSettings(const GamepadAxisSettings &settings)
+{
+	axisSettings = settings;
+	for (auto &device : devices) {
+		device->tracker.setAxisSettings(settings);
+	}
+}
+
+void GamepadDeviceMonitor::appendPollFds(std::vector<pollfd> &fds) const
+{
+	if (watchFd < 0) {
+		return;
+	}
+	fds.push_back({watchFd, POLLIN, 0});
+	for (const auto &device : devices) {
+		fds.push_back({device->fd, POLLIN, 0});
+	}
+}
+
+void GamepadDeviceMonitor::handleReadable(const pollfd *fds, size_t count)
+{
+	if (watchFd < 0 || count == 0) {
+		return;
+	}
+
+	// Devices first: the watch may add or remove entries and shift the indices
+	std::vector<int> gone;
+	for (size_t i = 1; i < count; i++) {
+		if (fds[i].revents == 0) {
+			continue;
+		}
+		auto it = std::find_if(devices.begin(), devices.end(), [&](const auto &d) { return d->fd == fds[i].fd; });
+		if (it != devices.end() && (!readDevice(**it) || (fds[i].revents & (POLLHUP | POLLERR | POLLNVAL)))) {
+			gone.push_back(fds[i].fd);
+		}
+	}
+	for (int fd : gone) {
+		auto it = std::find_if(devices.begin(), devices.end(), [&](const auto &d) { return d->fd == fd; });
+		if (it != devices.end()) {
+			closeDevice((size_t)(it - devices.begin()));
+		}
+	}
+
+	if (fds[0].revents & POLLIN) {
+		handleWatchEvents();
+	}
+}
+
+uint64_t GamepadDeviceMonitor::axisReports() const
+{
+	uint64_t total = closedAxisReports;
+	for (const auto &device : devices) {
+		total += device->tracker.axisReports();
+	}
+	return total;
+}
+
+uint64_t GamepadDeviceMonitor::axisReportsAccepted() const
+{
+	uint64_t total = closedAxisAccepted;
+	for (const auto &device : devices) {
+		total += device->tracker.axisReportsAccepted();
+	}
+	return total;
+}
+
+void GamepadDeviceMonitor::scan()
+{
+	DIR *dir = opendir(directory.c_str());
+	if (!dir) {
+		return;
+	}
+	while (dirent *entry = readdir(dir)) {
+		if (isEventNode(entry->d_name)) {
+			openDevice(directory + "/" + entry->d_name);
+		}
+	}
+	closedir(dir);
+}
+
+void GamepadDeviceMonitor::openDevice(const std::string &path)
+{
+	for (const auto &device : devices) {
+		if (device->info.path == path) {
+			return;
+		}
+	}
+
+	int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) {
+		if (errno == EACCES || errno == EPERM) {
+			inaccessibleNodes++;
+		}
+		return;
+	}
+
+	unsigned long keyBits[KEY_CNT / (sizeof(unsigned long) * 8) + 1] = {};
+	unsigned long absBits[ABS_CNT / (sizeof(unsigned long) * 8) + 1] = {};
+	ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits);
+	ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits);
+
+	// Keyboards, mice, touchpads and tablets also report EV_KEY and EV_ABS; only these buttons
+	// identify a controller
+	bool isController = testBit(keyBits, BTN_SOUTH) || testBit(keyBits, BTN_TRIGGER) ||
+			    testBit(keyBits, BTN_TRIGGER_HAPPY1);
+	if (!isController) {
+		close(fd);
+		return;
+	}
+
+	auto device = std::make_unique<Device>(dispatcher);
+	device->fd = fd;
+	device->info.path = path;
+	char name[256] = {};
+	if (ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) > 0) {
+		device->info.name = name;
+	}
+
+	// Older pads without ABS_RX report the right stick on ABS_Z / ABS_RZ instead of the triggers
+	bool zIsRightStick = !testBit(absBits, ABS_RX) && testBit(absBits, ABS_Z) && testBit(absBits, ABS_RZ);
+	auto mapAxis = [&](unsigned code, AxisRole role, GamepadAxis axis) {
+		input_absinfo absInfo = {};
+		if (!testBit(absBits, code) || ioctl(fd, EVIOCGABS(code), &absInfo) < 0 ||
+		    absInfo.maximum <= absInfo.minimum) {
+			return;
+		}
+		device->axes[code] = {role, axis, absInfo.minimum, absInfo.maximum};
+	};
+	mapAxis(ABS_X, AxisRole::Axis, GamepadAxis::LeftX);
+	mapAxis(ABS_Y, AxisRole::Axis, GamepadAxis::LeftY);
+	mapAxis(ABS_RX, AxisRole::Axis, GamepadAxis::RightX);
+	mapAxis(ABS_RY, AxisRole::Axis, GamepadAxis::RightY);
+	mapAxis(ABS_Z, AxisRole::Axis, zIsRightStick ? GamepadAxis::RightX : GamepadAxis::LeftTrigger);
+	mapAxis(ABS_RZ, AxisRole::Axis, zIsRightStick ? GamepadAxis::RightY : GamepadAxis::RightTrigger);
+	mapAxis(ABS_BRAKE, AxisRole::Axis, GamepadAxis::LeftTrigger);
+	mapAxis(ABS_GAS, AxisRole::Axis, GamepadAxis::RightTrigger);
+	mapAxis(ABS_HAT0X, AxisRole::HatX, GamepadAxis::Count);
+	mapAxis(ABS_HAT0Y, AxisRole::HatY, GamepadAxis::Count);
+
+	device->tracker.setAxisSettings(axisSettings);
+	devices.push_back(std::move(device));
+	if (callback) {
+		callback(devices.back()->info, true, callbackParam);
+	}
+}
+
+void GamepadDeviceMonitor::closeDevice(size_t index)
+{
+	std::unique_ptr<Device> device = std::move(devices[index]);
+	devices.erase(devices.begin() + (ptrdiff_t)index);
+	closedAxisReports += device->tracker.axisReports();
+	closedAxisAccepted += device->tracker.axisReportsAccepted();
+	device->tracker.reset();
+	close(device->fd);
+	if (callback) {
+		callback(device->info, false, callbackParam);
+	}
+}
+
+void GamepadDeviceMonitor::handleWatchEvents()
+{
+	alignas(inotify_event) char buffer[4096];
+	for (;;) {
+		ssize_t length = read(watchFd, buffer, sizeof(buffer));
+		if (length <= 0) {
+			return;
+		}
+		for (ssize_t offset = 0; offset < length;) {
+			const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+			offset += (ssize_t)(sizeof(inotify_event) + event->len);
+			if (event->len == 0 || !isEventNode(event->name)) {
+				continue;
+			}
+
+			std::string path = directory + "/" + event->name;
+			if (event->mask & IN_DELETE) {
+				auto it = std::find_if(devices.begin(), devices.end(),
+						       [&](const auto &d) { return d->info.path == path; });
+				if (it != devices.end()) {
+					closeDevice((size_t)(it - devices.begin()));
+				}
+			} else {
+				openDevice(path);
+			}
+		}
+	}
+}
+
+bool GamepadDeviceMonitor::readDevice(Device &device)
+{
+	input_event events[64];
+	for (;;) {
+		ssize_t length = read(device.fd, events, sizeof(events));
+		if (length < 0) {
+			return errno == EAGAIN || errno == EINTR;
+		}
+		if (length == 0) {
+			return false;
+		}
+
+		// Kernel timestamps use a different clock; the chord gets the time it was read
+		uint64_t now = hotkeyCoreTimeNs();
+		size_t count = (size_t)length / sizeof(input_event);
+		for (size_t i = 0; i < count; i++) {
+			const input_event &event = events[i];
+			if (event.type == EV_SYN) {
+				if (event.code == SYN_DROPPED) {
+					device.tracker.reset();
+					device.dropping = true;
+				} else if (event.code == SYN_REPORT) {
+					if (!device.dropping) {
+						device.tracker.sync(now);
+					}
+					device.dropping = false;
+				}
+				continue;
+			}
+			if (device.dropping) {
+				continue;
+			}
+
+			if (event.type == EV_KEY && event.value != 2) { // 2 = autorepeat
+				int control = evdevButtonControl(event.code);
+				if (control >= 0) {
+					device.tracker.button(control, event.value != 0, now);
+				}
+			} else if (event.type == EV_ABS && event.code < ABS_CNT) {
+				const AxisMapping &mapping = device.axes[event.code];
+				if (mapping.role == AxisRole::Axis) {
+					float range = (float)(mapping.maximum - mapping.minimum);
+					float unit = (float)(event.value - mapping.minimum) / range;
+					bool isTrigger = mapping.axis == GamepadAxis::LeftTrigger ||
+							 mapping.axis == GamepadAxis::RightTrigger;
+					device.tracker.axis(mapping.axis, isTrigger ? unit : unit * 2.0f - 1.0f);
+				} else if (mapping.role == AxisRole::HatX) {
+					device.tracker.button(GAMEPAD_DPAD_LEFT, event.value < 0, now);
+					device.tracker.button(GAMEPAD_DPAD_RIGHT, event.value > 0, now);
+				} else if (mapping.role == AxisRole::HatY) {
+					device.tracker.button(GAMEPAD_DPAD_UP, event.value < 0, now);
+					device.tracker.button(GAMEPAD_DPAD_DOWN, event.value > 0, now);
+				}
+			}
+		}
+	}
+}
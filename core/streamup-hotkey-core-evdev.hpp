@@ -0,0 +1,79 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_EVDEV_HPP
+#define STREAMUP_HOTKEY_CORE_EVDEV_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include "streamup-hotkey-core-gamepad.hpp"
+
+// Linux evdev gamepad and joystick capture. Reads /dev/input/event* nodes directly (no libevdev)
+// and feeds one GamepadTracker per device. Devices are found by a scan at start and then by
+// inotify, so controllers plugged in later (including uinput virtual pads) are picked up without
+// polling. The monitor does no I/O on its own: the owner's poll() loop watches pollFds() and
+// calls handleReadable(), so chords are published from the same thread as keyboard events.
+
+// GamepadControl for an evdev EV_KEY code, or -1 if the code is not a controller button
+int evdevButtonControl(uint16_t code);
+
+struct GamepadDeviceInfo {
+	std::string path; // "/dev/input/event17"
+	std::string name; // "Microsoft X-Box 360 pad"
+};
+
+using GamepadDeviceCallback = void (*)(const GamepadDeviceInfo &device, bool connected, void *param);
+
+class GamepadDeviceMonitor {
+public:
+	explicit GamepadDeviceMonitor(ChordDispatcher &dispatcher);
+	~GamepadDeviceMonitor();
+	GamepadDeviceMonitor(const GamepadDeviceMonitor &) = delete;
+	GamepadDeviceMonitor &operator=(const GamepadDeviceMonitor &) = delete;
+
+	// Watches the directory (normally /dev/input) and opens every controller in it. Fails only if
+	// the directory cannot be watched; no controller being present is not an error.
+	bool start(const std::string &directory, GamepadDeviceCallback callback = nullptr, void *param = nullptr);
+	void stop();
+	bool isRunning() const { return watchFd >= 0; }
+
+	// Applies to open devices and to devices connected later
+	void setAxisSettings(const GamepadAxisSettings &settings);
+
+	// Appends one entry per descriptor the monitor needs watched for POLLIN
+	void appendPollFds(std::vector<pollfd> &fds) const;
+	// Handles the entries appended by appendPollFds() (in the same order) that became readable
+	void handleReadable(const pollfd *fds, size_t count);
+
+	size_t deviceCount() const { return devices.size(); }
+	// Event nodes that could not be opened for lack of permission (e.g. not in the "input" group)
+	size_t inaccessibleCount() const { return inaccessibleNodes; }
+	// Axis reports received and the ones that passed the change threshold, over all devices
+	uint64_t axisReports() const;
+	uint64_t axisReportsAccepted() const;
+
+private:
+	struct Device;
+
+	void scan();
+	void openDevice(const std::string &path);
+	void closeDevice(size_t index);
+	void handleWatchEvents();
+	// Returns false when the device is gone
+	bool readDevice(Device &device);
+
+	ChordDispatcher &dispatcher;
+	GamepadAxisSettings axisSettings;
+	GamepadDeviceCallback callback = nullptr;
+	void *callbackParam = nullptr;
+	std::string directory;
+	int watchFd = -1;
+	size_t inaccessibleNodes = 0;
+	uint64_t closedAxisReports = 0;
+	uint64_t closedAxisAccepted = 0;
+	std::vector<std::unique_ptr<Device>> devices;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_EVDEV_HPP
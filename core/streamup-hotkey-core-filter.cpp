@@ -0,0 +1,37 @@
+#include "streamup-hotkey-core-filter.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+
+bool HotkeyFilter::completesCombination(const KeyState &state, KeyClassifier classify) const
+{
+	if (state.pressedCount() <= 1 || !state.anyModifierPressed()) {
+		return false;
+	}
+
+	// Check if SHIFT is the only modifier
+	bool onlyShiftPressed = false;
+	if (state.modifierCount() == 1) {
+		state.forEachModifier([&onlyShiftPressed, classify](int key) {
+			onlyShiftPressed = (classify(key).classes & KEY_CLASS_SHIFT) != 0;
+		});
+	}
+
+	if (onlyShiftPressed) {
+		// Allow SHIFT + any non-modifier key (F keys, letters, numbers, etc.)
+		// Only block SHIFT by itself (no other keys pressed)
+		return state.pressedCount() > state.modifierCount();
+	}
+	return true;
+}
+
+bool HotkeyFilter::capturesSingleKey(const KeyInfo &key, const HotkeyFilterSettings &settings)
+{
+	uint8_t classes = key.classes;
+	if (classes & (KEY_CLASS_WHITELISTED | KEY_CLASS_SINGLE)) {
+		return true;
+	}
+
+	return (settings.captureNumpad && (classes & KEY_CLASS_NUMPAD)) ||
+	       (settings.captureNumbers && (classes & KEY_CLASS_NUMBER)) ||
+	       (settings.captureLetters && (classes & KEY_CLASS_LETTER)) ||
+	       (settings.capturePunctuation && (classes & KEY_CLASS_PUNCTUATION));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_FILTER_HPP
+#define STREAMUP_HOTKEY_CORE_FILTER_HPP
+
+#include <cstdint>
+
+class KeyState;
+
+// Platform-neutral key classes. The platform layer maps its key codes onto these.
+enum KeyClass : uint8_t {
+	KEY_CLASS_MODIFIER = 1 << 0,
+	KEY_CLASS_SHIFT = 1 << 1,
+	KEY_CLASS_LETTER = 1 << 2,
+	KEY_CLASS_NUMBER = 1 << 3,
+	KEY_CLASS_PUNCTUATION = 1 << 4,
+	KEY_CLASS_NUMPAD = 1 << 5,
+	KEY_CLASS_SINGLE = 1 << 6,      // Shown on its own by default (F1-F12, Insert, Delete, ...)
+	KEY_CLASS_WHITELISTED = 1 << 7, // In the user's manual whitelist
+};
+
+// Modifier ranks, in display order
+enum ModifierRank : int8_t {
+	MODIFIER_RANK_NONE = -1,
+	MODIFIER_RANK_CTRL = 0,
+	MODIFIER_RANK_SUPER = 1, // Win / Cmd / Super
+	MODIFIER_RANK_ALT = 2,
+	MODIFIER_RANK_SHIFT = 3,
+	MODIFIER_RANK_COUNT = 4,
+};
+
+struct KeyInfo {
+	uint8_t classes = 0;
+	int8_t modifierRank = MODIFIER_RANK_NONE;
+};
+
+// Classifies a platform key code. Must be cheap and must not allocate: it runs on the capture path.
+using KeyClassifier = KeyInfo (*)(int keyCode);
+
+struct HotkeyFilterSettings {
+	bool captureNumpad = false;
+	bool captureNumbers = false;
+	bool captureLetters = false;
+	bool capturePunctuation = false;
+};
+
+// Decides which key presses produce a chord
+class HotkeyFilter {
+public:
+	void setSettings(const HotkeyFilterSettings &newSettings) { settings = newSettings; }
+	const HotkeyFilterSettings &getSettings() const { return settings; }
+
+	// A modifier is held together with at least one other key. Shift alone only counts when a
+	// non-modifier key is pressed with it.
+	bool completesCombination(const KeyState &state, KeyClassifier classify) const;
+
+	// Single keys shown without modifiers (whitelist, enabled categories, default single keys)
+	bool capturesSingleKey(const KeyInfo &key) const { return capturesSingleKey(key, settings); }
+	static bool capturesSingleKey(const KeyInfo &key, const HotkeyFilterSettings &settings);
+
+private:
+	HotkeyFilterSettings settings;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_FILTER_HPP
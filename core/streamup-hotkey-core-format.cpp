@@ -0,0 +1,51 @@
+#include "streamup-hotkey-core-format.hpp"
+#include <cstring>
+
+size_t appendKeyText(char *buffer, size_t capacity, size_t length, std::string_view text)
+{
+	if (capacity == 0 || length >= capacity - 1) {
+		return length;
+	}
+
+	size_t available = capacity - 1 - length;
+	size_t count = text.size() < available ? text.size() : available;
+	memcpy(buffer + length, text.data(), count);
+	length += count;
+	buffer[length] = '\0';
+	return length;
+}
+
+size_t formatKeyCombination(const int *keys, size_t count, KeyNameFunction keyName, char *buffer, size_t capacity)
+{
+	size_t length = 0;
+	if (capacity > 0) {
+		buffer[0] = '\0';
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (i > 0) {
+			length = appendKeyText(buffer, capacity, length, " + ");
+		}
+		length = appendKeyText(buffer, capacity, length, keyName(keys[i]));
+	}
+	return length;
+}
+
+std::string normaliseChordText(std::string_view text)
+{
+	std::string normalised;
+	normalised.reserve(text.size());
+	bool pendingSpace = false;
+	for (char c : text) {
+		if (c == ' ' || c == '\t' || c == '\r') {
+			pendingSpace = !normalised.empty();
+			continue;
+		}
+		if (pendingSpace) {
+			normalised.push_back(' ');
+			pendingSpace = false;
+		}
+		normalised.push_back(c);
+	}
+	return normalised;
+}
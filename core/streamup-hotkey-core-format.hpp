@@ -0,0 +1,26 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_FORMAT_HPP
+#define STREAMUP_HOTKEY_CORE_FORMAT_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Display name of a platform key code. Provided by the platform layer; the returned view must
+// point at NUL-terminated storage that outlives the call.
+using KeyNameFunction = std::string_view (*)(int keyCode);
+
+// Appends text to a caller-provided fixed buffer, truncating when it is full. The buffer is
+// kept NUL-terminated. Returns the new length.
+size_t appendKeyText(char *buffer, size_t capacity, size_t length, std::string_view text);
+
+// Joins the names of the given keys with " + " into a caller-provided fixed buffer.
+// Returns the formatted length.
+size_t formatKeyCombination(const int *keys, size_t count, KeyNameFunction keyName, char *buffer, size_t capacity);
+
+// Trims a hand-written chord and collapses runs of whitespace, so "Ctrl  +   K" in a settings
+// field or dictionary file matches the displayed "Ctrl + K". Not for the capture path.
+std::string normaliseChordText(std::string_view text);
+
+#endif // STREAMUP_HOTKEY_CORE_FORMAT_HPP
@@ -0,0 +1,221 @@
+#include "streamup-hotkey-core-gamepad.hpp"
+#include "streamup-hotkey-core-format.hpp"
+#include <array>
+#include <cmath>
+#include <string>
+
+namespace {
+
+const char *const controlNames[GAMEPAD_EXTRA_BUTTON_FIRST] = {
+	"LB",
+	"RB",
+	"LT",
+	"RT",
+	"A",
+	"B",
+	"X",
+	"Y",
+	"Back",
+	"Start",
+	"Guide",
+	"L3",
+	"R3",
+	"D-Pad Up",
+	"D-Pad Down",
+	"D-Pad Left",
+	"D-Pad Right",
+	"L Stick Up",
+	"L Stick Up-Right",
+	"L Stick Right",
+	"L Stick Down-Right",
+	"L Stick Down",
+	"L Stick Down-Left",
+	"L Stick Left",
+	"L Stick Up-Left",
+	"R Stick Up",
+	"R Stick Up-Right",
+	"R Stick Right",
+	"R Stick Down-Right",
+	"R Stick Down",
+	"R Stick Down-Left",
+	"R Stick Left",
+	"R Stick Up-Left",
+};
+
+// A direction is kept until the stick leaves its 45 degree sector by this margin, or falls this
+// far inside the deadzone, so a stick resting on a boundary does not flicker
+constexpr float DIRECTION_HYSTERESIS_DEGREES = 7.5f;
+constexpr float DEADZONE_RELEASE_FACTOR = 0.8f;
+
+float angularDistance(float a, float b)
+{
+	float distance = std::fabs(a - b);
+	return distance > 180.0f ? 360.0f - distance : distance;
+}
+
+} // namespace
+
+std::string_view gamepadKeyName(int keyCode)
+{
+	if (!isGamepadKeyCode(keyCode)) {
+		return "Unknown";
+	}
+
+	int control = keyCode - GAMEPAD_KEY_CODE_BASE;
+	if (control < GAMEPAD_EXTRA_BUTTON_FIRST) {
+		return controlNames[control];
+	}
+
+	static const std::array<std::string, GAMEPAD_EXTRA_BUTTON_COUNT> extraNames = [] {
+		std::array<std::string, GAMEPAD_EXTRA_BUTTON_COUNT> names;
+		for (size_t i = 0; i < names.size(); i++) {
+			names[i] = "Button " + std::to_string(i + 1);
+		}
+		return names;
+	}();
+	return extraNames[(size_t)(control - GAMEPAD_EXTRA_BUTTON_FIRST)];
+}
+
+GamepadTracker::GamepadTracker(ChordDispatcher &dispatcher) : dispatcher(dispatcher) {}
+
+void GamepadTracker::button(int control, bool pressed, uint64_t timestamp)
+{
+	if (control >= 0 && control < GAMEPAD_CONTROL_COUNT) {
+		setHeld(control, pressed, timestamp);
+	}
+}
+
+void GamepadTracker::axis(GamepadAxis axis, float value)
+{
+	axisReportCount++;
+	float &current = axisValues[(size_t)axis];
+	if (std::fabs(value - current) < axisSettings.changeThreshold) {
+		return;
+	}
+	current = value;
+	axisSeen |= (uint8_t)(1u << (unsigned)axis);
+	axisDirty = true;
+	axisAcceptedCount++;
+}
+
+void GamepadTracker::sync(uint64_t timestamp)
+{
+	if (!axisDirty) {
+		return;
+	}
+	axisDirty = false;
+
+	updateStick(GAMEPAD_LEFT_STICK_FIRST, axisValues[(size_t)GamepadAxis::LeftX], axisValues[(size_t)GamepadAxis::LeftY],
+		    leftStickDirection, timestamp);
+	updateStick(GAMEPAD_RIGHT_STICK_FIRST, axisValues[(size_t)GamepadAxis::RightX],
+		    axisValues[(size_t)GamepadAxis::RightY], rightStickDirection, timestamp);
+	// Pads with digital triggers only never report these axes; their buttons must not be released here
+	if (axisSeen & (1u << (unsigned)GamepadAxis::LeftTrigger)) {
+		updateTrigger(GAMEPAD_LT, axisValues[(size_t)GamepadAxis::LeftTrigger], timestamp);
+	}
+	if (axisSeen & (1u << (unsigned)GamepadAxis::RightTrigger)) {
+		updateTrigger(GAMEPAD_RT, axisValues[(size_t)GamepadAxis::RightTrigger], timestamp);
+	}
+}
+
+void GamepadTracker::reset()
+{
+	held.reset();
+	shownCombinations.clear();
+	chordActive = false;
+	for (float &value : axisValues) {
+		value = 0.0f;
+	}
+	axisSeen = 0;
+	axisDirty = false;
+	leftStickDirection = -1;
+	rightStickDirection = -1;
+}
+
+void GamepadTracker::setHeld(int control, bool isHeld, uint64_t timestamp)
+{
+	if (held.test((size_t)control) == isHeld) {
+		return;
+	}
+	held.set((size_t)control, isHeld);
+	int keyCode = gamepadKeyCode(control);
+
+	if (!isHeld) {
+		// Combinations may be shown again once every control has been released
+		if (held.none()) {
+			shownCombinations.clear();
+		}
+
+		bool inActiveChord = false;
+		for (size_t i = 0; chordActive && i < activeChord.keyCount; i++) {
+			inActiveChord = inActiveChord || activeChord.keys[i] == keyCode;
+		}
+		if (inActiveChord) {
+			chordActive = false;
+			ChordEvent release = activeChord;
+			release.kind = ChordKind::Release;
+			release.timestamp = timestamp;
+			dispatcher.publish(release);
+		}
+		return;
+	}
+
+	ChordEvent chord;
+	chord.kind = ChordKind::Gamepad;
+	chord.timestamp = timestamp;
+	for (size_t i = 0; i < held.size() && chord.keyCount < MAX_COMBINATION_KEYS; i++) {
+		if (held.test(i)) {
+			chord.keys[chord.keyCount++] = gamepadKeyCode((int)i);
+		}
+	}
+	chord.text.setLength(formatKeyCombination(chord.keys, chord.keyCount, gamepadKeyName, chord.text.writableData(),
+						  chord.text.capacity()));
+	chord.hash = hashChordText(chord.text.view());
+	if (!shownCombinations.insert(chord.hash)) {
+		return;
+	}
+
+	chordActive = true;
+	activeChord = chord;
+	dispatcher.publish(chord);
+}
+
+void GamepadTracker::updateStick(int firstControl, float x, float y, int &direction, uint64_t timestamp)
+{
+	float magnitude = std::sqrt(x * x + y * y);
+	// Degrees clockwise from up; y grows downwards
+	float angle = std::atan2(x, -y) * 57.29578f;
+	if (angle < 0.0f) {
+		angle += 360.0f;
+	}
+
+	int next = -1;
+	if (direction >= 0 && magnitude >= axisSettings.stickDeadzone * DEADZONE_RELEASE_FACTOR &&
+	    angularDistance(angle, (float)direction * 45.0f) <= 22.5f + DIRECTION_HYSTERESIS_DEGREES) {
+		next = direction;
+	} else if (magnitude >= axisSettings.stickDeadzone) {
+		next = (int)std::floor((angle + 22.5f) / 45.0f) % 8;
+	}
+
+	if (next == direction) {
+		return;
+	}
+	if (direction >= 0) {
+		setHeld(firstControl + direction, false, timestamp);
+	}
+	direction = next;
+	if (direction >= 0) {
+		setHeld(firstControl + direction, true, timestamp);
+	}
+}
+
+void GamepadTracker::updateTrigger(int control, float value, uint64_t timestamp)
+{
+	if (held.test((size_t)control)) {
+		if (value < axisSettings.triggerRelease) {
+			setHeld(control, false, timestamp);
+		}
+	} else if (value > axisSettings.triggerPress) {
+		setHeld(control, true, timestamp);
+	}
+}
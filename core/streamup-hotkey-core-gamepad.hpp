@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_GAMEPAD_HPP
+#define STREAMUP_HOTKEY_CORE_GAMEPAD_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-dispatcher.hpp"
+
+// Gamepad controls, in display order: shoulders and triggers first, like keyboard modifiers.
+// Stick directions and the D-pad are controls too, so "LB + L Stick Up" is an ordinary chord.
+enum GamepadControl : uint16_t {
+	GAMEPAD_LB,
+	GAMEPAD_RB,
+	GAMEPAD_LT,
+	GAMEPAD_RT,
+	GAMEPAD_A,
+	GAMEPAD_B,
+	GAMEPAD_X,
+	GAMEPAD_Y,
+	GAMEPAD_BACK,
+	GAMEPAD_START,
+	GAMEPAD_GUIDE,
+	GAMEPAD_L3,
+	GAMEPAD_R3,
+	GAMEPAD_DPAD_UP,
+	GAMEPAD_DPAD_DOWN,
+	GAMEPAD_DPAD_LEFT,
+	GAMEPAD_DPAD_RIGHT,
+	GAMEPAD_LEFT_STICK_FIRST, // 8 directions clockwise from up
+	GAMEPAD_RIGHT_STICK_FIRST = GAMEPAD_LEFT_STICK_FIRST + 8,
+	GAMEPAD_EXTRA_BUTTON_FIRST = GAMEPAD_RIGHT_STICK_FIRST + 8, // "Button 1" ... for joysticks
+	GAMEPAD_EXTRA_BUTTON_COUNT = 32,
+	GAMEPAD_CONTROL_COUNT = GAMEPAD_EXTRA_BUTTON_FIRST + GAMEPAD_EXTRA_BUTTON_COUNT,
+};
+
+// Gamepad controls travel through ChordEvent::keys as key codes above every platform range
+constexpr int GAMEPAD_KEY_CODE_BASE = 0x40000000;
+
+constexpr int gamepadKeyCode(int control)
+{
+	return GAMEPAD_KEY_CODE_BASE + control;
+}
+
+constexpr bool isGamepadKeyCode(int keyCode)
+{
+	return keyCode >= GAMEPAD_KEY_CODE_BASE && keyCode < GAMEPAD_KEY_CODE_BASE + GAMEPAD_CONTROL_COUNT;
+}
+
+// "A", "LT", "D-Pad Up", "L Stick Up-Right", "Button 3"; a KeyNameFunction for gamepad key codes
+std::string_view gamepadKeyName(int keyCode);
+
+enum class GamepadAxis : uint8_t {
+	LeftX,
+	LeftY,
+	RightX,
+	RightY,
+	LeftTrigger,
+	RightTrigger,
+	Count,
+};
+
+struct GamepadAxisSettings {
+	float stickDeadzone = 0.25f;   // Radial, fraction of full deflection
+	float triggerPress = 0.5f;     // A trigger counts as pressed above this
+	float triggerRelease = 0.3f;   // ... and as released below this
+	float changeThreshold = 0.02f; // Smaller changes of an axis are dropped before any other work
+};
+
+// Turns one controller's buttons and axes into chords. Analog axes are filtered before they
+// cost anything: a report that moves an axis by less than the change threshold is dropped, and
+// sticks and triggers only produce a chord when they cross into a new direction or past the
+// trigger threshold. A 1 kHz stream of small stick movements therefore publishes nothing.
+// Combinations already shown are not shown again until every control has been released, like
+// keyboard chords while modifiers stay held. Not thread-safe: feed each tracker from one thread.
+class GamepadTracker {
+public:
+	explicit GamepadTracker(ChordDispatcher &dispatcher);
+
+	void setAxisSettings(const GamepadAxisSettings &settings) { axisSettings = settings; }
+
+	void button(int control, bool pressed, uint64_t timestamp);
+	// Sticks range -1..1 (negative = left / up), triggers 0..1. Applied on the next sync().
+	void axis(GamepadAxis axis, float value);
+	// End of one device report: derives stick directions and trigger presses from the axes
+	void sync(uint64_t timestamp);
+	// Releases everything without publishing, e.g. when the device disappears or drops events
+	void reset();
+
+	uint64_t axisReports() const { return axisReportCount; }
+	uint64_t axisReportsAccepted() const { return axisAcceptedCount; }
+
+private:
+	void setHeld(int control, bool held, uint64_t timestamp);
+	void updateStick(int firstControl, float x, float y, int &direction, uint64_t timestamp);
+	void updateTrigger(int control, float value, uint64_t timestamp);
+
+	ChordDispatcher &dispatcher;
+	GamepadAxisSettings axisSettings;
+
+	std::bitset<GAMEPAD_CONTROL_COUNT> held;
+	ChordDeduplicator shownCombinations;
+	bool chordActive = false;
+	ChordEvent activeChord;
+
+	float axisValues[(size_t)GamepadAxis::Count] = {};
+	uint8_t axisSeen = 0; // Bit per GamepadAxis that has reported a value
+	bool axisDirty = false;
+	int leftStickDirection = -1; // 0-7 clockwise from up, -1 = centred
+	int rightStickDirection = -1;
+	uint64_t axisReportCount = 0;
+	uint64_t axisAcceptedCount = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_GAMEPAD_HPP
@@ -0,0 +1,70 @@
+#include "streamup-hotkey-core-history.hpp"
+#include <cstring>
+
+ChordLog::ChordLog(size_t maxEntries, size_t textBytes)
+	: slotCapacity(maxEntries),
+	  textCapacity(textBytes < UINT32_MAX ? textBytes : UINT32_MAX),
+	  records(new Slot[slotCapacity]),
+	  text(new char[textCapacity])
+{
+}
+
+void ChordLog::record(const ChordEvent &chord)
+{
+	ChordText display;
+	formatChordDisplay(chord, display);
+	size_t length = display.size();
+	if (length == 0 || length > textCapacity || slotCapacity == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (chord.replacesPrevious && end > first) {
+		// The newest entry's text ends at the head, so taking it back leaves the rings as they were
+		// before it was recorded
+		end--;
+		textHead = records[end % slotCapacity].textOffset;
+		replacements++;
+	}
+
+	// Text is never split: if it does not fit before the end of the ring it goes to the start
+	size_t offset = textHead;
+	bool wrapped = offset + length > textCapacity;
+	if (wrapped) {
+		offset = 0;
+	}
+
+	// Entries sit in the text ring in recording order from the head onwards, so the ones in the
+	// way are always the oldest: the tail skipped by a wrap, then whatever the new text overlaps
+	while (first < end) {
+		const Slot &oldest = records[first % slotCapacity];
+		bool overwritten = end - first == slotCapacity || (wrapped && oldest.textOffset >= textHead) ||
+				   (oldest.textOffset < offset + length && oldest.textOffset + oldest.textLength > offset);
+		if (!overwritten) {
+			break;
+		}
+		first++;
+	}
+
+	memcpy(text.get() + offset, display.c_str(), length);
+	Slot &slot = records[end % slotCapacity];
+	slot.timestamp = chord.timestamp;
+	slot.textOffset = (uint32_t)offset;
+	slot.textLength = (uint16_t)length;
+	slot.kind = chord.kind;
+	end++;
+	textHead = offset + length;
+}
+
+void ChordLog::range(uint64_t &firstEntry, uint64_t &endEntry) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	firstEntry = first;
+	endEntry = end;
+}
+
+uint64_t ChordLog::revision() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return replacements;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_HISTORY_HPP
+#define STREAMUP_HOTKEY_CORE_HISTORY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include "streamup-hotkey-core-chord.hpp"
+
+struct ChordLogEntry {
+	uint64_t timestamp;
+	ChordKind kind;
+	std::string_view text; // Display text (formatChordDisplay); only valid inside ChordLog::visit()
+};
+
+// Long record of shown chords for history views. Keeps only the display text, kind and time of
+// each chord, in a slot ring and a text ring that are allocated once, up front. Entries are
+// numbered in recording order from 0; the oldest are dropped once either ring is full. A chord with
+// replacesPrevious takes over the newest entry and its number. Recording never allocates. Safe to
+// use from any thread.
+class ChordLog {
+public:
+	static constexpr size_t DEFAULT_ENTRIES = 131072;
+	static constexpr size_t DEFAULT_TEXT_BYTES = 4 * 1024 * 1024;
+
+	explicit ChordLog(size_t maxEntries = DEFAULT_ENTRIES, size_t textBytes = DEFAULT_TEXT_BYTES);
+
+	void record(const ChordEvent &chord);
+
+	// The retained entries are [first, end)
+	void range(uint64_t &first, uint64_t &end) const;
+
+	// Bumped whenever the newest entry is replaced, so readers know to look at it again
+	uint64_t revision() const;
+
+	// Calls visitor(sequence, entry) for the retained entries in [from, to), oldest first. The log
+	// stays locked meanwhile, so walk long ranges in chunks.
+	template<typename Visitor> void visit(uint64_t from, uint64_t to, Visitor &&visitor) const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		from = from > first ? from : first;
+		to = to < end ? to : end;
+		for (uint64_t sequence = from; sequence < to; sequence++) {
+			const Slot &slot = records[sequence % slotCapacity];
+			visitor(sequence, ChordLogEntry{slot.timestamp, slot.kind,
+							std::string_view(text.get() + slot.textOffset, slot.textLength)});
+		}
+	}
+
+private:
+	struct Slot {
+		uint64_t timestamp;
+		uint32_t textOffset;
+		uint16_t textLength;
+		ChordKind kind;
+	};
+
+	mutable std::mutex mutex;
+	size_t slotCapacity;
+	size_t textCapacity;
+	// Deliberately uninitialised: pages are only touched as the log fills
+	std::unique_ptr<Slot[]> records;
+	std::unique_ptr<char[]> text;
+	uint64_t first = 0;
+	uint64_t end = 0;
+	size_t textHead = 0; // Where the next entry's text goes
+	uint64_t replacements = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_HISTORY_HPP
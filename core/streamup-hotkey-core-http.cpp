@@ -0,0 +1,241 @@
+#include "streamup-hotkey-core-http.hpp"
+#include "streamup-hotkey-core-json.hpp"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int LISTEN_BACKLOG = 16;
+
+// EventSource reconnects a second after the stream ends, e.g. when the server is restarted
+constexpr char STREAM_RESPONSE[] = "HTTP/1.1 200 OK\r\n"
+				   "Content-Type: text/event-stream\r\n"
+				   "Cache-Control: no-cache\r\n"
+				   "Connection: keep-alive\r\n"
+				   "\r\n"
+				   "retry: 1000\n\n";
+
+char asciiLower(char c)
+{
+	return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+bool equalsIgnoringCase(std::string_view a, std::string_view b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++) {
+		if (asciiLower(a[i]) != asciiLower(b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string_view trim(std::string_view text)
+{
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+		text.remove_suffix(1);
+	}
+	return text;
+}
+
+// Value of a request header, empty when it is missing
+std::string_view headerValue(std::string_view request, std::string_view name)
+{
+	size_t lineStart = request.find('\n'); // Skips the request line
+	while (lineStart != std::string_view::npos) {
+		lineStart++;
+		size_t lineEnd = request.find('\n', lineStart);
+		size_t lineLength = lineEnd == std::string_view::npos ? lineEnd : lineEnd - lineStart;
+		std::string_view line = request.substr(lineStart, lineLength);
+		size_t colon = line.find(':');
+		if (colon != std::string_view::npos && equalsIgnoringCase(trim(line.substr(0, colon)), name)) {
+			return trim(line.substr(colon + 1));
+		}
+		lineStart = lineEnd;
+	}
+	return std::string_view();
+}
+
+// "latest", "latest=1" and "latest=true" all turn a flag on
+bool hasQueryFlag(std::string_view query, std::string_view name)
+{
+	while (!query.empty()) {
+		size_t separator = query.find('&');
+		std::string_view parameter = query.substr(0, separator);
+		size_t equals = parameter.find('=');
+		if (parameter.substr(0, equals) == name) {
+			std::string_view value = equals == std::string_view::npos ? std::string_view()
+										  : parameter.substr(equals + 1);
+			return value != "0" && value != "false";
+		}
+		if (separator == std::string_view::npos) {
+			break;
+		}
+		query.remove_prefix(separator + 1);
+	}
+	return false;
+}
+
+} // namespace
+
+ChordHttpServer::ChordHttpServer(KeyNameFunction keyName) : keyName(keyName) {}
+
+ChordHttpServer::~ChordHttpServer()
+{
+	stop();
+}
+
+bool ChordHttpServer::start(uint16_t port, std::string_view page)
+{
+	stop();
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	// SO_REUSEADDR lets the server come straight back while old connections sit in TIME_WAIT
+	int reuse = 1;
+	int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenFd < 0 || !EventStreamServer::setNonBlocking(listenFd) ||
+	    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+	    bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listenFd, LISTEN_BACKLOG) != 0) {
+		if (listenFd >= 0) {
+			close(listenFd);
+		}
+		return false;
+	}
+
+	pageResponse = textResponse("200 OK", "text/html; charset=utf-8", page);
+	badRequestResponse = textResponse("400 Bad Request", "text/plain", "Bad request\n");
+	forbiddenResponse = textResponse("403 Forbidden", "text/plain", "Forbidden\n");
+	methodResponse = textResponse("405 Method Not Allowed", "text/plain", "Only GET is supported\n");
+	notFoundResponse = textResponse("404 Not Found", "text/plain", "Not found\n");
+	tooLargeResponse = textResponse("431 Request Header Fields Too Large", "text/plain", "Request too large\n");
+
+	EventStreamServer::Settings settings;
+	settings.maxClients = MAX_CLIENTS;
+	settings.queueEvents = CLIENT_QUEUE_EVENTS;
+	settings.slowClientTimeoutNs = SLOW_CLIENT_TIMEOUT_NS;
+	settings.formatEvent = formatEvent;
+	settings.formatDropNotice = formatDropNotice;
+	settings.handleRequest = handleRequest;
+	settings.userData = this;
+	if (!stream.start(listenFd, settings)) {
+		return false;
+	}
+
+	listenPort = port;
+	return true;
+}
+
+void ChordHttpServer::stop()
+{
+	if (!stream.isRunning()) {
+		return;
+	}
+
+	stream.stop();
+	listenPort = 0;
+}
+
+void ChordHttpServer::publish(const ChordEvent &chord)
+{
+	stream.publish(chord);
+}
+
+void ChordHttpServer::formatEvent(std::string &out, const ChordEvent &chord, void *userData)
+{
+	out.append("event: chord\ndata: ");
+	appendChordJson(out, chord, static_cast<ChordHttpServer *>(userData)->keyName);
+	out.append("\n\n");
+}
+
+void ChordHttpServer::formatDropNotice(std::string &out, uint64_t count, uint64_t total)
+{
+	char notice[112];
+	snprintf(notice, sizeof(notice), "event: dropped\ndata: {\"count\":%llu,\"total\":%llu}\n\n", (unsigned long long)count,
+		 (unsigned long long)total);
+	out.append(notice);
+}
+
+StreamReply ChordHttpServer::handleRequest(std::string_view request, void *userData)
+{
+	const ChordHttpServer &server = *static_cast<const ChordHttpServer *>(userData);
+	StreamReply reply;
+	reply.action = StreamReply::Action::Respond;
+
+	if (request.find("\r\n\r\n") == std::string_view::npos && request.find("\n\n") == std::string_view::npos) {
+		if (request.size() > MAX_REQUEST_BYTES) {
+			reply.response = server.tooLargeResponse;
+		} else {
+			reply.action = StreamReply::Action::Wait;
+		}
+		return reply;
+	}
+
+	std::string_view line = request.substr(0, request.find_first_of("\r\n"));
+	size_t methodEnd = line.find(' ');
+	size_t targetEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+	if (targetEnd == std::string_view::npos) {
+		reply.response = server.badRequestResponse;
+		return reply;
+	}
+
+	std::string_view method = line.substr(0, methodEnd);
+	std::string_view target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+	size_t queryStart = target.find('?');
+	std::string_view path = target.substr(0, queryStart);
+	std::string_view query = queryStart == std::string_view::npos ? std::string_view() : target.substr(queryStart + 1);
+
+	// A page on another site that rebinds its name to 127.0.0.1 still sends its own name as Host
+	std::string_view host = headerValue(request, "Host");
+	if (!host.empty() && !isLoopbackHost(host)) {
+		reply.response = server.forbiddenResponse;
+	} else if (method != "GET") {
+		reply.response = server.methodResponse;
+	} else if (path == "/events") {
+		reply.action = StreamReply::Action::Stream;
+		reply.response = STREAM_RESPONSE;
+		reply.latestOnly = hasQueryFlag(query, "latest");
+	} else if (path == "/" || path == "/index.html") {
+		reply.response = server.pageResponse;
+	} else {
+		reply.response = server.notFoundResponse;
+	}
+	return reply;
+}
+
+bool ChordHttpServer::isLoopbackHost(std::string_view host)
+{
+	// Drop the port, keeping the brackets of an IPv6 literal
+	size_t portStart = host.rfind(':');
+	if (portStart != std::string_view::npos && host.find(']') < portStart) {
+		host = host.substr(0, portStart);
+	} else if (portStart != std::string_view::npos && host.front() != '[') {
+		host = host.substr(0, portStart);
+	}
+	return equalsIgnoringCase(host, "localhost") || host == "127.0.0.1" || host == "[::1]";
+}
+
+std::string ChordHttpServer::textResponse(const char *status, std::string_view contentType, std::string_view body)
+{
+	std::string response;
+	response.reserve(body.size() + 160);
+	response.append("HTTP/1.1 ").append(status);
+	response.append("\r\nContent-Type: ").append(contentType);
+	response.append("\r\nContent-Length: ").append(std::to_string(body.size()));
+	response.append("\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n");
+	response.append(body);
+	return response;
+}
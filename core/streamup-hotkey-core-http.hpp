@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_HTTP_HPP
+#define STREAMUP_HOTKEY_CORE_HTTP_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-format.hpp"
+#include "streamup-hotkey-core-stream.hpp"
+
+// Minimal HTTP server on 127.0.0.1 for browser-source overlays. It answers two requests:
+//
+//   GET /        the overlay page passed to start()
+//   GET /events  a Server-Sent Events stream with one "chord" event per chord, whose data is the
+//                JSON of appendChordJson() (streamup-hotkey-core-json.hpp)
+//
+// e.g. `curl -N http://127.0.0.1:4460/events` on the plugin's default port. Like ChordSocketServer,
+// clients are served by an EventStreamServer (streamup-hotkey-core-stream.hpp): publish() never
+// blocks, a stream more than CLIENT_QUEUE_EVENTS behind loses the oldest events it has not read and
+// then first receives an "event: dropped" with data {"count":3,"total":12}, and a client that has
+// made no progress for SLOW_CLIENT_TIMEOUT_NS is disconnected. A stream opened as /events?latest
+// only ever gets the newest event instead, so a slow client skips the events in between and never
+// falls behind. All socket I/O happens on the server's own thread.
+//
+// Only loopback connections are possible, requests whose Host header names anything but the
+// loopback address are refused (DNS rebinding), and no CORS headers are sent, so other web pages
+// cannot read the stream. POSIX only.
+class ChordHttpServer {
+public:
+	static constexpr size_t MAX_CLIENTS = 32;
+	static constexpr size_t CLIENT_QUEUE_EVENTS = 256;
+	static constexpr size_t MAX_REQUEST_BYTES = 8192;
+	static constexpr uint64_t SLOW_CLIENT_TIMEOUT_NS = 5000000000ull; // Also bounds reading a request
+
+	explicit ChordHttpServer(KeyNameFunction keyName);
+	~ChordHttpServer();
+
+	// Listens on 127.0.0.1:port and serves page (UTF-8 HTML) at "/"
+	bool start(uint16_t port, std::string_view page);
+	void stop();
+	bool isRunning() const { return stream.isRunning(); }
+	uint16_t port() const { return listenPort; }
+
+	// Formats the chord once and queues it for every event stream. Safe to call from any thread.
+	void publish(const ChordEvent &chord);
+
+	// Events lost by clients that fell behind plus events never sent to disconnected ones
+	uint64_t droppedCount() const { return stream.droppedCount(); }
+
+private:
+	static void formatEvent(std::string &out, const ChordEvent &chord, void *userData);
+	static void formatDropNotice(std::string &out, uint64_t count, uint64_t total);
+	static StreamReply handleRequest(std::string_view request, void *userData);
+
+	static bool isLoopbackHost(std::string_view host);
+	static std::string textResponse(const char *status, std::string_view contentType, std::string_view body);
+
+	KeyNameFunction keyName;
+	uint16_t listenPort = 0;
+
+	// Built once per start(); requests are answered with views of them
+	std::string pageResponse;
+	std::string badRequestResponse;
+	std::string forbiddenResponse;
+	std::string methodResponse;
+	std::string notFoundResponse;
+	std::string tooLargeResponse;
+
+	EventStreamServer stream;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_HTTP_HPP
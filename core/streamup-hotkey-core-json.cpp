@@ -0,0 +1,115 @@
+#include "streamup-hotkey-core-json.hpp"
+#include "streamup-hotkey-core-gamepad.hpp"
+#include <cstdio>
+
+namespace {
+
+const char *kindName(ChordKind kind)
+{
+	switch (kind) {
+	case ChordKind::Keyboard:
+		return "press";
+	case ChordKind::Release:
+		return "release";
+	case ChordKind::Mouse:
+		return "mouse";
+	case ChordKind::Scroll:
+		return "scroll";
+	case ChordKind::Gamepad:
+		return "gamepad";
+	case ChordKind::Gesture:
+		return "gesture";
+	}
+	return "";
+}
+
+// A release repeats the keys of the chord it ends, so gamepad releases are told apart by key code
+const char *chordDeviceName(const ChordEvent &chord)
+{
+	if (chord.kind == ChordKind::Mouse || chord.kind == ChordKind::Scroll || chord.kind == ChordKind::Gesture) {
+		return "mouse";
+	}
+	if (chord.kind == ChordKind::Gamepad || (chord.keyCount > 0 && isGamepadKeyCode(chord.keys[0]))) {
+		return "gamepad";
+	}
+	return "keyboard";
+}
+
+} // namespace
+
+void appendJsonString(std::string &out, std::string_view text)
+{
+	out += '"';
+	for (char c : text) {
+		switch (c) {
+		case '"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+			if ((unsigned char)c < 0x20) {
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)(unsigned char)c);
+				out += escaped;
+			} else {
+				out += c;
+			}
+			break;
+		}
+	}
+	out += '"';
+}
+
+void appendChordJson(std::string &out, const ChordEvent &chord, KeyNameFunction keyName)
+{
+	out.append("{\"kind\":\"").append(kindName(chord.kind)).append("\",\"device\":\"");
+	out.append(chordDeviceName(chord));
+	out.append("\",\"chord\":");
+	appendJsonString(out, chord.text.view());
+	if (!chord.action.empty()) {
+		out.append(",\"action\":");
+		appendJsonString(out, chord.action.view());
+	}
+
+	char number[48];
+	snprintf(number, sizeof(number), "%016llx", (unsigned long long)chord.hash);
+	out.append(",\"hash\":\"").append(number).append("\",\"keycodes\":[");
+	for (size_t i = 0; i < chord.keyCount; i++) {
+		snprintf(number, sizeof(number), i > 0 ? ",%d" : "%d", chord.keys[i]);
+		out.append(number);
+	}
+	out.append("],\"keys\":[");
+	for (size_t i = 0; i < chord.keyCount; i++) {
+		if (i > 0) {
+			out += ',';
+		}
+		appendJsonString(out, keyName(chord.keys[i]));
+	}
+	out.append("]");
+	if (chord.replacesPrevious) {
+		snprintf(number, sizeof(number), "%u", chord.repeatCount);
+		out.append(",\"count\":").append(number).append(",\"replaces_previous\":true");
+	}
+	if (chord.kind == ChordKind::Gesture) {
+		out.append(",\"path\":[");
+		for (size_t i = 0; i < chord.path.count; i++) {
+			const GesturePoint &point = chord.path.points[i];
+			snprintf(number, sizeof(number), i > 0 ? ",[%d,%d,%u]" : "[%d,%d,%u]", point.x, point.y, point.ms);
+			out.append(number);
+		}
+		out.append("]");
+	}
+	snprintf(number, sizeof(number), "%llu", (unsigned long long)chord.timestamp);
+	out.append(",\"timestamp_ns\":").append(number).append("}");
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_JSON_HPP
+#define STREAMUP_HOTKEY_CORE_JSON_HPP
+
+#include <string>
+#include <string_view>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-format.hpp"
+
+// Appends text as a quoted JSON string
+void appendJsonString(std::string &out, std::string_view text);
+
+// Appends one chord as a single-line JSON object, the event format shared by the local event
+// streams:
+//
+//   {"kind":"press","device":"keyboard","chord":"Ctrl + C","hash":"a1b2c3d4e5f60718",
+//    "keycodes":[37,54],"keys":["Ctrl","C"],"timestamp_ns":123456789}
+//
+// "action" follows "chord" when the chord has a label from a sequence or the action dictionary.
+// A newer count of a merged mouse burst ("Ctrl + Scroll Up ×3") adds "count":3 and
+// "replaces_previous":true after "keys"; it updates the previous non-release event.
+// Controller chords have kind "gamepad" and device "gamepad"; their releases keep kind "release".
+// Mouse drags have kind "gesture" and add "path":[[x,y,ms],...], relative to where the drag began.
+void appendChordJson(std::string &out, const ChordEvent &chord, KeyNameFunction keyName);
+
+#endif // STREAMUP_HOTKEY_CORE_JSON_HPP
@@ -0,0 +1,284 @@
+#include "streamup-hotkey-core-latency.hpp"
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+// What the calling thread ran with before the mode first changed it, restored when it is turned
+// off again. Threads the mode never touched keep whatever OBS (nice, taskset, cgroups) gave them.
+struct SavedThreadState {
+	bool priorityChanged = false;
+	bool affinityChanged = false;
+#ifdef _WIN32
+	int priority = THREAD_PRIORITY_NORMAL;
+	DWORD_PTR affinity = 0;
+#else
+	int policy = SCHED_OTHER;
+	sched_param param = {};
+#ifdef __linux__
+	int nice = 0;
+	cpu_set_t affinity;
+#endif
+#endif
+};
+
+thread_local SavedThreadState savedState;
+
+#ifdef __linux__
+// Priority inside the normal scheduler when SCHED_FIFO is refused (needs RLIMIT_NICE or CAP_SYS_NICE)
+constexpr int ELEVATED_NICE = -10;
+
+// On Linux, getpriority() and setpriority() with a thread id affect only that thread
+bool getThreadNice(int &nice)
+{
+	errno = 0;
+	nice = getpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid));
+	return errno == 0;
+}
+
+bool setThreadNice(int nice)
+{
+	return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice) == 0;
+}
+#endif
+
+void savePriority()
+{
+	if (savedState.priorityChanged) {
+		return;
+	}
+#ifdef _WIN32
+	savedState.priority = GetThreadPriority(GetCurrentThread());
+#else
+	pthread_getschedparam(pthread_self(), &savedState.policy, &savedState.param);
+#ifdef __linux__
+	getThreadNice(savedState.nice);
+#endif
+#endif
+	savedState.priorityChanged = true;
+}
+
+void restorePriority()
+{
+	if (!savedState.priorityChanged) {
+		return;
+	}
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), savedState.priority);
+#else
+	pthread_setschedparam(pthread_self(), savedState.policy, &savedState.param);
+#ifdef __linux__
+	setThreadNice(savedState.nice);
+#endif
+#endif
+	savedState.priorityChanged = false;
+}
+
+bool pinToCpu(int cpu)
+{
+#ifdef _WIN32
+	if (cpu >= (int)(sizeof(DWORD_PTR) * 8)) {
+		return false;
+	}
+	// Returns the previous mask
+	DWORD_PTR previous = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+	if (previous == 0) {
+		return false;
+	}
+	if (!savedState.affinityChanged) {
+		savedState.affinity = previous;
+		savedState.affinityChanged = true;
+	}
+	return true;
+#elif defined(__linux__)
+	if (cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	if (!savedState.affinityChanged) {
+		if (pthread_getaffinity_np(pthread_self(), sizeof(savedState.affinity), &savedState.affinity) != 0) {
+			return false;
+		}
+		savedState.affinityChanged = true;
+	}
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	// macOS has no CPU affinity; the thread stays unpinned
+	(void)cpu;
+	return false;
+#endif
+}
+
+void restoreAffinity()
+{
+	if (!savedState.affinityChanged) {
+		return;
+	}
+#ifdef _WIN32
+	SetThreadAffinityMask(GetCurrentThread(), savedState.affinity);
+#elif defined(__linux__)
+	pthread_setaffinity_np(pthread_self(), sizeof(savedState.affinity), &savedState.affinity);
+#endif
+	savedState.affinityChanged = false;
+}
+
+} // namespace
+
+ThreadLatencyResult applyThreadLatencyMode(const LowLatencyConfig &config)
+{
+	ThreadLatencyResult result;
+
+	if (!config.enabled) {
+		restorePriority();
+		restoreAffinity();
+		return result;
+	}
+
+	savePriority();
+#ifdef _WIN32
+	HANDLE thread = GetCurrentThread();
+	if (SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL)) {
+		result.level = ThreadPriorityLevel::RealTime;
+	} else if (SetThreadPriority(thread, THREAD_PRIORITY_HIGHEST)) {
+		result.level = ThreadPriorityLevel::Elevated;
+	}
+#else
+	// Just above the lowest real-time priority: ahead of every normal thread, behind the
+	// kernel's own real-time threads
+	sched_param param = {};
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+	if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+		result.level = ThreadPriorityLevel::RealTime;
+	}
+#ifdef __linux__
+	else if (setThreadNice(ELEVATED_NICE)) {
+		result.level = ThreadPriorityLevel::Elevated;
+	}
+#endif
+#endif
+
+	// Unpinned again when a previous config pinned the thread
+	if (config.cpu >= 0) {
+		result.pinned = pinToCpu(config.cpu);
+	} else {
+		restoreAffinity();
+	}
+	return result;
+}
+
+const char *threadPriorityLevelName(ThreadPriorityLevel level)
+{
+	switch (level) {
+	case ThreadPriorityLevel::RealTime:
+		return "real-time";
+	case ThreadPriorityLevel::Elevated:
+		return "elevated";
+	default:
+		return "normal";
+	}
+}
+
+bool lockMemoryRange(void *data, size_t size)
+{
+	if (!data || size == 0) {
+		return false;
+	}
+
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	size_t pageSize = info.dwPageSize;
+#else
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+
+	// Locking faults every page in
+#ifdef _WIN32
+	if (VirtualLock(data, size)) {
+		return true;
+	}
+#else
+	if (mlock(data, size) == 0) {
+		return true;
+	}
+#endif
+
+	// Without the lock, at least map the pages now. Reads only: another thread may be writing
+	const volatile char *bytes = static_cast<const volatile char *>(data);
+	for (size_t offset = 0; offset < size; offset += pageSize) {
+		(void)bytes[offset];
+	}
+	(void)bytes[size - 1];
+	return false;
+}
+
+void unlockMemoryRange(void *data, size_t size)
+{
+	if (!data || size == 0) {
+		return;
+	}
+#ifdef _WIN32
+	VirtualUnlock(data, size);
+#else
+	munlock(data, size);
+#endif
+}
+
+void LatencyHistogram::record(uint64_t delayNs)
+{
+	uint64_t delayUs = delayNs / 1000;
+	size_t bucket = 0;
+	while (bucket < BUCKET_COUNT - 1 && (1ull << bucket) <= delayUs) {
+		bucket++;
+	}
+	buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t previous = maxNs.load(std::memory_order_relaxed);
+	while (delayNs > previous && !maxNs.compare_exchange_weak(previous, delayNs, std::memory_order_relaxed)) {
+	}
+}
+
+LatencyHistogram::Summary LatencyHistogram::takeSummary()
+{
+	std::array<uint64_t, BUCKET_COUNT> counts;
+	Summary summary;
+	for (size_t i = 0; i < BUCKET_COUNT; i++) {
+		counts[i] = buckets[i].exchange(0, std::memory_order_relaxed);
+		summary.count += counts[i];
+	}
+	summary.maxUs = maxNs.exchange(0, std::memory_order_relaxed) / 1000;
+	if (summary.count == 0) {
+		return summary;
+	}
+
+	// Upper bound of the bucket holding the given rank, capped by the observed maximum
+	auto percentile = [&](uint64_t rank) {
+		uint64_t seen = 0;
+		for (size_t i = 0; i < BUCKET_COUNT; i++) {
+			seen += counts[i];
+			if (seen >= rank) {
+				uint64_t bound = 1ull << i;
+				return bound < summary.maxUs ? bound : summary.maxUs;
+			}
+		}
+		return summary.maxUs;
+	};
+	summary.p50Us = percentile((summary.count + 1) / 2);
+	summary.p99Us = percentile(summary.count - summary.count / 100);
+	return summary;
+}
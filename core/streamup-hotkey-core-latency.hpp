@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_LATENCY_HPP
+#define STREAMUP_HOTKEY_CORE_LATENCY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Opt-in low-latency mode for the capture and dispatcher threads
+struct LowLatencyConfig {
+	bool enabled = false;
+	int cpu = -1; // Pin to this CPU, -1 = any
+};
+
+enum class ThreadPriorityLevel : uint8_t {
+	Normal,   // Default scheduling (mode off, or nothing could be raised)
+	Elevated, // Higher priority within the normal scheduler (negative nice value)
+	RealTime, // SCHED_FIFO / THREAD_PRIORITY_TIME_CRITICAL
+};
+
+struct ThreadLatencyResult {
+	ThreadPriorityLevel level = ThreadPriorityLevel::Normal;
+	bool pinned = false;
+};
+
+// Applies the config to the calling thread. Real-time scheduling is tried first, then a raised
+// priority in the normal scheduler, so missing permissions (no CAP_SYS_NICE or RLIMIT_RTPRIO)
+// degrade instead of failing. The thread's scheduling and affinity from before the mode first
+// changed them are kept per thread; a disabled config restores them, and does nothing on a
+// thread the mode never changed.
+ThreadLatencyResult applyThreadLatencyMode(const LowLatencyConfig &config);
+const char *threadPriorityLevelName(ThreadPriorityLevel level);
+
+// Locks the range into RAM so the hot path never takes a page fault. Returns false if the lock
+// was refused (RLIMIT_MEMLOCK); the pages are then only touched, which maps them for now.
+bool lockMemoryRange(void *data, size_t size);
+void unlockMemoryRange(void *data, size_t size);
+
+// Lock-free histogram of delays with power-of-two microsecond buckets. record() may be called
+// from one thread while another takes summaries; percentiles are bucket upper bounds.
+class LatencyHistogram {
+public:
+	struct Summary {
+		uint64_t count = 0;
+		uint64_t p50Us = 0;
+		uint64_t p99Us = 0;
+		uint64_t maxUs = 0;
+	};
+
+	void record(uint64_t delayNs);
+	// Returns the delays recorded since the last call and starts over
+	Summary takeSummary();
+
+private:
+	static constexpr size_t BUCKET_COUNT = 32; // Bucket i holds delays below 2^i us
+
+	std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+	std::atomic<uint64_t> maxNs{0};
+};
+
+#endif // STREAMUP_HOTKEY_CORE_LATENCY_HPP
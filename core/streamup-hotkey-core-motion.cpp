@@ -0,0 +1,203 @@
+#include "streamup-hotkey-core-motion.hpp"
+#include <bitset>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Clockwise from up, y grows downwards
+const char *const directionArrows[8] = {
+	"\xE2\x86\x91", // ↑
+	"\xE2\x86\x97", // ↗
+	"\xE2\x86\x92", // →
+	"\xE2\x86\x98", // ↘
+	"\xE2\x86\x93", // ↓
+	"\xE2\x86\x99", // ↙
+	"\xE2\x86\x90", // ←
+	"\xE2\x86\x96", // ↖
+};
+
+} // namespace
+
+void MotionTracker::setSettings(const MotionSettings &settings)
+{
+	outputRate.store(settings.outputRate > 0 ? settings.outputRate : 1, std::memory_order_relaxed);
+	dragThreshold.store(settings.dragThreshold, std::memory_order_relaxed);
+	simplifyTolerance.store(settings.simplifyTolerance, std::memory_order_relaxed);
+}
+
+void MotionTracker::buttonDown(MotionButton button, int32_t x, int32_t y, uint64_t timestamp)
+{
+	// A second button during a drag does not restart it
+	if (tracking) {
+		return;
+	}
+	tracking = true;
+	trackedButton = button;
+	sampleInterval = 1000000000ull / outputRate.load(std::memory_order_relaxed);
+	maxDistanceSquared = 0;
+	samplesUsed = 0;
+	latest = {x, y, timestamp};
+	appendSample(latest);
+	nextSampleTime = timestamp + sampleInterval;
+}
+
+void MotionTracker::move(int32_t x, int32_t y, uint64_t timestamp)
+{
+	if (!tracking) {
+		return;
+	}
+	motionEventCount++;
+	latest = {x, y, timestamp};
+
+	int64_t dx = x - samples[0].x;
+	int64_t dy = y - samples[0].y;
+	if (dx * dx + dy * dy > maxDistanceSquared) {
+		maxDistanceSquared = dx * dx + dy * dy;
+	}
+
+	if (timestamp >= nextSampleTime) {
+		appendSample(latest);
+		nextSampleTime = timestamp + sampleInterval;
+	}
+}
+
+bool MotionTracker::buttonUp(MotionButton button, int32_t x, int32_t y, uint64_t timestamp, MotionGesture &gesture)
+{
+	if (!tracking || button != trackedButton) {
+		return false;
+	}
+	move(x, y, timestamp);
+	tracking = false;
+
+	int64_t threshold = dragThreshold.load(std::memory_order_relaxed);
+	if (maxDistanceSquared < threshold * threshold) {
+		return false;
+	}
+
+	// The release position always ends the path, even between two sample times
+	const Sample &last = samples[samplesUsed - 1];
+	if (last.timestamp != latest.timestamp || last.x != latest.x || last.y != latest.y) {
+		appendSample(latest);
+	}
+
+	gesture.button = button;
+	gesture.dx = latest.x - samples[0].x;
+	gesture.dy = latest.y - samples[0].y;
+	gesture.durationMs = (uint32_t)((latest.timestamp - samples[0].timestamp) / 1000000);
+	simplify(gesture);
+	return true;
+}
+
+void MotionTracker::appendSample(const Sample &sample)
+{
+	if (samplesUsed == MAX_SAMPLES) {
+		// Keep every other sample (always the first) and sample half as often from now on
+		for (size_t i = 1; i < MAX_SAMPLES / 2; i++) {
+			samples[i] = samples[i * 2];
+		}
+		samplesUsed = MAX_SAMPLES / 2;
+		sampleInterval *= 2;
+	}
+	samples[samplesUsed++] = sample;
+	sampleCount++;
+}
+
+void MotionTracker::simplify(MotionGesture &gesture) const
+{
+	struct Range {
+		uint16_t first;
+		uint16_t last;
+	};
+
+	std::bitset<MAX_SAMPLES> keep;
+	Range stack[MAX_SAMPLES];
+	float tolerance = simplifyTolerance.load(std::memory_order_relaxed);
+	if (tolerance < 0.5f) {
+		tolerance = 0.5f;
+	}
+
+	for (;;) {
+		keep.reset();
+		keep.set(0);
+		keep.set(samplesUsed - 1);
+		size_t stackSize = 0;
+		if (samplesUsed > 2) {
+			stack[stackSize++] = {0, (uint16_t)(samplesUsed - 1)};
+		}
+
+		// Iterative Ramer-Douglas-Peucker: keep the point farthest from each chord if it is
+		// farther than the tolerance, and split there
+		while (stackSize > 0) {
+			Range range = stack[--stackSize];
+			const Sample &a = samples[range.first];
+			const Sample &b = samples[range.last];
+			float abx = (float)(b.x - a.x);
+			float aby = (float)(b.y - a.y);
+			float length = std::sqrt(abx * abx + aby * aby);
+
+			float farthest = -1.0f;
+			uint16_t split = range.first;
+			for (uint16_t i = range.first + 1; i < range.last; i++) {
+				float px = (float)(samples[i].x - a.x);
+				float py = (float)(samples[i].y - a.y);
+				float distance = length > 0.0f ? std::fabs(abx * py - aby * px) / length
+								 : std::sqrt(px * px + py * py);
+				if (distance > farthest) {
+					farthest = distance;
+					split = i;
+				}
+			}
+			if (farthest > tolerance) {
+				keep.set(split);
+				if (split - range.first > 1) {
+					stack[stackSize++] = {range.first, split};
+				}
+				if (range.last - split > 1) {
+					stack[stackSize++] = {split, range.last};
+				}
+			}
+		}
+
+		if (keep.count() <= MAX_GESTURE_POINTS) {
+			break;
+		}
+		tolerance *= 2.0f;
+	}
+
+	gesture.path.count = 0;
+	for (size_t i = 0; i < samplesUsed; i++) {
+		if (keep.test(i)) {
+			GesturePoint &point = gesture.path.points[gesture.path.count++];
+			point.x = samples[i].x - samples[0].x;
+			point.y = samples[i].y - samples[0].y;
+			point.ms = (uint32_t)((samples[i].timestamp - samples[0].timestamp) / 1000000);
+		}
+	}
+}
+
+void formatGestureAction(const MotionGesture &gesture, ChordText &out)
+{
+	switch (gesture.button) {
+	case MotionButton::Right:
+		out.append("Right Drag ");
+		break;
+	case MotionButton::Middle:
+		out.append("Middle Drag ");
+		break;
+	default:
+		out.append("Drag ");
+		break;
+	}
+
+	// Degrees clockwise from up
+	float angle = std::atan2((float)gesture.dx, (float)-gesture.dy) * 57.29578f;
+	if (angle < 0.0f) {
+		angle += 360.0f;
+	}
+	out.append(directionArrows[(int)std::floor((angle + 22.5f) / 45.0f) % 8]);
+
+	char distance[24];
+	snprintf(distance, sizeof(distance), " %.0fpx", std::sqrt((float)gesture.dx * gesture.dx + (float)gesture.dy * gesture.dy));
+	out.append(distance);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_MOTION_HPP
+#define STREAMUP_HOTKEY_CORE_MOTION_HPP
+
+#include <atomic>
+#include <cstdint>
+#include "streamup-hotkey-core-chord.hpp"
+
+struct MotionSettings {
+	uint32_t outputRate = 120;     // Path samples kept per second of a drag
+	int32_t dragThreshold = 8;     // Pixels the pointer has to travel with a button held to count as a drag
+	float simplifyTolerance = 2.0f; // Ramer-Douglas-Peucker tolerance in pixels
+};
+
+enum class MotionButton : uint8_t {
+	Left,
+	Right,
+	Middle,
+};
+
+// A finished drag
+struct MotionGesture {
+	MotionButton button = MotionButton::Left;
+	int32_t dx = 0; // End minus start, y grows downwards
+	int32_t dy = 0;
+	uint32_t durationMs = 0;
+	GesturePath path;
+};
+
+// Turns pointer motion into drag gestures at a cost that does not depend on the mouse's polling
+// rate. A motion event only stores the latest position and, at most once per output interval,
+// appends it to a fixed sample buffer; a long drag halves the buffer and the rate instead of
+// growing. The path is simplified (Ramer-Douglas-Peucker, tolerance raised until it fits
+// MAX_GESTURE_POINTS) once, when the button goes up. Not thread-safe: feed it from the capture
+// thread that owns the hook; setSettings() may be called from anywhere.
+class MotionTracker {
+public:
+	void setSettings(const MotionSettings &settings);
+
+	// Absolute positions in screen pixels
+	void buttonDown(MotionButton button, int32_t x, int32_t y, uint64_t timestamp);
+	void move(int32_t x, int32_t y, uint64_t timestamp);
+	// Returns true and fills the gesture if the pointer moved far enough while the button was held
+	bool buttonUp(MotionButton button, int32_t x, int32_t y, uint64_t timestamp, MotionGesture &gesture);
+	void reset() { tracking = false; }
+
+	bool isTracking() const { return tracking; }
+	// Motion events seen while tracking and the samples they were reduced to, since start
+	uint64_t motionEvents() const { return motionEventCount; }
+	uint64_t motionSamples() const { return sampleCount; }
+
+private:
+	static constexpr size_t MAX_SAMPLES = 512;
+
+	struct Sample {
+		int32_t x;
+		int32_t y;
+		uint64_t timestamp;
+	};
+
+	void appendSample(const Sample &sample);
+	void simplify(MotionGesture &gesture) const;
+
+	std::atomic<uint32_t> outputRate{MotionSettings().outputRate};
+	std::atomic<int32_t> dragThreshold{MotionSettings().dragThreshold};
+	std::atomic<float> simplifyTolerance{MotionSettings().simplifyTolerance};
+
+	bool tracking = false;
+	MotionButton trackedButton = MotionButton::Left;
+	uint64_t sampleInterval = 0;
+	uint64_t nextSampleTime = 0;
+	int64_t maxDistanceSquared = 0;
+	Sample latest = {};
+	Sample samples[MAX_SAMPLES];
+	size_t samplesUsed = 0;
+	uint64_t motionEventCount = 0;
+	uint64_t sampleCount = 0;
+};
+
+// "Drag ↘ 240px", "Right Drag ← 35px"; the caller prefixes held modifiers
+void formatGestureAction(const MotionGesture &gesture, ChordText &out);
+
+#endif // STREAMUP_HOTKEY_CORE_MOTION_HPP
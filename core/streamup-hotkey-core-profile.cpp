@@ -0,0 +1,209 @@
+#include "streamup-hotkey-core-profile.hpp"
+
+#include <unordered_map>
+
+namespace {
+
+std::string_view trimSpaces(std::string_view text)
+{
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) {
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+		text.remove_suffix(1);
+	}
+	return text;
+}
+
+void assignLower(std::string &out, std::string_view text)
+{
+	out.clear();
+	for (char c : text) {
+		out.push_back((c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c);
+	}
+}
+
+// Parses "letters, numbers"; returns false on an unknown category
+bool parseCaptureCategories(std::string_view value, HotkeyFilterSettings &filter)
+{
+	HotkeyFilterSettings parsed;
+	while (!value.empty()) {
+		size_t separator = value.find(',');
+		std::string category;
+		assignLower(category, trimSpaces(value.substr(0, separator)));
+		value = separator == std::string_view::npos ? std::string_view() : value.substr(separator + 1);
+
+		if (category == "numpad") {
+			parsed.captureNumpad = true;
+		} else if (category == "numbers") {
+			parsed.captureNumbers = true;
+		} else if (category == "letters") {
+			parsed.captureLetters = true;
+		} else if (category == "punctuation") {
+			parsed.capturePunctuation = true;
+		} else if (category != "none" && !category.empty()) {
+			return false;
+		}
+	}
+	filter = parsed;
+	return true;
+}
+
+} // namespace
+
+std::vector<CaptureProfile> parseCaptureProfiles(std::string_view text, const CaptureProfile &defaults,
+						 std::vector<std::string> *errors)
+{
+	std::vector<CaptureProfile> profiles;
+	size_t lineNumber = 0;
+
+	auto reportError = [&](const char *message) {
+		if (errors) {
+			errors->push_back("line " + std::to_string(lineNumber) + ": " + message);
+		}
+	};
+
+	while (!text.empty()) {
+		size_t end = text.find('\n');
+		std::string_view line = trimSpaces(text.substr(0, end));
+		text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+		lineNumber++;
+
+		if (line.empty() || line.front() == '#') {
+			continue;
+		}
+
+		if (line.front() == '[') {
+			std::string_view name;
+			if (line.back() == ']') {
+				name = trimSpaces(line.substr(1, line.size() - 2));
+			}
+			if (name.empty()) {
+				reportError("expected '[window class]'");
+				continue;
+			}
+			CaptureProfile profile = defaults;
+			assignLower(profile.windowClass, name);
+			profile.titleFilter.clear();
+			profile.application = profile.windowClass; // Its own dictionary section unless told otherwise
+			profiles.push_back(std::move(profile));
+			continue;
+		}
+
+		if (profiles.empty()) {
+			reportError("setting outside of a [window class] section");
+			continue;
+		}
+
+		size_t separator = line.find('=');
+		if (separator == std::string_view::npos) {
+			reportError("expected 'setting = value'");
+			continue;
+		}
+
+		CaptureProfile &profile = profiles.back();
+		std::string key;
+		assignLower(key, trimSpaces(line.substr(0, separator)));
+		std::string_view value = trimSpaces(line.substr(separator + 1));
+
+		if (key == "capture") {
+			if (!parseCaptureCategories(value, profile.filter)) {
+				reportError("unknown capture category");
+			}
+		} else if (key == "prefix") {
+			// Keep one trailing space so "VS Code:" separates from the chord
+			profile.prefix = value.empty() ? std::string() : std::string(value) + " ";
+		} else if (key == "dictionary") {
+			assignLower(profile.application, value);
+		} else if (key == "title") {
+			assignLower(profile.titleFilter, value);
+		} else {
+			reportError("unknown setting");
+		}
+	}
+
+	return profiles;
+}
+
+struct CaptureProfileSwitcher::ProfileSet {
+	CaptureProfile defaultProfile;
+	std::vector<CaptureProfile> profiles; // Never resized after construction
+	// Window class -> candidates, profiles with a title filter first
+	std::unordered_map<std::string, std::vector<const CaptureProfile *>> byClass;
+};
+
+CaptureProfileSwitcher::CaptureProfileSwitcher() = default;
+CaptureProfileSwitcher::~CaptureProfileSwitcher() = default;
+
+void CaptureProfileSwitcher::setProfiles(const CaptureProfile &defaultProfile, const std::vector<CaptureProfile> &profiles)
+{
+	auto compiled = std::make_unique<ProfileSet>();
+	compiled->defaultProfile = defaultProfile;
+	compiled->profiles = profiles;
+	for (const CaptureProfile &profile : compiled->profiles) {
+		if (!profile.titleFilter.empty()) {
+			compiled->byClass[profile.windowClass].push_back(&profile);
+		}
+	}
+	for (const CaptureProfile &profile : compiled->profiles) {
+		if (profile.titleFilter.empty()) {
+			compiled->byClass[profile.windowClass].push_back(&profile);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (current) {
+		retired.push_back(std::move(current));
+	}
+	current = std::move(compiled);
+	activeProfile.store(resolve(), std::memory_order_release);
+}
+
+void CaptureProfileSwitcher::releaseRetired()
+{
+	// Destroyed outside the lock
+	std::vector<std::unique_ptr<ProfileSet>> released;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		released.swap(retired);
+	}
+}
+
+void CaptureProfileSwitcher::activateWindow(std::string_view instanceName, std::string_view className, std::string_view title)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	assignLower(windowInstance, instanceName);
+	assignLower(windowClass, className);
+	assignLower(windowTitle, title);
+	if (current) {
+		activeProfile.store(resolve(), std::memory_order_release);
+	}
+}
+
+const CaptureProfile *CaptureProfileSwitcher::resolve() const
+{
+	auto matches = [this](const std::string &name) -> const CaptureProfile * {
+		if (name.empty()) {
+			return nullptr;
+		}
+		auto it = current->byClass.find(name);
+		if (it == current->byClass.end()) {
+			return nullptr;
+		}
+		for (const CaptureProfile *profile : it->second) {
+			if (profile->titleFilter.empty() || windowTitle.find(profile->titleFilter) != std::string::npos) {
+				return profile;
+			}
+		}
+		return nullptr;
+	};
+
+	// The instance name is the more specific half of WM_CLASS
+	if (const CaptureProfile *profile = matches(windowInstance)) {
+		return profile;
+	}
+	if (const CaptureProfile *profile = matches(windowClass)) {
+		return profile;
+	}
+	return &current->defaultProfile;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_PROFILE_HPP
+#define STREAMUP_HOTKEY_CORE_PROFILE_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "streamup-hotkey-core-filter.hpp"
+
+// Capture settings that apply while a given application has focus
+struct CaptureProfile {
+	std::string windowClass; // Lowercase; empty for the default profile
+	std::string titleFilter; // Lowercase substring the window title must contain, empty = any
+	HotkeyFilterSettings filter;
+	std::string application; // Action dictionary scope, lowercase
+	std::string prefix;      // Shown in front of every chord
+};
+
+// Parses per-application profiles. Each section names a window class (instance or class part of
+// WM_CLASS, case-insensitive) and starts from the default profile's settings:
+//
+//   # Comment
+//   [code]
+//   capture = letters, numbers, punctuation
+//   prefix = VS Code:
+//   dictionary = code
+//   title = .cpp
+//
+// capture takes any of numpad, numbers, letters, punctuation or none. dictionary defaults to the
+// section name. When several sections match a window, the first one with a matching title filter
+// wins, then the first one without a title filter. Malformed lines are reported through errors as
+// "line N: ..." and skipped.
+std::vector<CaptureProfile> parseCaptureProfiles(std::string_view text, const CaptureProfile &defaults,
+						 std::vector<std::string> *errors = nullptr);
+
+// Switches the active profile when the focused window changes. Profiles are compiled once by
+// setProfiles(); activateWindow() resolves the window against that compiled set and publishes the
+// result with a single pointer store, which the capture and dispatcher threads read with one
+// acquire load. Nothing is computed per key event.
+class CaptureProfileSwitcher {
+public:
+	CaptureProfileSwitcher();
+	~CaptureProfileSwitcher();
+
+	// Replaces every profile and re-resolves the last window. Previous generations stay alive
+	// until releaseRetired(), for readers that loaded an older pointer.
+	void setProfiles(const CaptureProfile &defaultProfile, const std::vector<CaptureProfile> &profiles);
+
+	// Frees the generations replaced so far. Only once no reader can still hold one of their
+	// pointers: after HotkeyEngine::quiesce() and ChordDispatcher::quiesce().
+	void releaseRetired();
+
+	// Called by the window tracker when focus or the focused window's title changes
+	void activateWindow(std::string_view instanceName, std::string_view className, std::string_view title);
+
+	// Null until setProfiles() has been called
+	const CaptureProfile *active() const { return activeProfile.load(std::memory_order_acquire); }
+
+private:
+	struct ProfileSet;
+
+	const CaptureProfile *resolve() const;
+
+	mutable std::mutex mutex; // Protects everything below except activeProfile
+	std::unique_ptr<ProfileSet> current;
+	std::vector<std::unique_ptr<ProfileSet>> retired;
+	std::string windowInstance; // Lowercase copies of the last activated window
+	std::string windowClass;
+	std::string windowTitle;
+
+	std::atomic<const CaptureProfile *> activeProfile{nullptr};
+};
+
+#endif // STREAMUP_HOTKEY_CORE_PROFILE_HPP
@@ -0,0 +1,231 @@
+#include "streamup-hotkey-core-sequence.hpp"
+
+namespace {
+
+std::string_view trimSpaces(std::string_view text)
+{
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) {
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+		text.remove_suffix(1);
+	}
+	return text;
+}
+
+} // namespace
+
+std::vector<SequenceDefinition> parseSequenceDefinitions(std::string_view text)
+{
+	std::vector<SequenceDefinition> definitions;
+
+	while (!text.empty()) {
+		size_t end = text.find('\n');
+		std::string_view line = trimSpaces(text.substr(0, end));
+		text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+
+		if (line.empty() || line.front() == '#') {
+			continue;
+		}
+
+		// The last " = " separates the action, so a step like "Ctrl + =" still parses
+		SequenceDefinition definition;
+		size_t actionStart = line.rfind(" = ");
+		if (actionStart != std::string_view::npos) {
+			definition.action = std::string(trimSpaces(line.substr(actionStart + 3)));
+			line = line.substr(0, actionStart);
+		}
+
+		while (!line.empty()) {
+			size_t separator = line.find(',');
+			std::string step = normaliseChordText(line.substr(0, separator));
+			line = separator == std::string_view::npos ? std::string_view() : line.substr(separator + 1);
+			if (!step.empty()) {
+				definition.steps.push_back(std::move(step));
+			}
+		}
+
+		if (!definition.steps.empty()) {
+			definitions.push_back(std::move(definition));
+		}
+	}
+
+	return definitions;
+}
+
+// The compiled dictionary. Trie edges are stored in a flat open-addressed table (load factor at
+// most one half) instead of per-node maps, so a lookup is a hash, a mask and a short probe.
+struct SequenceMatcher::Table {
+	struct Edge {
+		uint64_t hash = 0; // Chord text hash
+		uint32_t from = 0;
+		uint32_t to = 0; // 0 = empty slot; the root is never a target
+	};
+
+	struct Node {
+		int32_t sequence = -1; // Index into completions when a sequence ends here
+		bool hasChildren = false;
+	};
+
+	std::vector<Edge> edges;
+	size_t mask = 0;
+	std::vector<Node> nodes;
+	struct Completion {
+		std::string text; // The steps joined with ", "
+		std::string action;
+	};
+	std::vector<Completion> completions;
+
+	size_t slotFor(uint32_t from, uint64_t hash) const
+	{
+		uint64_t mixed = hash ^ ((uint64_t)from * 0x9E3779B97F4A7C15ull);
+		mixed ^= mixed >> 29;
+		return (size_t)mixed & mask;
+	}
+
+	uint32_t find(uint32_t from, uint64_t hash) const
+	{
+		for (size_t slot = slotFor(from, hash);; slot = (slot + 1) & mask) {
+			const Edge &edge = edges[slot];
+			if (edge.to == 0) {
+				return 0;
+			}
+			if (edge.from == from && edge.hash == hash) {
+				return edge.to;
+			}
+		}
+	}
+
+	uint32_t findOrAdd(uint32_t from, uint64_t hash)
+	{
+		size_t slot = slotFor(from, hash);
+		for (;; slot = (slot + 1) & mask) {
+			const Edge &edge = edges[slot];
+			if (edge.to == 0) {
+				break;
+			}
+			if (edge.from == from && edge.hash == hash) {
+				return edge.to;
+			}
+		}
+
+		uint32_t to = (uint32_t)nodes.size();
+		nodes.emplace_back();
+		nodes[from].hasChildren = true;
+		edges[slot] = {hash, from, to};
+		return to;
+	}
+};
+
+SequenceMatcher::SequenceMatcher() = default;
+SequenceMatcher::~SequenceMatcher() = default;
+
+void SequenceMatcher::compile(const std::vector<SequenceDefinition> &definitions)
+{
+	auto compiled = std::make_unique<Table>();
+
+	// Every step adds at most one edge; size the table up front so it never rehashes
+	size_t stepCount = 0;
+	for (const SequenceDefinition &definition : definitions) {
+		stepCount += definition.steps.size();
+	}
+	size_t capacity = 16;
+	while (capacity < stepCount * 2) {
+		capacity *= 2;
+	}
+	compiled->edges.resize(capacity);
+	compiled->mask = capacity - 1;
+	compiled->nodes.reserve(stepCount + 1);
+	compiled->nodes.emplace_back(); // Root
+
+	for (const SequenceDefinition &definition : definitions) {
+		uint32_t node = 0;
+		Table::Completion completion;
+		for (const std::string &step : definition.steps) {
+			node = compiled->findOrAdd(node, hashChordText(step));
+			if (!completion.text.empty()) {
+				completion.text += ", ";
+			}
+			completion.text += step;
+		}
+		completion.action = definition.action;
+
+		Table::Node &end = compiled->nodes[node];
+		if (end.sequence >= 0) {
+			compiled->completions[(size_t)end.sequence] = std::move(completion);
+		} else {
+			end.sequence = (int32_t)compiled->completions.size();
+			compiled->completions.push_back(std::move(completion));
+		}
+	}
+
+	// Swap under the lock, destroy the old dictionary outside it
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		table.swap(compiled);
+		state = 0;
+	}
+}
+
+void SequenceMatcher::setStepTimeout(uint64_t timeoutMs)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	stepTimeoutNs = timeoutMs * 1000000ull;
+}
+
+size_t SequenceMatcher::sequenceCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return table ? table->completions.size() : 0;
+}
+
+bool SequenceMatcher::feed(const ChordEvent &chord, ChordEvent &completed)
+{
+	if (chord.kind == ChordKind::Release) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!table || table->completions.empty()) {
+		return false;
+	}
+	if (chord.kind != ChordKind::Keyboard) {
+		state = 0;
+		return false;
+	}
+
+	if (state != 0 && chord.timestamp - lastStepTime > stepTimeoutNs) {
+		state = 0;
+	}
+
+	// A chord that does not continue the prefix may still start a new sequence
+	uint32_t next = table->find(state, chord.hash);
+	if (next == 0 && state != 0) {
+		next = table->find(0, chord.hash);
+	}
+	state = next;
+	lastStepTime = chord.timestamp;
+
+	if (next == 0 || table->nodes[next].sequence < 0) {
+		return false;
+	}
+
+	const Table::Node &node = table->nodes[next];
+	const Table::Completion &completion = table->completions[(size_t)node.sequence];
+	completed = chord;
+	completed.text.assign(completion.text);
+	completed.action.assign(completion.action);
+	completed.hash = hashChordText(completed.text.view());
+
+	// Stay in place if a longer sequence shares this prefix
+	if (!node.hasChildren) {
+		state = 0;
+	}
+	return true;
+}
+
+void SequenceMatcher::reset()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	state = 0;
+}
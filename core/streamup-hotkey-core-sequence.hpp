@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_SEQUENCE_HPP
+#define STREAMUP_HOTKEY_CORE_SEQUENCE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "streamup-hotkey-core-chord.hpp"
+
+// A multi-stroke shortcut such as Emacs "Ctrl + X, Ctrl + S" or VS Code "Ctrl + K, Ctrl + C".
+// Steps are chords written exactly as they are displayed.
+struct SequenceDefinition {
+	std::vector<std::string> steps;
+	std::string action; // Optional, shown after the sequence
+};
+
+// Parses one definition per line: "Ctrl + X, Ctrl + S = Save". Steps are separated by ',', the
+// optional action follows '='. Blank lines and lines starting with '#' are skipped.
+std::vector<SequenceDefinition> parseSequenceDefinitions(std::string_view text);
+
+// Recognises defined sequences in the stream of shown chords. The definitions are compiled into
+// a trie whose transitions live in one open-addressed table keyed by (state, chord hash), so each
+// chord costs at most two table probes no matter how many sequences are defined. A chord that
+// does not continue the current prefix restarts matching from the root (like an editor aborting
+// an unknown prefix), and a prefix expires when the next step takes longer than the step timeout.
+// feed() runs on the dispatcher thread; compile() may be called from any thread.
+class SequenceMatcher {
+public:
+	static constexpr uint64_t DEFAULT_STEP_TIMEOUT_MS = 1500;
+
+	SequenceMatcher();
+	~SequenceMatcher();
+
+	// Replaces the dictionary and resets any partial match. Later duplicates win.
+	void compile(const std::vector<SequenceDefinition> &definitions);
+	void setStepTimeout(uint64_t timeoutMs);
+	size_t sequenceCount() const;
+
+	// Advances on a shown chord. When it completes a sequence, completed is set to a copy of the
+	// chord whose text is the whole sequence ("Ctrl + X, Ctrl + S") and whose action is the
+	// sequence's action name, and true is returned.
+	// Mouse actions break a partial match; releases are ignored.
+	bool feed(const ChordEvent &chord, ChordEvent &completed);
+	void reset();
+
+private:
+	struct Table;
+
+	mutable std::mutex mutex; // Protects table and the match state
+	std::unique_ptr<Table> table;
+	uint64_t stepTimeoutNs = DEFAULT_STEP_TIMEOUT_MS * 1000000ull;
+	uint32_t state = 0; // Trie node of the current prefix, 0 = root
+	uint64_t lastStepTime = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_SEQUENCE_HPP
@@ -0,0 +1,160 @@
+#include "streamup-hotkey-core-shm.hpp"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::string shmRingDefaultName()
+{
+	return "/streamup-hotkey-display-" + std::to_string(getuid());
+}
+
+ShmRingReader::~ShmRingReader()
+{
+	close();
+}
+
+bool ShmRingReader::open(const std::string &name, bool fromOldest)
+{
+	close();
+
+	// Read-write only so the reader can count itself as a waiter
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(ShmRingHeader)) {
+		::close(fd);
+		return false;
+	}
+
+	size_t size = (size_t)info.st_size;
+	void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+
+	ShmRingHeader *mappedHeader = static_cast<ShmRingHeader *>(mapping);
+	bool valid = mappedHeader->magic == SHM_RING_MAGIC;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	valid = valid && mappedHeader->version == SHM_RING_VERSION && mappedHeader->recordSize == sizeof(ShmRingRecord) &&
+		mappedHeader->capacity > 0 && (mappedHeader->capacity & (mappedHeader->capacity - 1)) == 0 &&
+		size >= shmRingSize(mappedHeader->capacity);
+	if (!valid) {
+		munmap(mapping, size);
+		return false;
+	}
+
+	header = mappedHeader;
+	records = reinterpret_cast<const ShmRingRecord *>(static_cast<const char *>(mapping) + sizeof(ShmRingHeader));
+	mappedSize = size;
+	lost = 0;
+
+	uint64_t newest = header->writeSequence.load(std::memory_order_acquire);
+	if (fromOldest) {
+		readSequence = newest >= header->capacity ? newest - header->capacity + 1 : 1;
+	} else {
+		readSequence = newest + 1;
+	}
+	return true;
+}
+
+void ShmRingReader::close()
+{
+	if (!header) {
+		return;
+	}
+
+	munmap(header, mappedSize);
+	header = nullptr;
+	records = nullptr;
+	mappedSize = 0;
+}
+
+bool ShmRingReader::next(ShmRingEvent &event)
+{
+	if (!header) {
+		return false;
+	}
+
+	const uint64_t capacity = header->capacity;
+	for (;;) {
+		uint64_t newest = header->writeSequence.load(std::memory_order_acquire);
+		if (readSequence > newest) {
+			return false;
+		}
+
+		// Lapped by the writer: jump to the oldest record that still exists
+		if (newest - readSequence >= capacity) {
+			uint64_t oldest = newest - capacity + 1;
+			lost += oldest - readSequence;
+			readSequence = oldest;
+		}
+
+		const ShmRingRecord &record = records[(readSequence - 1) & (capacity - 1)];
+		uint64_t before = record.sequence.load(std::memory_order_acquire);
+		if (before != readSequence) {
+			// Already overwritten (or being overwritten) by a newer lap
+			lost++;
+			readSequence++;
+			continue;
+		}
+
+		event.timestampNs = record.timestampNs;
+		event.kind = record.kind;
+		event.flags = record.flags;
+		event.keyCount = std::min<uint8_t>(record.keyCount, (uint8_t)SHM_RING_MAX_KEYS);
+		memcpy(event.keys, record.keys, sizeof(event.keys));
+		size_t textLength = std::min<size_t>(record.textLength, SHM_RING_TEXT_SIZE - 1);
+		memcpy(event.text, record.text, textLength);
+		event.text[textLength] = '\0';
+
+		// The copy is only valid if the writer did not touch the record meanwhile
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (record.sequence.load(std::memory_order_relaxed) != before) {
+			lost++;
+			readSequence++;
+			continue;
+		}
+
+		event.sequence = readSequence++;
+		return true;
+	}
+}
+
+bool ShmRingReader::wait(int timeoutMs)
+{
+	if (!header) {
+		return false;
+	}
+
+	// Registered before the word is read, so a writer that bumps it afterwards sees the waiter
+	header->waiters.fetch_add(1, std::memory_order_seq_cst);
+	uint32_t observed = header->futexWord.load(std::memory_order_seq_cst);
+	if (header->writeSequence.load(std::memory_order_acquire) >= readSequence) {
+		header->waiters.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	struct timespec timeout;
+	struct timespec *timeoutPtr = nullptr;
+	if (timeoutMs >= 0) {
+		timeout.tv_sec = timeoutMs / 1000;
+		timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+		timeoutPtr = &timeout;
+	}
+
+	// Returns immediately if the writer bumped the word after it was loaded above
+	syscall(SYS_futex, reinterpret_cast<const uint32_t *>(&header->futexWord), FUTEX_WAIT, observed, timeoutPtr,
+		nullptr, 0);
+	header->waiters.fetch_sub(1, std::memory_order_relaxed);
+	return header->writeSequence.load(std::memory_order_acquire) >= readSequence;
+}
@@ -0,0 +1,182 @@
+#include "streamup-hotkey-core-shm.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-latency.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(SHM_RING_TEXT_SIZE == COMBINATION_BUFFER_SIZE, "ring records must hold a full chord");
+static_assert(SHM_RING_MAX_KEYS == MAX_COMBINATION_KEYS, "ring records must hold every chord key");
+static_assert((SHM_RING_CAPACITY & (SHM_RING_CAPACITY - 1)) == 0, "ring capacity must be a power of two");
+static_assert(SHM_RECORD_RELEASE == (uint8_t)ChordKind::Release, "record kinds must match ChordKind");
+static_assert(SHM_RECORD_GAMEPAD == (uint8_t)ChordKind::Gamepad, "record kinds must match ChordKind");
+static_assert(SHM_RECORD_GESTURE == (uint8_t)ChordKind::Gesture, "record kinds must match ChordKind");
+
+namespace {
+
+// True if the object under name was left behind by a writer that is gone. A ring without a
+// header or writer pid never finished being created.
+bool isStaleRing(const std::string &name)
+{
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		return errno == ENOENT; // Unlinked meanwhile, so the name is free again
+	}
+
+	struct stat info;
+	int32_t writerPid = 0;
+	if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(ShmRingHeader)) {
+		void *mapping = mmap(nullptr, sizeof(ShmRingHeader), PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping != MAP_FAILED) {
+			writerPid = static_cast<const ShmRingHeader *>(mapping)->writerPid;
+			munmap(mapping, sizeof(ShmRingHeader));
+		}
+	}
+	::close(fd);
+
+	return writerPid <= 0 || (kill((pid_t)writerPid, 0) != 0 && errno == ESRCH);
+}
+
+} // namespace
+
+ShmRingWriter::~ShmRingWriter()
+{
+	close();
+}
+
+bool ShmRingWriter::open(const std::string &name)
+{
+	close();
+
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0 && errno == EEXIST && isStaleRing(name)) {
+		// A previous instance that crashed left its object behind; readers still holding it keep
+		// their mapping, new readers get the fresh one
+		shm_unlink(name.c_str());
+		fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	}
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	size_t size = shmRingSize(SHM_RING_CAPACITY);
+	if (ftruncate(fd, (off_t)size) != 0) {
+		::close(fd);
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED) {
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	// ftruncate zero-fills, so every record starts with sequence 0 (never written)
+	header = static_cast<ShmRingHeader *>(mapping);
+	records = reinterpret_cast<ShmRingRecord *>(static_cast<char *>(mapping) + sizeof(ShmRingHeader));
+	header->version = SHM_RING_VERSION;
+	header->capacity = SHM_RING_CAPACITY;
+	header->recordSize = sizeof(ShmRingRecord);
+	header->writerPid = (int32_t)getpid();
+
+	// Readers check the magic first, so it is published last
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SHM_RING_MAGIC;
+
+	objectName = name;
+	objectDevice = info.st_dev;
+	objectInode = info.st_ino;
+	nextSequence = 1;
+	return true;
+}
+
+void ShmRingWriter::close()
+{
+	if (!header) {
+		return;
+	}
+
+	munmap(header, shmRingSize(SHM_RING_CAPACITY));
+
+	// Only unlink the name while it is still ours, never a ring another writer has put there
+	int fd = shm_open(objectName.c_str(), O_RDONLY, 0);
+	if (fd >= 0) {
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_dev == objectDevice && info.st_ino == objectInode) {
+			shm_unlink(objectName.c_str());
+		}
+		::close(fd);
+	}
+
+	header = nullptr;
+	records = nullptr;
+	objectName.clear();
+}
+
+bool ShmRingWriter::setMemoryLocked(bool locked)
+{
+	if (!header) {
+		return false;
+	}
+	if (!locked) {
+		unlockMemoryRange(header, shmRingSize(SHM_RING_CAPACITY));
+		return true;
+	}
+	return lockMemoryRange(header, shmRingSize(SHM_RING_CAPACITY));
+}
+
+void ShmRingWriter::write(uint8_t kind, uint8_t flags, uint64_t timestampNs, const int *keys, size_t keyCount, const char *text,
+			  size_t textLength)
+{
+	if (!header) {
+		return;
+	}
+
+	uint64_t sequence = nextSequence++;
+	ShmRingRecord &record = records[(sequence - 1) & (SHM_RING_CAPACITY - 1)];
+
+	// Invalidate first so a reader that is copying the old contents notices the overwrite
+	record.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	keyCount = std::min(keyCount, SHM_RING_MAX_KEYS);
+	textLength = std::min(textLength, SHM_RING_TEXT_SIZE - 1);
+
+	record.timestampNs = timestampNs;
+	record.kind = kind;
+	record.flags = flags;
+	record.keyCount = (uint8_t)keyCount;
+	record.textLength = (uint16_t)textLength;
+	for (size_t i = 0; i < keyCount; i++) {
+		record.keys[i] = keys[i];
+	}
+	memcpy(record.text, text, textLength);
+	record.text[textLength] = '\0';
+
+	record.sequence.store(sequence, std::memory_order_release);
+	header->writeSequence.store(sequence, std::memory_order_release);
+
+	// Sequentially consistent with the reader's registration in ShmRingReader::wait(): either the
+	// reader sees the bumped word and does not sleep, or this sees it counted and wakes it
+	header->futexWord.fetch_add(1, std::memory_order_seq_cst);
+	if (header->waiters.load(std::memory_order_seq_cst) != 0) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t *>(&header->futexWord), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	}
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_SHM_HPP
+#define STREAMUP_HOTKEY_CORE_SHM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+// Shared-memory event ring (Linux). The plugin writes every shown chord into a named POSIX
+// shared-memory object; any number of local processes map it and follow along without sockets
+// or JSON. Readers only ever write the waiter count in the header. The writer never waits for readers: it overwrites the oldest record
+// and readers that fall a full ring behind skip ahead and count the records they lost.
+//
+// Layout (version 1): one ShmRingHeader followed by `capacity` ShmRingRecords. Every record
+// carries the sequence number it was written with (1-based); a reader copies a record and
+// checks that the sequence is unchanged afterwards, so torn reads are detected without locks.
+// Readers sleep on a futex word that the writer bumps after each record; they count themselves
+// in the header while asleep, so the writer only makes the wake-up system call when one is.
+//
+// Version 2 added the waiter count. Version 1 readers never registered as waiters and would only
+// wake on their timeout, so they refuse the newer ring instead.
+
+constexpr uint32_t SHM_RING_MAGIC = 0x4B485553; // "SUHK"
+constexpr uint32_t SHM_RING_VERSION = 2;
+constexpr uint32_t SHM_RING_CAPACITY = 1024; // Power of two
+constexpr size_t SHM_RING_TEXT_SIZE = 256;
+constexpr size_t SHM_RING_MAX_KEYS = 16;
+
+// Record kinds; the values match ChordKind
+enum ShmRecordKind : uint8_t {
+	SHM_RECORD_KEYBOARD = 0,
+	SHM_RECORD_MOUSE = 1,
+	SHM_RECORD_SCROLL = 2,
+	SHM_RECORD_RELEASE = 3,
+	SHM_RECORD_GAMEPAD = 4,
+	SHM_RECORD_GESTURE = 5,
+};
+
+// Record flags
+enum ShmRecordFlag : uint8_t {
+	SHM_RECORD_REPLACES_PREVIOUS = 1 << 0, // Newer count of the previous non-release record (ChordEvent)
+};
+
+struct ShmRingRecord {
+	std::atomic<uint64_t> sequence; // 0 while being written
+	uint64_t timestampNs;           // CLOCK_MONOTONIC
+	uint8_t kind;                   // ShmRecordKind
+	uint8_t keyCount;
+	uint16_t textLength;
+	uint8_t flags; // ShmRecordFlag; was reserved (always 0) in the first plugin versions with the ring
+	uint8_t reserved[3];
+	int32_t keys[SHM_RING_MAX_KEYS]; // Platform key codes (X keycodes on Linux)
+	char text[SHM_RING_TEXT_SIZE];   // Formatted chord, UTF-8, NUL-terminated
+};
+
+struct ShmRingHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;
+	uint32_t recordSize;
+	int32_t writerPid; // Process that created the ring, so a later writer can tell a leftover from a live ring
+	alignas(64) std::atomic<uint64_t> writeSequence; // Sequence of the newest complete record
+	alignas(64) std::atomic<uint32_t> futexWord;     // Bumped after every record
+	std::atomic<uint32_t> waiters;                   // Readers currently sleeping on futexWord
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs lock-free 64-bit atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+
+constexpr size_t shmRingSize(uint32_t capacity)
+{
+	return sizeof(ShmRingHeader) + (size_t)capacity * sizeof(ShmRingRecord);
+}
+
+// Per-user object name, e.g. "/streamup-hotkey-display-1000"
+std::string shmRingDefaultName();
+
+// Writer side, owned by the plugin. Only one thread may call write().
+class ShmRingWriter {
+public:
+	~ShmRingWriter();
+
+	// Creates the named object, readable by the current user only. Fails while another live
+	// process owns the name; an object left behind by a writer that has exited is replaced.
+	bool open(const std::string &name);
+	// Unmaps the object and unlinks the name if it still refers to it
+	void close();
+	bool isOpen() const { return header != nullptr; }
+
+	// Locks the mapping into RAM (low-latency mode) or releases it. Returns false if the lock
+	// was refused; see lockMemoryRange().
+	bool setMemoryLocked(bool locked);
+
+	void write(uint8_t kind, uint8_t flags, uint64_t timestampNs, const int *keys, size_t keyCount, const char *text,
+		   size_t textLength);
+
+private:
+	std::string objectName;
+	dev_t objectDevice = 0; // Identify the created object, so close() leaves a newer one alone
+	ino_t objectInode = 0;
+	ShmRingHeader *header = nullptr;
+	ShmRingRecord *records = nullptr;
+	uint64_t nextSequence = 1;
+};
+
+// One record as handed to a reader
+struct ShmRingEvent {
+	uint64_t sequence;
+	uint64_t timestampNs;
+	uint8_t kind;
+	uint8_t flags;
+	uint8_t keyCount;
+	int32_t keys[SHM_RING_MAX_KEYS];
+	char text[SHM_RING_TEXT_SIZE];
+};
+
+// Reader side. Each reader keeps its own position; the records are only ever read. If the plugin is
+// restarted the name refers to a new object, so readers have to open() again.
+class ShmRingReader {
+public:
+	~ShmRingReader();
+
+	// Maps an existing ring. Reading starts after the newest record, or at the oldest one still in
+	// the ring if fromOldest is set.
+	bool open(const std::string &name, bool fromOldest = false);
+	void close();
+	bool isOpen() const { return header != nullptr; }
+
+	// Copies the next record into event. Returns false when the reader has caught up.
+	bool next(ShmRingEvent &event);
+
+	// Sleeps until the writer publishes a record or timeoutMs passes (-1 waits forever).
+	// Returns true if a record may be available.
+	bool wait(int timeoutMs);
+
+	// Records overwritten before this reader got to them
+	uint64_t lostCount() const { return lost; }
+
+private:
+	ShmRingHeader *header = nullptr; // Writable for the waiter count only
+	const ShmRingRecord *records = nullptr;
+	size_t mappedSize = 0;
+	uint64_t readSequence = 1;
+	uint64_t lost = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_SHM_HPP
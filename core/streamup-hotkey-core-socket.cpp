@@ -0,0 +1,102 @@
+#include "streamup-hotkey-core-socket.hpp"
+#include "streamup-hotkey-core-json.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int LISTEN_BACKLOG = 8;
+
+} // namespace
+
+ChordSocketServer::ChordSocketServer(KeyNameFunction keyName) : keyName(keyName) {}
+
+ChordSocketServer::~ChordSocketServer()
+{
+	stop();
+}
+
+std::string ChordSocketServer::defaultPath()
+{
+	const char *runtimeDir = getenv("XDG_RUNTIME_DIR");
+	if (runtimeDir && *runtimeDir) {
+		return std::string(runtimeDir) + "/streamup-hotkey-display.sock";
+	}
+	return "/tmp/streamup-hotkey-display-" + std::to_string(getuid()) + ".sock";
+}
+
+bool ChordSocketServer::start(const std::string &path)
+{
+	stop();
+
+	sockaddr_un address = {};
+	if (path.size() >= sizeof(address.sun_path)) {
+		return false;
+	}
+	address.sun_family = AF_UNIX;
+	memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	// A socket file left behind by a crashed instance would make bind() fail
+	unlink(path.c_str());
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0 || !EventStreamServer::setNonBlocking(listenFd) ||
+	    bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || chmod(path.c_str(), 0600) != 0 ||
+	    listen(listenFd, LISTEN_BACKLOG) != 0) {
+		if (listenFd >= 0) {
+			close(listenFd);
+		}
+		unlink(path.c_str());
+		return false;
+	}
+
+	EventStreamServer::Settings settings;
+	settings.maxClients = MAX_CLIENTS;
+	settings.queueEvents = CLIENT_QUEUE_LINES;
+	settings.slowClientTimeoutNs = SLOW_CLIENT_TIMEOUT_NS;
+	settings.formatEvent = formatEvent;
+	settings.formatDropNotice = formatDropNotice;
+	settings.userData = this;
+	if (!stream.start(listenFd, settings)) {
+		unlink(path.c_str());
+		return false;
+	}
+
+	socketPath = path;
+	return true;
+}
+
+void ChordSocketServer::stop()
+{
+	if (!stream.isRunning()) {
+		return;
+	}
+
+	stream.stop();
+	unlink(socketPath.c_str());
+	socketPath.clear();
+}
+
+void ChordSocketServer::publish(const ChordEvent &chord)
+{
+	stream.publish(chord);
+}
+
+void ChordSocketServer::formatEvent(std::string &out, const ChordEvent &chord, void *userData)
+{
+	appendChordJson(out, chord, static_cast<ChordSocketServer *>(userData)->keyName);
+	out += '\n';
+}
+
+void ChordSocketServer::formatDropNotice(std::string &out, uint64_t count, uint64_t total)
+{
+	char notice[96];
+	snprintf(notice, sizeof(notice), "{\"kind\":\"dropped\",\"count\":%llu,\"total\":%llu}\n", (unsigned long long)count,
+		 (unsigned long long)total);
+	out.append(notice);
+}
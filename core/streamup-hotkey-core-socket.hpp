@@ -0,0 +1,52 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_SOCKET_HPP
+#define STREAMUP_HOTKEY_CORE_SOCKET_HPP
+
+#include <cstdint>
+#include <string>
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-format.hpp"
+#include "streamup-hotkey-core-stream.hpp"
+
+// Streams chords to local scripts over a Unix domain socket as newline-delimited JSON, one
+// object per chord in the format of appendChordJson() (streamup-hotkey-core-json.hpp).
+//
+// Clients are served by an EventStreamServer (streamup-hotkey-core-stream.hpp): publish() never
+// blocks, a client more than CLIENT_QUEUE_LINES behind loses the oldest lines it has not read and
+// then first receives {"kind":"dropped","count":3,"total":12}, and a client that has made no
+// progress for SLOW_CLIENT_TIMEOUT_NS is disconnected. All socket I/O happens on the server's own
+// thread. POSIX only.
+class ChordSocketServer {
+public:
+	static constexpr size_t MAX_CLIENTS = 16;
+	static constexpr size_t CLIENT_QUEUE_LINES = 256;
+	static constexpr uint64_t SLOW_CLIENT_TIMEOUT_NS = 5000000000ull;
+
+	explicit ChordSocketServer(KeyNameFunction keyName);
+	~ChordSocketServer();
+
+	// Binds the socket (replacing a stale one), readable and writable by the current user only
+	bool start(const std::string &path);
+	void stop();
+	bool isRunning() const { return stream.isRunning(); }
+
+	// Formats the chord once and queues it for every client. Safe to call from any thread.
+	void publish(const ChordEvent &chord);
+
+	// Events lost by clients that fell behind plus events never sent to disconnected ones
+	uint64_t droppedCount() const { return stream.droppedCount(); }
+
+	// $XDG_RUNTIME_DIR/streamup-hotkey-display.sock, or a per-user path in /tmp
+	static std::string defaultPath();
+
+private:
+	static void formatEvent(std::string &out, const ChordEvent &chord, void *userData);
+	static void formatDropNotice(std::string &out, uint64_t count, uint64_t total);
+
+	KeyNameFunction keyName;
+	std::string socketPath;
+	EventStreamServer stream;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_SOCKET_HPP
@@ -0,0 +1,340 @@
+#include "streamup-hotkey-core-stream.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0; // SO_NOSIGPIPE is set per socket instead
+#endif
+
+namespace {
+
+constexpr int POLL_TIMEOUT_MS = 1000; // Also bounds how late a stalled client is disconnected
+
+} // namespace
+
+EventStreamServer::~EventStreamServer()
+{
+	stop();
+}
+
+bool EventStreamServer::setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+bool EventStreamServer::start(int serverFd, const Settings &serverSettings)
+{
+	stop();
+
+	if (serverFd < 0 || serverSettings.queueEvents == 0 || !serverSettings.formatEvent || !serverSettings.formatDropNotice ||
+	    pipe(wakeFds) != 0) {
+		if (serverFd >= 0) {
+			close(serverFd);
+		}
+		wakeFds[0] = wakeFds[1] = -1;
+		return false;
+	}
+	setNonBlocking(wakeFds[0]);
+	setNonBlocking(wakeFds[1]);
+
+	settings = serverSettings;
+	listenFd = serverFd;
+
+	// Sized for a typical event up front; a longer one grows its buffer once
+	events.assign(settings.queueEvents, std::string());
+	for (std::string &event : events) {
+		event.reserve(COMBINATION_BUFFER_SIZE * 2);
+	}
+	publishedCount = 0;
+
+	running.store(true, std::memory_order_release);
+	thread = std::thread(&EventStreamServer::run, this);
+	return true;
+}
+
+void EventStreamServer::stop()
+{
+	if (!running.exchange(false)) {
+		return;
+	}
+
+	wake();
+	if (thread.joinable()) {
+		thread.join();
+	}
+
+	std::lock_guard<std::mutex> lock(clientMutex);
+	for (const auto &client : clients) {
+		close(client->fd);
+	}
+	clients.clear();
+	events.clear();
+
+	close(listenFd);
+	listenFd = -1;
+
+	close(wakeFds[0]);
+	close(wakeFds[1]);
+	wakeFds[0] = wakeFds[1] = -1;
+}
+
+void EventStreamServer::publish(const ChordEvent &chord)
+{
+	if (!isRunning()) {
+		return;
+	}
+
+	uint64_t now = hotkeyCoreTimeNs();
+	{
+		std::lock_guard<std::mutex> lock(clientMutex);
+		bool streaming = false;
+		for (const auto &client : clients) {
+			if (client->state != ClientState::Stream) {
+				continue;
+			}
+			// A client that had caught up starts its stall timer with this event
+			if (!hasPending(*client)) {
+				client->lastProgressTime = now;
+			}
+			streaming = true;
+		}
+		if (!streaming) {
+			return;
+		}
+
+		// Formatted once, into the buffer of the event it replaces
+		std::string &event = events[publishedCount % events.size()];
+		event.clear();
+		settings.formatEvent(event, chord, settings.userData);
+		publishedCount++;
+	}
+
+	wake();
+}
+
+void EventStreamServer::wake()
+{
+	if (wakeFds[1] >= 0) {
+		char byte = 0;
+		// A full pipe already guarantees a wakeup
+		[[maybe_unused]] ssize_t written = write(wakeFds[1], &byte, 1);
+	}
+}
+
+bool EventStreamServer::hasPending(const Client &client) const
+{
+	return !client.sending.empty() || (client.state == ClientState::Stream && client.nextSequence < publishedCount);
+}
+
+void EventStreamServer::run()
+{
+	std::vector<pollfd> pollFds;
+
+	while (running.load(std::memory_order_acquire)) {
+		pollFds.clear();
+		pollFds.push_back({wakeFds[0], POLLIN, 0});
+		pollFds.push_back({listenFd, POLLIN, 0});
+		size_t polledClients;
+		{
+			std::lock_guard<std::mutex> lock(clientMutex);
+			polledClients = clients.size();
+			for (const auto &client : clients) {
+				short events = (short)((client->readClosed ? 0 : POLLIN) | (hasPending(*client) ? POLLOUT : 0));
+				pollFds.push_back({client->fd, events, 0});
+			}
+		}
+
+		if (poll(pollFds.data(), (nfds_t)pollFds.size(), POLL_TIMEOUT_MS) < 0 && errno != EINTR) {
+			break;
+		}
+
+		char drain[64];
+		while (read(wakeFds[0], drain, sizeof(drain)) > 0) {
+		}
+
+		if (pollFds[1].revents & POLLIN) {
+			acceptClients();
+		}
+
+		uint64_t now = hotkeyCoreTimeNs();
+		std::lock_guard<std::mutex> lock(clientMutex);
+
+		// Only this thread adds or removes clients, so the first polledClients entries still line up
+		for (size_t i = 0; i < polledClients; i++) {
+			Client &client = *clients[i];
+			short revents = pollFds[i + 2].revents;
+
+			if (revents & POLLIN) {
+				readClient(client, now);
+			}
+			if (revents & (POLLERR | POLLHUP | POLLNVAL)) {
+				client.disconnect = true;
+			}
+			if (!client.disconnect) {
+				flushClient(client, now);
+			}
+			if (client.state == ClientState::Response && client.sending.empty()) {
+				client.disconnect = true;
+			}
+			// Covers both a request that never completes and a stream that stopped reading
+			bool waiting = hasPending(client) || client.state == ClientState::Request;
+			if (waiting && now - client.lastProgressTime > settings.slowClientTimeoutNs) {
+				client.disconnect = true;
+			}
+		}
+
+		for (auto it = clients.begin(); it != clients.end();) {
+			const Client &client = **it;
+			if (!client.disconnect) {
+				++it;
+				continue;
+			}
+			if (client.state == ClientState::Stream && !client.latestOnly) {
+				uint64_t unsent = std::min<uint64_t>(publishedCount - client.nextSequence, events.size());
+				dropped.fetch_add(unsent, std::memory_order_relaxed);
+			}
+			close(client.fd);
+			it = clients.erase(it);
+		}
+	}
+}
+
+void EventStreamServer::acceptClients()
+{
+	for (;;) {
+		int fd = accept(listenFd, nullptr, nullptr);
+		if (fd < 0) {
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(clientMutex);
+		if (clients.size() >= settings.maxClients || !setNonBlocking(fd)) {
+			close(fd);
+			continue;
+		}
+
+#ifdef SO_NOSIGPIPE
+		int enabled = 1;
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+		auto client = std::make_unique<Client>();
+		client->fd = fd;
+		client->state = settings.handleRequest ? ClientState::Request : ClientState::Stream;
+		client->nextSequence = publishedCount;
+		client->lastProgressTime = hotkeyCoreTimeNs();
+		clients.push_back(std::move(client));
+	}
+}
+
+void EventStreamServer::readClient(Client &client, uint64_t now)
+{
+	char buffer[1024];
+
+	if (client.state == ClientState::Request) {
+		for (;;) {
+			ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+			if (received == 0) {
+				client.disconnect = true;
+				return;
+			}
+			if (received < 0) {
+				if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+					client.disconnect = true;
+				}
+				return;
+			}
+
+			client.lastProgressTime = now;
+			client.request.append(buffer, (size_t)received);
+			StreamReply reply = settings.handleRequest(client.request, settings.userData);
+			if (reply.action == StreamReply::Action::Wait) {
+				continue;
+			}
+
+			client.sending.assign(reply.response);
+			client.sentBytes = 0;
+			if (reply.action == StreamReply::Action::Stream) {
+				client.state = ClientState::Stream;
+				client.latestOnly = reply.latestOnly;
+				client.nextSequence = publishedCount;
+			} else {
+				client.state = ClientState::Response;
+			}
+			std::string().swap(client.request);
+			return;
+		}
+	}
+
+	// Nothing else is expected from a client; discard input and notice EOF
+	ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+	if (received == 0) {
+		// A client may close its side once the request is out and still read the response
+		client.readClosed = true;
+		client.disconnect = client.state == ClientState::Stream;
+	} else if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+		client.disconnect = true;
+	}
+}
+
+void EventStreamServer::refill(Client &client)
+{
+	if (client.state != ClientState::Stream || client.nextSequence >= publishedCount) {
+		return;
+	}
+
+	if (client.latestOnly) {
+		client.nextSequence = publishedCount - 1;
+	} else if (publishedCount - client.nextSequence > events.size()) {
+		// Lapped: the oldest unsent events have been overwritten
+		uint64_t lost = publishedCount - events.size() - client.nextSequence;
+		client.nextSequence += lost;
+		client.droppedEvents += lost;
+		client.unreportedDrops += lost;
+		dropped.fetch_add(lost, std::memory_order_relaxed);
+	}
+
+	if (client.unreportedDrops > 0) {
+		settings.formatDropNotice(client.sending, client.unreportedDrops, client.droppedEvents);
+		client.unreportedDrops = 0;
+		return;
+	}
+
+	client.sending.assign(events[client.nextSequence % events.size()]);
+	client.nextSequence++;
+}
+
+void EventStreamServer::flushClient(Client &client, uint64_t now)
+{
+	for (;;) {
+		if (client.sending.empty()) {
+			refill(client);
+			if (client.sending.empty()) {
+				return;
+			}
+		}
+
+		ssize_t sent = send(client.fd, client.sending.data() + client.sentBytes, client.sending.size() - client.sentBytes,
+				    SEND_FLAGS);
+		if (sent < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				client.disconnect = true;
+			}
+			return;
+		}
+
+		client.lastProgressTime = now;
+		client.sentBytes += (size_t)sent;
+		if (client.sentBytes == client.sending.size()) {
+			client.sending.clear();
+			client.sentBytes = 0;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_STREAM_HPP
+#define STREAMUP_HOTKEY_CORE_STREAM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "streamup-hotkey-core-chord.hpp"
+
+// What a server answers to the request a client has sent so far
+struct StreamReply {
+	enum class Action : uint8_t {
+		Wait,    // The request is incomplete
+		Respond, // Send response, then close the connection
+		Stream,  // Send response (the stream header), then every event published from now on
+	};
+
+	Action action = Action::Wait;
+	std::string_view response; // Copied before the handler returns control
+	bool latestOnly = false;   // Stream: only ever send the newest event, skipping the ones in between
+};
+
+// Non-blocking event fan-out shared by ChordSocketServer and ChordHttpServer. One poll() thread
+// accepts clients on a listening socket and sends them the events publish() formats.
+//
+// Events are formatted once into a ring of queueEvents buffers that every client reads through
+// its own cursor, so publishing never blocks and, once the buffers have grown to fit the longest
+// event, never allocates. A client that falls a full ring behind loses the oldest events it has
+// not sent yet; before its next event it receives a notice with how many it lost and in total. A
+// client that makes no progress for slowClientTimeoutNs while it has something to send (or while
+// its request is incomplete) is disconnected. POSIX only.
+class EventStreamServer {
+public:
+	// Appends one event to out, which is empty on entry
+	using EventFormatter = void (*)(std::string &out, const ChordEvent &chord, void *userData);
+	// Appends the notice for count events lost since the last one, total over the connection
+	using DropNoticeFormatter = void (*)(std::string &out, uint64_t count, uint64_t total);
+	// Looks at everything a client has sent so far
+	using RequestHandler = StreamReply (*)(std::string_view request, void *userData);
+
+	struct Settings {
+		size_t maxClients = 16;
+		size_t queueEvents = 256;
+		uint64_t slowClientTimeoutNs = 5000000000ull;
+		EventFormatter formatEvent = nullptr;
+		DropNoticeFormatter formatDropNotice = nullptr;
+		RequestHandler handleRequest = nullptr; // Without one, clients stream as soon as they connect
+		void *userData = nullptr;
+	};
+
+	~EventStreamServer();
+
+	// Serves clients of listenFd, a listening socket the server takes over (it is closed by
+	// stop(), or right away if starting fails)
+	bool start(int listenFd, const Settings &settings);
+	void stop();
+	bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+	// Formats the chord once for every streaming client. Safe to call from any thread.
+	void publish(const ChordEvent &chord);
+
+	// Events lost by slow clients plus events never sent to disconnected ones
+	uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+	// Non-blocking and close-on-exec
+	static bool setNonBlocking(int fd);
+
+private:
+	enum class ClientState : uint8_t { Request, Response, Stream };
+
+	struct Client {
+		int fd = -1;
+		ClientState state = ClientState::Stream;
+		bool latestOnly = false;
+		bool readClosed = false; // The client shut down its side; a response is still sent
+		bool disconnect = false;
+		std::string request; // Until the request is handled
+		std::string sending; // Copy of the message being sent, so its ring buffer can be reused
+		size_t sentBytes = 0;
+		uint64_t nextSequence = 0; // Next event to send
+		uint64_t droppedEvents = 0;
+		uint64_t unreportedDrops = 0;
+		uint64_t lastProgressTime = 0; // Last successful send or receive, or when there was something to send again
+	};
+
+	void run();
+	void acceptClients();
+	void readClient(Client &client, uint64_t now);
+	bool hasPending(const Client &client) const;
+	void refill(Client &client);
+	void flushClient(Client &client, uint64_t now);
+	void wake();
+
+	Settings settings;
+	int listenFd = -1;
+	int wakeFds[2] = {-1, -1};
+
+	std::thread thread;
+	std::atomic<bool> running{false};
+	std::atomic<uint64_t> dropped{0};
+
+	std::mutex clientMutex;            // Protects clients, events and publishedCount
+	std::vector<std::unique_ptr<Client>> clients;
+	std::vector<std::string> events;   // Event n lives in events[n % queueEvents]
+	uint64_t publishedCount = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_STREAM_HPP
@@ -0,0 +1,280 @@
+#include "streamup-hotkey-core-subtitles.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr size_t FILE_BUFFER_SIZE = 64 * 1024;
+constexpr auto FLUSH_INTERVAL = std::chrono::seconds(2);
+
+// "HH:MM:SS,mmm" (SRT) or "HH:MM:SS.mmm" (WebVTT)
+void appendTimestamp(std::string &out, uint64_t offsetNs, char separator)
+{
+	uint64_t totalMs = offsetNs / 1000000;
+	char text[32];
+	snprintf(text, sizeof(text), "%02llu:%02llu:%02llu%c%03llu", (unsigned long long)(totalMs / 3600000),
+		 (unsigned long long)(totalMs / 60000 % 60), (unsigned long long)(totalMs / 1000 % 60), separator,
+		 (unsigned long long)(totalMs % 1000));
+	out += text;
+}
+
+void appendVttText(std::string &out, std::string_view text)
+{
+	for (char c : text) {
+		switch (c) {
+		case '&':
+			out += "&amp;";
+			break;
+		case '<':
+			out += "&lt;";
+			break;
+		case '>':
+			out += "&gt;";
+			break;
+		default:
+			out += c;
+			break;
+		}
+	}
+}
+
+template<typename T> void appendLittleEndian(std::string &out, T value)
+{
+	for (size_t i = 0; i < sizeof(T); i++) {
+		out += (char)((uint64_t)value >> (8 * i) & 0xFF);
+	}
+}
+
+} // namespace
+
+const char *subtitleFileExtension(SubtitleFormat format)
+{
+	switch (format) {
+	case SubtitleFormat::Srt:
+		return ".srt";
+	case SubtitleFormat::WebVtt:
+		return ".vtt";
+	case SubtitleFormat::Binary:
+		return ".keys";
+	case SubtitleFormat::Off:
+		break;
+	}
+	return "";
+}
+
+SubtitleWriter::~SubtitleWriter()
+{
+	stop(hotkeyCoreTimeNs());
+}
+
+bool SubtitleWriter::start(FILE *outputFile, SubtitleFormat outputFormat, uint64_t recordingStart)
+{
+	stop(recordingStart);
+	if (!outputFile || outputFormat == SubtitleFormat::Off) {
+		if (outputFile) {
+			fclose(outputFile);
+		}
+		return false;
+	}
+
+	file = outputFile;
+	format = outputFormat;
+	setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+
+	hasPendingCue = false;
+	cueIndex = 0;
+	buffer.clear();
+	buffer.reserve(FILE_BUFFER_SIZE);
+	writeBatch.reserve(MAX_QUEUED_CUES);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.clear();
+		queue.reserve(MAX_QUEUED_CUES);
+		startTime = recordingStart;
+		pausedTotal = 0;
+		pauseStart = 0;
+		stopOffset = 0;
+		droppedCues = 0;
+		stopping = false;
+		active = true;
+	}
+
+	thread = std::thread(&SubtitleWriter::run, this);
+	return true;
+}
+
+uint64_t SubtitleWriter::stop(uint64_t stopTime)
+{
+	uint64_t dropped;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!active) {
+			return 0;
+		}
+		uint64_t end = pauseStart ? pauseStart : stopTime;
+		stopOffset = end > startTime + pausedTotal ? end - startTime - pausedTotal : 0;
+		active = false;
+		stopping = true;
+		dropped = droppedCues;
+	}
+
+	wakeCondition.notify_one();
+	if (thread.joinable()) {
+		thread.join();
+	}
+
+	fclose(file);
+	file = nullptr;
+	return dropped;
+}
+
+bool SubtitleWriter::isActive() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return active;
+}
+
+void SubtitleWriter::pause(uint64_t time)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (active && !pauseStart) {
+		pauseStart = time;
+	}
+}
+
+void SubtitleWriter::resume(uint64_t time)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (active && pauseStart) {
+		pausedTotal += time > pauseStart ? time - pauseStart : 0;
+		pauseStart = 0;
+	}
+}
+
+void SubtitleWriter::push(const ChordEvent &chord, uint64_t displayTimeNs)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Nothing shown while paused ends up in the recording
+		if (!active || pauseStart || chord.timestamp < startTime + pausedTotal) {
+			return;
+		}
+		if (queue.size() >= MAX_QUEUED_CUES) {
+			droppedCues++;
+			return;
+		}
+
+		queue.emplace_back();
+		Cue &cue = queue.back();
+		cue.start = chord.timestamp - startTime - pausedTotal;
+		cue.end = cue.start + displayTimeNs;
+		cue.kind = chord.kind;
+		cue.replacesPrevious = chord.replacesPrevious;
+		cue.keyCount = (uint8_t)std::min(chord.keyCount, MAX_COMBINATION_KEYS);
+		memcpy(cue.keys, chord.keys, cue.keyCount * sizeof(int));
+		formatChordDisplay(chord, cue.text);
+	}
+	wakeCondition.notify_one();
+}
+
+void SubtitleWriter::run()
+{
+	if (format == SubtitleFormat::WebVtt) {
+		buffer += "WEBVTT\n\n";
+	} else if (format == SubtitleFormat::Binary) {
+		buffer.append(SUBTITLE_BINARY_MAGIC, sizeof(SUBTITLE_BINARY_MAGIC));
+	}
+
+	bool unflushed = false;
+	auto lastFlush = std::chrono::steady_clock::now();
+	for (;;) {
+		bool finishing;
+		uint64_t finalOffset;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCondition.wait_for(lock, FLUSH_INTERVAL, [this]() { return stopping || !queue.empty(); });
+			writeBatch.swap(queue);
+			finishing = stopping;
+			finalOffset = stopOffset;
+		}
+
+		for (const Cue &cue : writeBatch) {
+			if (cue.replacesPrevious && hasPendingCue) {
+				// Same entry with a newer count: keep its start, stay up for the on-screen time
+				pendingCue.text = cue.text;
+				pendingCue.end = std::max(pendingCue.end, cue.end);
+				continue;
+			}
+			if (hasPendingCue) {
+				pendingCue.end = std::min(pendingCue.end, cue.start);
+				writeCue(pendingCue);
+			}
+			pendingCue = cue;
+			hasPendingCue = true;
+		}
+		writeBatch.clear();
+
+		if (finishing && hasPendingCue) {
+			pendingCue.end = std::max(pendingCue.start, std::min(pendingCue.end, finalOffset));
+			writeCue(pendingCue);
+			hasPendingCue = false;
+		}
+
+		if (!buffer.empty()) {
+			fwrite(buffer.data(), 1, buffer.size(), file);
+			buffer.clear();
+			unflushed = true;
+		}
+
+		// stdio buffers the writes; push them out every FLUSH_INTERVAL so a crash loses little
+		auto now = std::chrono::steady_clock::now();
+		if (finishing || (unflushed && now - lastFlush >= FLUSH_INTERVAL)) {
+			fflush(file);
+			unflushed = false;
+			lastFlush = now;
+		}
+		if (finishing) {
+			return;
+		}
+	}
+}
+
+void SubtitleWriter::writeCue(const Cue &cue)
+{
+	switch (format) {
+	case SubtitleFormat::Srt:
+		buffer += std::to_string(++cueIndex);
+		buffer += '\n';
+		appendTimestamp(buffer, cue.start, ',');
+		buffer += " --> ";
+		appendTimestamp(buffer, cue.end, ',');
+		buffer += '\n';
+		buffer.append(cue.text.c_str(), cue.text.size());
+		buffer += "\n\n";
+		break;
+	case SubtitleFormat::WebVtt:
+		appendTimestamp(buffer, cue.start, '.');
+		buffer += " --> ";
+		appendTimestamp(buffer, cue.end, '.');
+		buffer += '\n';
+		appendVttText(buffer, cue.text.view());
+		buffer += "\n\n";
+		break;
+	case SubtitleFormat::Binary:
+		appendLittleEndian<uint64_t>(buffer, cue.start);
+		appendLittleEndian<uint32_t>(buffer, (uint32_t)((cue.end - cue.start) / 1000000));
+		appendLittleEndian<uint8_t>(buffer, (uint8_t)cue.kind);
+		appendLittleEndian<uint8_t>(buffer, cue.keyCount);
+		appendLittleEndian<uint16_t>(buffer, (uint16_t)cue.text.size());
+		for (size_t i = 0; i < cue.keyCount; i++) {
+			appendLittleEndian<uint32_t>(buffer, (uint32_t)cue.keys[i]);
+		}
+		buffer.append(cue.text.c_str(), cue.text.size());
+		break;
+	case SubtitleFormat::Off:
+		break;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_SUBTITLES_HPP
+#define STREAMUP_HOTKEY_CORE_SUBTITLES_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "streamup-hotkey-core-chord.hpp"
+
+enum class SubtitleFormat : uint8_t {
+	Off, // Not "None", which X11 defines as a macro
+	Srt,
+	WebVtt,
+	Binary,
+};
+
+// File extension for a format, including the dot (".srt", ".vtt", ".keys")
+const char *subtitleFileExtension(SubtitleFormat format);
+
+// Binary sidecar layout (little endian): the 8-byte magic "SUHKSUB1", then one record per cue:
+//   uint64 start (ns from recording start), uint32 duration (ms), uint8 kind (ChordKind),
+//   uint8 keyCount, uint16 textLength, int32 keys[keyCount], char text[textLength] (no NUL)
+constexpr char SUBTITLE_BINARY_MAGIC[8] = {'S', 'U', 'H', 'K', 'S', 'U', 'B', '1'};
+
+// Writes a sidecar of every shown chord for one recording. Cue times are relative to the
+// recording start with paused spans cut out; a cue lasts the on-screen time or until the next
+// chord, whichever comes first. A chord with replacesPrevious updates the last cue's text and
+// extends it instead of starting a new one. push() only appends to a queue, formatting and disk I/O happen
+// on the writer's own thread. All times are hotkeyCoreTimeNs().
+class SubtitleWriter {
+public:
+	~SubtitleWriter();
+
+	// Takes ownership of file (closed by stop())
+	bool start(FILE *file, SubtitleFormat format, uint64_t startTime);
+	// Writes the last cue, flushes and closes the file. Returns the number of cues dropped
+	// because the writer fell behind.
+	uint64_t stop(uint64_t stopTime);
+	bool isActive() const;
+
+	void pause(uint64_t time);
+	void resume(uint64_t time);
+
+	// Called for every shown chord (dispatcher thread); never touches the disk
+	void push(const ChordEvent &chord, uint64_t displayTimeNs);
+
+private:
+	struct Cue {
+		uint64_t start = 0; // Offset into the recording
+		uint64_t end = 0;
+		ChordKind kind = ChordKind::Keyboard;
+		bool replacesPrevious = false;
+		uint8_t keyCount = 0;
+		int keys[MAX_COMBINATION_KEYS];
+		ChordText text;
+	};
+
+	static constexpr size_t MAX_QUEUED_CUES = 1024;
+
+	void run();
+	void writeCue(const Cue &cue);
+
+	FILE *file = nullptr;
+	SubtitleFormat format = SubtitleFormat::Off;
+	std::thread thread;
+
+	mutable std::mutex mutex; // Protects everything below
+	std::condition_variable wakeCondition;
+	bool active = false;
+	bool stopping = false;
+	uint64_t startTime = 0;
+	uint64_t pausedTotal = 0;
+	uint64_t pauseStart = 0; // Non-zero while paused
+	uint64_t stopOffset = 0;
+	std::vector<Cue> queue;
+	uint64_t droppedCues = 0;
+
+	// Writer thread only
+	std::vector<Cue> writeBatch;
+	bool hasPendingCue = false;
+	Cue pendingCue; // Last cue; its end is known once the next one arrives
+	size_t cueIndex = 0;
+	std::string buffer;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_SUBTITLES_HPP
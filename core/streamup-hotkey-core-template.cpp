@@ -0,0 +1,277 @@
+#include "streamup-hotkey-core-template.hpp"
+#include <charconv>
+
+namespace {
+
+struct FieldName {
+	std::string_view name;
+	TemplateField field;
+};
+
+constexpr FieldName FIELD_NAMES[] = {
+	{"text", TemplateField::Text},     {"combo", TemplateField::Combo},      {"count", TemplateField::Count},
+	{"action", TemplateField::Action}, {"app", TemplateField::App},          {"held_ms", TemplateField::HeldMs},
+	{"apm", TemplateField::Apm},
+};
+
+bool lookupField(std::string_view name, TemplateField &field)
+{
+	for (const FieldName &entry : FIELD_NAMES) {
+		if (entry.name == name) {
+			field = entry.field;
+			return true;
+		}
+	}
+	return false;
+}
+
+void appendNumber(std::string &out, int64_t value)
+{
+	char digits[24];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+	out.append(digits, (size_t)(result.ptr - digits));
+}
+
+bool fail(std::string &error, size_t position, const std::string &message)
+{
+	error = "column " + std::to_string(position + 1) + ": " + message;
+	return false;
+}
+
+} // namespace
+
+void TemplateValues::assign(const ChordEvent &chord, std::string_view profilePrefix, std::string_view application)
+{
+	std::string_view chordText = chord.text.view();
+	combo.assign(chordText);
+	if (chord.repeatCount > 1) {
+		// Drop the " ×N" the coalescer appended
+		size_t countStart = chordText.rfind(" \xC3\x97"); // " ×"
+		if (countStart != std::string_view::npos) {
+			combo.resize(countStart);
+		}
+	}
+
+	text.assign(profilePrefix);
+	text.append(chordText);
+	if (!chord.action.empty()) {
+		text.append(" (");
+		text.append(chord.action.view());
+		text.append(")");
+	}
+
+	action.assign(chord.action.view());
+	app.assign(application);
+	count = chord.repeatCount;
+	heldMs = -1;
+}
+
+bool OutputTemplate::compile(std::string_view source, std::string &error)
+{
+	clear();
+
+	// Sections still open, as the index of their skip op
+	std::vector<size_t> sections;
+	std::string literal;
+
+	size_t i = 0;
+	while (i < source.size()) {
+		char c = source[i];
+		if (c == '}') {
+			// "}}" is the escaped form; a lone '}' is taken literally as well
+			literal.push_back('}');
+			i += i + 1 < source.size() && source[i + 1] == '}' ? 2 : 1;
+			continue;
+		}
+		if (c != '{') {
+			literal.push_back(c);
+			i++;
+			continue;
+		}
+		if (i + 1 < source.size() && source[i + 1] == '{') {
+			literal.push_back('{');
+			i += 2;
+			continue;
+		}
+
+		size_t close = source.find('}', i + 1);
+		if (close == std::string_view::npos) {
+			clear();
+			return fail(error, i, "'{' is never closed (write {{ for a literal brace)");
+		}
+		std::string_view tag = source.substr(i + 1, close - i - 1);
+
+		addLiteral(literal);
+		literal.clear();
+
+		char marker = tag.empty() ? '\0' : tag[0];
+		std::string_view name = marker == '?' || marker == '!' || marker == '/' ? tag.substr(1) : tag;
+		TemplateField field = TemplateField::Text;
+		if (marker == '/') {
+			if (sections.empty()) {
+				clear();
+				return fail(error, i, "{" + std::string(tag) + "} closes no section");
+			}
+			const Op &opened = ops[sections.back()];
+			if (!name.empty() && (!lookupField(name, field) || field != opened.field)) {
+				clear();
+				return fail(error, i, "{" + std::string(tag) + "} does not close the innermost section");
+			}
+			ops[sections.back()].offset = (uint32_t)ops.size();
+			sections.pop_back();
+		} else if (!lookupField(name, field)) {
+			clear();
+			return fail(error, i, "unknown field {" + std::string(tag) + "}");
+		} else if (marker == '?' || marker == '!') {
+			sections.push_back(ops.size());
+			addField(marker == '?' ? OpCode::SkipUnset : OpCode::SkipSet, field);
+		} else {
+			addField(OpCode::Field, field);
+		}
+		i = close + 1;
+	}
+
+	if (!sections.empty()) {
+		clear();
+		return fail(error, source.size(), "a section is never closed");
+	}
+	addLiteral(literal);
+	return true;
+}
+
+void OutputTemplate::compileAffixes(std::string_view prefix, std::string_view suffix)
+{
+	clear();
+	addLiteral(prefix);
+	addField(OpCode::Field, TemplateField::Text);
+	addLiteral(suffix);
+}
+
+void OutputTemplate::render(const TemplateValues &values, std::string &out) const
+{
+	out.clear();
+	size_t i = 0;
+	while (i < ops.size()) {
+		const Op &op = ops[i];
+		switch (op.code) {
+		case OpCode::Literal:
+			out.append(literals, op.offset, op.length);
+			break;
+		case OpCode::Field:
+			switch (op.field) {
+			case TemplateField::Text:
+				out.append(values.text);
+				break;
+			case TemplateField::Combo:
+				out.append(values.combo);
+				break;
+			case TemplateField::Count:
+				appendNumber(out, values.count);
+				break;
+			case TemplateField::Action:
+				out.append(values.action);
+				break;
+			case TemplateField::App:
+				out.append(values.app);
+				break;
+			case TemplateField::HeldMs:
+				if (values.heldMs >= 0) {
+					appendNumber(out, values.heldMs);
+				}
+				break;
+			case TemplateField::Apm:
+				appendNumber(out, values.apm);
+				break;
+			}
+			break;
+		case OpCode::SkipUnset:
+			if (!isSet(values, op.field)) {
+				i = op.offset;
+				continue;
+			}
+			break;
+		case OpCode::SkipSet:
+			if (isSet(values, op.field)) {
+				i = op.offset;
+				continue;
+			}
+			break;
+		}
+		i++;
+	}
+}
+
+void OutputTemplate::clear()
+{
+	ops.clear();
+	literals.clear();
+	fieldMask = 0;
+}
+
+void OutputTemplate::addLiteral(std::string_view text)
+{
+	if (text.empty()) {
+		return;
+	}
+	ops.push_back({OpCode::Literal, TemplateField::Text, (uint32_t)literals.size(), (uint32_t)text.size()});
+	literals.append(text);
+}
+
+void OutputTemplate::addField(OpCode code, TemplateField field)
+{
+	ops.push_back({code, field, 0, 0});
+	fieldMask |= 1u << (unsigned)field;
+}
+
+bool OutputTemplate::isSet(const TemplateValues &values, TemplateField field)
+{
+	switch (field) {
+	case TemplateField::Text:
+		return !values.text.empty();
+	case TemplateField::Combo:
+		return !values.combo.empty();
+	case TemplateField::Count:
+		return values.count > 1;
+	case TemplateField::Action:
+		return !values.action.empty();
+	case TemplateField::App:
+		return !values.app.empty();
+	case TemplateField::HeldMs:
+		return values.heldMs >= 0;
+	case TemplateField::Apm:
+		return values.apm > 0;
+	}
+	return false;
+}
+
+void ChordRateMeter::add(uint64_t timestamp)
+{
+	advance(timestamp / 1000000000ull);
+	buckets[currentSecond % buckets.size()]++;
+	total++;
+}
+
+uint32_t ChordRateMeter::perMinute(uint64_t now)
+{
+	advance(now / 1000000000ull);
+	return total;
+}
+
+void ChordRateMeter::advance(uint64_t second)
+{
+	if (second <= currentSecond) {
+		return;
+	}
+	if (second - currentSecond >= buckets.size()) {
+		buckets.fill(0);
+		total = 0;
+	} else {
+		// Empty the buckets of the seconds that passed, oldest first
+		for (uint64_t s = currentSecond + 1; s <= second; s++) {
+			uint32_t &bucket = buckets[s % buckets.size()];
+			total -= bucket;
+			bucket = 0;
+		}
+	}
+	currentSecond = second;
+}
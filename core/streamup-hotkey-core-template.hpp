@@ -0,0 +1,100 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_CORE_TEMPLATE_HPP
+#define STREAMUP_HOTKEY_CORE_TEMPLATE_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "streamup-hotkey-core-chord.hpp"
+
+enum class TemplateField : uint8_t {
+	Text,   // {text}: what the dock shows, e.g. "VS Code: Ctrl + Scroll Up ×3 (Zoom In)"
+	Combo,  // {combo}: just the chord, "Ctrl + Scroll Up"
+	Count,  // {count}: merged repeats, 1 for a single chord
+	Action, // {action}: what the chord does, usually empty
+	App,    // {app}: window class of the active capture profile, empty outside of one
+	HeldMs, // {held_ms}: how long the chord was held, known once its first key goes up
+	Apm,    // {apm}: chords shown in the last minute
+};
+
+// Everything a template can show for one chord. Strings keep their capacity when a value is
+// assigned over them, so the values of the next chord are copied in without allocating.
+struct TemplateValues {
+	std::string text;
+	std::string combo;
+	std::string action;
+	std::string app;
+	uint32_t count = 1;
+	int64_t heldMs = -1; // -1 while the chord is still held
+	uint32_t apm = 0;
+
+	void assign(const ChordEvent &chord, std::string_view profilePrefix, std::string_view application);
+};
+
+// Output text compiled from a template such as
+//
+//   {combo}{?count} x{count}{/count}{?action} - {action}{/action}
+//
+// A field in braces is replaced by its value. {?field}...{/field} keeps what it encloses only when
+// the field is set (non-empty text, a count above 1, a known held time, a non-zero rate) and
+// {!field}...{/field} only when it is not; sections nest, and {/} closes the innermost one. {{ and }}
+// are literal braces. Compiling turns the template into a flat op list over one literal pool;
+// render() walks it and appends to the caller's string, which stops allocating once it has grown
+// to fit the longest output.
+class OutputTemplate {
+public:
+	// On failure the template renders nothing and error is "column N: ..."
+	bool compile(std::string_view source, std::string &error);
+
+	// prefix + {text} + suffix, both taken literally. The template of targets without one.
+	void compileAffixes(std::string_view prefix, std::string_view suffix);
+
+	void render(const TemplateValues &values, std::string &out) const;
+
+	bool uses(TemplateField field) const { return (fieldMask & (1u << (unsigned)field)) != 0; }
+
+private:
+	enum class OpCode : uint8_t {
+		Literal,   // Appends literals[offset, offset + length)
+		Field,     // Appends the field's value
+		SkipUnset, // Jumps past the section when the field is not set
+		SkipSet,   // Jumps past the section when the field is set
+	};
+
+	struct Op {
+		OpCode code;
+		TemplateField field;
+		uint32_t offset; // Literal: start in the pool. Skips: index of the op after the section.
+		uint32_t length;
+	};
+
+	void clear();
+	void addLiteral(std::string_view text);
+	void addField(OpCode code, TemplateField field);
+
+	static bool isSet(const TemplateValues &values, TemplateField field);
+
+	std::vector<Op> ops;
+	std::string literals;
+	uint32_t fieldMask = 0;
+};
+
+// Chords per minute over a sliding window of one-second buckets. Not thread-safe.
+class ChordRateMeter {
+public:
+	void add(uint64_t timestamp);
+	uint32_t perMinute(uint64_t now);
+
+private:
+	void advance(uint64_t second);
+
+	std::array<uint32_t, 60> buckets{};
+	uint64_t currentSecond = 0;
+	uint32_t total = 0;
+};
+
+#endif // STREAMUP_HOTKEY_CORE_TEMPLATE_HPP
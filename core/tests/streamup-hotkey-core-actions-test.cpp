@@ -0,0 +1,235 @@
+// Builds shortcut dictionaries, loads them back through the memory-mapped reader and looks every
+// entry up, then checks that truncated and corrupt files are refused.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "streamup-hotkey-core-actions.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+
+namespace {
+
+constexpr size_t GENERATED_APPLICATIONS = 20;
+constexpr size_t GENERATED_CHORDS_PER_APPLICATION = 250;
+
+int failures = 0;
+std::string dictionaryPath;
+
+void fail(const std::string &message)
+{
+	fprintf(stderr, "FAILED: %s\n", message.c_str());
+	failures++;
+}
+
+bool writeFile(std::string_view contents)
+{
+	FILE *file = fopen(dictionaryPath.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+	return fclose(file) == 0 && written;
+}
+
+void expectLabel(const ActionDictionary &dictionary, std::string_view chord, std::string_view application,
+		 std::string_view expected)
+{
+	std::string_view label = dictionary.lookup(hashChordText(chord), application);
+	if (label != expected) {
+		fail("'" + std::string(chord) + "' in '" + std::string(application) + "' is '" + std::string(label) +
+		     "' instead of '" + std::string(expected) + "'");
+	}
+}
+
+void testSource()
+{
+	const std::string_view source = "# Editor shortcuts\n"
+					"Ctrl + Shift + P = Command Palette\n"
+					"Ctrl  +  S = Save\r\n"
+					"Ctrl + = = Zoom In\n"
+					"\n"
+					"[Code]\n"
+					"Ctrl + S = Save All\n"
+					"Ctrl + K = Chord prefix\n"
+					"no separator\n"
+					"[unterminated\n"
+					"Ctrl + E=Edit\n"
+					"[*]\n"
+					"Ctrl + Q = Quit\n";
+
+	std::vector<std::string> errors;
+	std::vector<ActionDictionaryEntry> entries = parseActionDictionarySource(source, &errors);
+	if (entries.size() != 6 || errors.size() != 3 || errors[0] != "line 9: expected 'chord = action'" ||
+	    errors[1] != "line 10: unterminated section name" || errors[2] != "line 11: expected 'chord = action'") {
+		fail("source parsed into " + std::to_string(entries.size()) + " entries and " +
+		     std::to_string(errors.size()) + " errors");
+		for (const std::string &error : errors) {
+			fprintf(stderr, "  %s\n", error.c_str());
+		}
+		return;
+	}
+
+	std::string contents;
+	if (!buildActionDictionary(entries, contents) || !writeFile(contents)) {
+		fail("could not build the dictionary of the source");
+		return;
+	}
+
+	ActionDictionary dictionary;
+	if (!dictionary.open(dictionaryPath) || dictionary.entryCount() != 6) {
+		fail("could not open the dictionary of the source");
+		return;
+	}
+
+	// Chords are normalised, the last " = " separates the label, applications match in any case
+	// and fall back to the global entries
+	expectLabel(dictionary, "Ctrl + Shift + P", {}, "Command Palette");
+	expectLabel(dictionary, "Ctrl + S", {}, "Save");
+	expectLabel(dictionary, "Ctrl + =", {}, "Zoom In");
+	expectLabel(dictionary, "Ctrl + S", "code", "Save All");
+	expectLabel(dictionary, "Ctrl + S", "CODE", "Save All");
+	expectLabel(dictionary, "Ctrl + S", "gimp", "Save");
+	expectLabel(dictionary, "Ctrl + Shift + P", "code", "Command Palette");
+	expectLabel(dictionary, "Ctrl + K", "code", "Chord prefix");
+	expectLabel(dictionary, "Ctrl + K", {}, "");
+	expectLabel(dictionary, "Ctrl + Q", {}, "Quit");
+	expectLabel(dictionary, "Ctrl + Shift + Q", {}, "");
+}
+
+std::string generatedApplication(size_t index)
+{
+	return index == 0 ? std::string() : "app" + std::to_string(index);
+}
+
+std::string generatedChord(size_t index)
+{
+	static const char *const modifiers[] = {"Ctrl", "Alt", "Ctrl + Shift", "Ctrl + Alt", "Win"};
+	return std::string(modifiers[index % 5]) + " + F" + std::to_string(index / 5 + 1);
+}
+
+// Thousands of entries across applications, with duplicates that replace earlier ones
+void testRoundTrip(std::string &contents)
+{
+	std::vector<ActionDictionaryEntry> entries;
+	for (size_t application = 0; application < GENERATED_APPLICATIONS; application++) {
+		for (size_t chord = 0; chord < GENERATED_CHORDS_PER_APPLICATION; chord++) {
+			entries.push_back({generatedApplication(application), generatedChord(chord),
+					   "Old " + std::to_string(application) + "/" + std::to_string(chord)});
+		}
+	}
+	for (size_t application = 0; application < GENERATED_APPLICATIONS; application++) {
+		for (size_t chord = 0; chord < GENERATED_CHORDS_PER_APPLICATION; chord += 2) {
+			entries.push_back({generatedApplication(application), generatedChord(chord),
+					   "Action " + std::to_string(application) + "/" + std::to_string(chord)});
+		}
+	}
+
+	if (!buildActionDictionary(entries, contents) || !writeFile(contents)) {
+		fail("could not build the generated dictionary");
+		return;
+	}
+
+	ActionDictionary dictionary;
+	if (!dictionary.open(dictionaryPath) ||
+	    dictionary.entryCount() != GENERATED_APPLICATIONS * GENERATED_CHORDS_PER_APPLICATION) {
+		fail("could not open the generated dictionary");
+		return;
+	}
+
+	int wrong = 0;
+	for (size_t application = 0; application < GENERATED_APPLICATIONS; application++) {
+		for (size_t chord = 0; chord < GENERATED_CHORDS_PER_APPLICATION; chord++) {
+			std::string expected = (chord % 2 == 0 ? "Action " : "Old ") + std::to_string(application) + "/" +
+					       std::to_string(chord);
+			std::string chordText = generatedChord(chord);
+			if (dictionary.lookup(hashChordText(chordText), generatedApplication(application)) != expected) {
+				wrong++;
+			}
+		}
+	}
+	// Unknown applications use the global entries, unknown chords have no label
+	expectLabel(dictionary, generatedChord(1), "unknown", "Old 0/1");
+	expectLabel(dictionary, "Ctrl + F999", "app3", "");
+
+	if (wrong > 0) {
+		fail(std::to_string(wrong) + " generated entries were not found");
+	}
+}
+
+void expectRefused(const std::string &contents, const std::string &what)
+{
+	ActionDictionary dictionary;
+	if (!writeFile(contents)) {
+		fail("could not write the " + what + " file");
+	} else if (dictionary.open(dictionaryPath)) {
+		fail("the " + what + " file was loaded");
+	} else if (dictionary.isOpen() || !dictionary.lookup(hashChordText("Ctrl + F1")).empty()) {
+		fail("the refused " + what + " file left the dictionary open");
+	}
+}
+
+template<typename T> std::string withField(const std::string &contents, size_t offset, T value)
+{
+	std::string changed = contents;
+	memcpy(&changed[offset], &value, sizeof(value));
+	return changed;
+}
+
+void testCorruptFiles(const std::string &contents)
+{
+	if (contents.size() <= sizeof(ActionDictionaryHeader)) {
+		fail("no dictionary to corrupt");
+		return;
+	}
+
+	expectRefused(std::string(), "empty");
+	expectRefused(contents.substr(0, sizeof(ActionDictionaryHeader) - 1), "truncated header");
+	expectRefused(contents.substr(0, sizeof(ActionDictionaryHeader)), "header-only");
+	expectRefused(contents.substr(0, contents.size() / 2), "half");
+	expectRefused(contents.substr(0, contents.size() - 1), "one byte short");
+
+	std::string badMagic = contents;
+	badMagic[0] = 'X';
+	expectRefused(badMagic, "bad magic");
+	expectRefused(withField<uint32_t>(contents, offsetof(ActionDictionaryHeader, version), ACTION_DICTIONARY_VERSION + 1),
+		      "future version");
+	expectRefused(withField<uint32_t>(contents, offsetof(ActionDictionaryHeader, bucketCount), 0), "bucketless");
+	expectRefused(withField<uint32_t>(contents, offsetof(ActionDictionaryHeader, slotCount), UINT32_MAX),
+		      "oversized slot count");
+	expectRefused(withField<uint64_t>(contents, offsetof(ActionDictionaryHeader, slotsOffset),
+					  (uint64_t)contents.size() + 16),
+		      "slots past the end");
+	expectRefused(withField<uint64_t>(contents, offsetof(ActionDictionaryHeader, slotsOffset), 4), "misaligned");
+
+	// Offsets that wrap around when the size is added to them
+	expectRefused(withField<uint64_t>(contents, offsetof(ActionDictionaryHeader, seedsOffset), UINT64_MAX - 3),
+		      "wrapping seeds offset");
+	expectRefused(withField<uint64_t>(contents, offsetof(ActionDictionaryHeader, labelsSize), UINT64_MAX - 8),
+		      "wrapping labels size");
+}
+
+} // namespace
+
+int main()
+{
+	dictionaryPath = (std::filesystem::temp_directory_path() / "streamup-hotkey-core-actions-test.bin").string();
+
+	testSource();
+	std::string contents;
+	testRoundTrip(contents);
+	testCorruptFiles(contents);
+
+	std::error_code ignored;
+	std::filesystem::remove(dictionaryPath, ignored);
+
+	if (failures > 0) {
+		fprintf(stderr, "%d dictionary checks failed\n", failures);
+		return 1;
+	}
+	printf("All dictionary checks passed\n");
+	return 0;
+}
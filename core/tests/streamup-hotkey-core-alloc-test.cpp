@@ -0,0 +1,452 @@
+// Drives chords through HotkeyEngine -> ChordDispatcher -> ChordCoalescer -> ChordEventBus into
+// the core's own sinks (the socket and HTTP servers with a client each, the shared-memory ring
+// and the subtitle writer) and fails if anything on that path, including the servers' and the
+// subtitle writer's threads, touches the heap once it is warmed up. Every operator new is counted,
+// and on glibc malloc/calloc/realloc as well. Sinks of the plugin itself (the obs-websocket
+// events, the dock) are outside of it.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "streamup-hotkey-core-bus.hpp"
+#include "streamup-hotkey-core-coalesce.hpp"
+#include "streamup-hotkey-core-dispatcher.hpp"
+#include "streamup-hotkey-core-engine.hpp"
+#include "streamup-hotkey-core-subtitles.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "streamup-hotkey-core-http.hpp"
+#include "streamup-hotkey-core-socket.hpp"
+#endif
+
+#ifdef __linux__
+#include "streamup-hotkey-core-shm.hpp"
+#endif
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<uint64_t> allocations{0};
+
+void countAllocation()
+{
+	if (counting.load(std::memory_order_relaxed)) {
+		allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+} // namespace
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+	countAllocation();
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	countAllocation();
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+	countAllocation();
+	return __libc_realloc(pointer, size);
+}
+}
+#endif
+
+void *operator new(size_t size)
+{
+	countAllocation();
+	if (void *pointer = std::malloc(size ? size : 1)) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	countAllocation();
+	return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace {
+
+// Key codes of the fake keyboard: two modifiers and 26 letters
+constexpr int KEY_CTRL = 1;
+constexpr int KEY_SHIFT = 2;
+constexpr int KEY_FIRST_LETTER = 10;
+constexpr int LETTER_COUNT = 26;
+
+constexpr int WARMUP_ROUNDS = 200;
+constexpr int MEASURED_ROUNDS = 5000;
+constexpr int ROUNDS_PER_DRAIN = 16; // Keeps every round's events well inside the dispatcher ring
+
+constexpr std::string_view LETTER_NAMES[LETTER_COUNT] = {"A", "B", "C", "D", "E", "F", "G", "H", "I",
+							 "J", "K", "L", "M", "N", "O", "P", "Q", "R",
+							 "S", "T", "U", "V", "W", "X", "Y", "Z"};
+
+KeyInfo classifyKey(int keyCode)
+{
+	KeyInfo key;
+	if (keyCode == KEY_CTRL) {
+		key.classes = KEY_CLASS_MODIFIER;
+		key.modifierRank = MODIFIER_RANK_CTRL;
+	} else if (keyCode == KEY_SHIFT) {
+		key.classes = KEY_CLASS_MODIFIER | KEY_CLASS_SHIFT;
+		key.modifierRank = MODIFIER_RANK_SHIFT;
+	} else if (keyCode >= KEY_FIRST_LETTER && keyCode < KEY_FIRST_LETTER + LETTER_COUNT) {
+		key.classes = KEY_CLASS_LETTER;
+	}
+	return key;
+}
+
+std::string_view keyName(int keyCode)
+{
+	if (keyCode == KEY_CTRL) {
+		return "Ctrl";
+	}
+	if (keyCode == KEY_SHIFT) {
+		return "Shift";
+	}
+	if (keyCode >= KEY_FIRST_LETTER && keyCode < KEY_FIRST_LETTER + LETTER_COUNT) {
+		return LETTER_NAMES[keyCode - KEY_FIRST_LETTER];
+	}
+	return "Unknown";
+}
+
+ChordEventBus eventBus;
+std::atomic<uint64_t> keyChords{0};
+std::atomic<uint64_t> releases{0};
+std::atomic<uint64_t> mouseChords{0};
+
+void countingSink(const ChordEvent &chord, void *)
+{
+	switch (chord.kind) {
+	case ChordKind::Keyboard:
+		keyChords.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case ChordKind::Release:
+		releases.fetch_add(1, std::memory_order_relaxed);
+		break;
+	default:
+		mouseChords.fetch_add(1, std::memory_order_relaxed);
+		break;
+	}
+}
+
+SubtitleWriter subtitleWriter;
+
+void subtitleSink(const ChordEvent &chord, void *)
+{
+	subtitleWriter.push(chord, 2000000000ull);
+}
+
+#ifndef _WIN32
+ChordSocketServer socketServer(keyName);
+ChordHttpServer httpServer(keyName);
+
+void socketSink(const ChordEvent &chord, void *)
+{
+	socketServer.publish(chord);
+}
+
+void httpSink(const ChordEvent &chord, void *)
+{
+	httpServer.publish(chord);
+}
+
+// Reads everything a server sends until it closes the connection
+struct StreamClient {
+	int fd = -1;
+	std::atomic<uint64_t> receivedBytes{0};
+	std::thread thread;
+
+	void start(int connectedFd)
+	{
+		fd = connectedFd;
+		thread = std::thread([this] {
+			char buffer[4096];
+			ssize_t received;
+			while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+				receivedBytes.fetch_add((uint64_t)received, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	void join()
+	{
+		if (thread.joinable()) {
+			thread.join();
+		}
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+};
+
+StreamClient socketClient;
+StreamClient httpClient;
+
+bool connectSocketClient(const std::string &path)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+	if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return false;
+	}
+	socketClient.start(fd);
+	return true;
+}
+
+bool connectHttpClient(uint16_t port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return false;
+	}
+	const char request[] = "GET /events HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+	if (send(fd, request, sizeof(request) - 1, 0) != (ssize_t)(sizeof(request) - 1)) {
+		close(fd);
+		return false;
+	}
+	httpClient.start(fd);
+	return true;
+}
+
+// Some port in the dynamic range that is free
+bool startHttpServer()
+{
+	for (uint16_t port = 49152 + (uint16_t)(getpid() % 8192); port < 65535; port++) {
+		if (httpServer.start(port, "alloc test") && connectHttpClient(port)) {
+			return true;
+		}
+		httpServer.stop();
+	}
+	return false;
+}
+#endif
+
+#ifdef __linux__
+ShmRingWriter sharedEventRing;
+
+void sharedRingSink(const ChordEvent &chord, void *)
+{
+	uint8_t flags = chord.replacesPrevious ? SHM_RECORD_REPLACES_PREVIOUS : 0;
+	sharedEventRing.write((uint8_t)chord.kind, flags, chord.timestamp, chord.keys, chord.keyCount, chord.text.c_str(),
+			      chord.text.size());
+}
+#endif
+
+// Bytes the slower of the two clients has been sent
+uint64_t servedBytes()
+{
+#ifndef _WIN32
+	return std::min(socketClient.receivedBytes.load(), httpClient.receivedBytes.load());
+#else
+	return UINT64_MAX;
+#endif
+}
+
+void publishToBus(const ChordEvent &chord)
+{
+	eventBus.publish(chord);
+}
+
+ChordCoalescer coalescer(publishToBus);
+
+void dispatchChord(const ChordEvent &chord)
+{
+	coalescer.push(chord, hotkeyCoreTimeNs());
+}
+
+uint64_t flushChords(uint64_t now)
+{
+	return coalescer.flush(now);
+}
+
+// Ctrl + letter, Ctrl + Shift + letter with an autorepeat, and a few Ctrl + scroll notches
+void runRound(HotkeyEngine &engine, int round)
+{
+	int letter = KEY_FIRST_LETTER + round % LETTER_COUNT;
+
+	engine.keyEvent(KEY_CTRL, true, false, hotkeyCoreTimeNs());
+	engine.keyEvent(letter, true, false, hotkeyCoreTimeNs());
+	engine.keyEvent(letter, true, true, hotkeyCoreTimeNs());
+	engine.keyEvent(letter, false, false, hotkeyCoreTimeNs());
+
+	engine.keyEvent(KEY_SHIFT, true, false, hotkeyCoreTimeNs());
+	engine.keyEvent(letter, true, false, hotkeyCoreTimeNs());
+	engine.keyEvent(letter, false, false, hotkeyCoreTimeNs());
+	engine.keyEvent(KEY_SHIFT, false, false, hotkeyCoreTimeNs());
+
+	for (int notch = 0; notch < 3; notch++) {
+		engine.mouseAction(" + Scroll Up", hotkeyCoreTimeNs(), true);
+	}
+	engine.keyEvent(KEY_CTRL, false, false, hotkeyCoreTimeNs());
+}
+
+void runRounds(HotkeyEngine &engine, ChordDispatcher &dispatcher, int first, int count)
+{
+	for (int round = first; round < first + count; round++) {
+		runRound(engine, round);
+		if ((round + 1) % ROUNDS_PER_DRAIN == 0) {
+			dispatcher.quiesce();
+		}
+	}
+	dispatcher.quiesce();
+}
+
+} // namespace
+
+int main()
+{
+	ChordDispatcher &dispatcher = chordDispatcher();
+	HotkeyEngine engine(classifyKey, keyName, dispatcher);
+	coalescer.setWindow(400);
+	eventBus.subscribe(countingSink, nullptr);
+
+	if (!subtitleWriter.start(tmpfile(), SubtitleFormat::Srt, hotkeyCoreTimeNs())) {
+		fprintf(stderr, "FAILED: could not open the subtitle file\n");
+		return 1;
+	}
+	eventBus.subscribe(subtitleSink, nullptr);
+
+#ifndef _WIN32
+	std::string socketPath = "/tmp/streamup-hotkey-core-alloc-test-" + std::to_string(getpid()) + ".sock";
+	if (!socketServer.start(socketPath) || !connectSocketClient(socketPath) || !startHttpServer()) {
+		fprintf(stderr, "FAILED: could not set up the socket and HTTP servers\n");
+		return 1;
+	}
+	eventBus.subscribe(socketSink, nullptr);
+	eventBus.subscribe(httpSink, nullptr);
+#endif
+
+#ifdef __linux__
+	std::string ringName = "/streamup-hotkey-core-alloc-test-" + std::to_string(getpid());
+	if (!sharedEventRing.open(ringName)) {
+		fprintf(stderr, "FAILED: could not create the shared-memory ring\n");
+		return 1;
+	}
+	eventBus.subscribe(sharedRingSink, nullptr);
+#endif
+
+	dispatcher.start(dispatchChord, flushChords);
+
+	// Thread start-up, first-use statics, connection setup and the like may allocate
+	runRounds(engine, dispatcher, 0, WARMUP_ROUNDS);
+	auto servedDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	// Until both clients have been sent events, so their connections are set up
+	while (servedBytes() == 0 && std::chrono::steady_clock::now() < servedDeadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		runRounds(engine, dispatcher, 0, ROUNDS_PER_DRAIN);
+	}
+	if (servedBytes() == 0) {
+		fprintf(stderr, "FAILED: the socket and HTTP clients were never sent an event\n");
+		return 1;
+	}
+	// Lets the servers' and the subtitle writer's threads finish the warm-up events
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	uint64_t warmupChords = keyChords.load();
+	uint64_t warmupReleases = releases.load();
+	uint64_t warmupMouseChords = mouseChords.load();
+	uint64_t warmupServedBytes = servedBytes();
+
+	counting = true;
+	runRounds(engine, dispatcher, WARMUP_ROUNDS, MEASURED_ROUNDS);
+	// Same for the measured events, which have to be handled while counting
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	counting = false;
+	bool clientsServed = servedBytes() > warmupServedBytes;
+
+	uint64_t dropped = dispatcher.stop();
+	subtitleWriter.stop(hotkeyCoreTimeNs());
+#ifndef _WIN32
+	socketServer.stop();
+	httpServer.stop();
+	socketClient.join();
+	httpClient.join();
+#endif
+#ifdef __linux__
+	sharedEventRing.close();
+#endif
+	uint64_t measuredChords = keyChords.load() - warmupChords;
+	uint64_t measuredReleases = releases.load() - warmupReleases;
+	uint64_t measuredMouseChords = mouseChords.load() - warmupMouseChords;
+	uint64_t allocationCount = allocations.load();
+
+	printf("%llu key chords, %llu releases and %llu mouse entries dispatched, %llu dropped, %llu allocations\n",
+	       (unsigned long long)measuredChords, (unsigned long long)measuredReleases,
+	       (unsigned long long)measuredMouseChords, (unsigned long long)dropped, (unsigned long long)allocationCount);
+
+	// Each round shows Ctrl + letter, Ctrl + Shift and Ctrl + Shift + letter. Only the letter
+	// chords are released while still shown; Ctrl + Shift is replaced before Shift goes up.
+	bool passed = allocationCount == 0 && dropped == 0 && measuredChords == 3ull * MEASURED_ROUNDS &&
+		      measuredReleases == 2ull * MEASURED_ROUNDS && clientsServed;
+	if (!passed) {
+		fprintf(stderr, "FAILED: the capture-to-sink path allocated, lost events or served no client\n");
+		return 1;
+	}
+	return 0;
+}
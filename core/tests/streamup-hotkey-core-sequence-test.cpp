@@ -0,0 +1,193 @@
+// Feeds chord streams to the multi-stroke sequence matcher and checks which sequences complete,
+// including step timeouts, restarts on a chord that breaks the prefix and shared prefixes.
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "streamup-hotkey-core-sequence.hpp"
+
+namespace {
+
+constexpr uint64_t MS = 1000000ull;
+constexpr size_t GENERATED_SEQUENCES = 500;
+
+int failures = 0;
+
+ChordEvent makeChord(std::string_view text, uint64_t timeMs, ChordKind kind = ChordKind::Keyboard)
+{
+	ChordEvent chord;
+	chord.kind = kind;
+	chord.timestamp = timeMs * MS;
+	chord.text.assign(text);
+	chord.hash = hashChordText(text);
+	return chord;
+}
+
+struct Step {
+	std::string_view text;
+	uint64_t timeMs;
+	ChordKind kind = ChordKind::Keyboard;
+};
+
+// Feeds the steps in order; expected is the text of every completion, joined with " | "
+void expectCompletions(SequenceMatcher &matcher, const char *name, const std::vector<Step> &steps,
+		       std::string_view expected, std::string_view expectedAction = {})
+{
+	std::string completions;
+	std::string lastAction;
+	for (const Step &step : steps) {
+		ChordEvent completed;
+		if (!matcher.feed(makeChord(step.text, step.timeMs, step.kind), completed)) {
+			continue;
+		}
+		if (completed.hash != hashChordText(completed.text.view()) || completed.timestamp != step.timeMs * MS) {
+			fprintf(stderr, "FAILED: %s: completion '%s' has the wrong hash or time\n", name, completed.text.c_str());
+			failures++;
+		}
+		if (!completions.empty()) {
+			completions += " | ";
+		}
+		completions.append(completed.text.view());
+		lastAction.assign(completed.action.view());
+	}
+
+	if (completions != expected || lastAction != expectedAction) {
+		fprintf(stderr, "FAILED: %s: completed '%s' (%s) instead of '%.*s' (%.*s)\n", name, completions.c_str(),
+			lastAction.c_str(), (int)expected.size(), expected.data(), (int)expectedAction.size(),
+			expectedAction.data());
+		failures++;
+	}
+	matcher.reset();
+}
+
+void testParse()
+{
+	std::vector<SequenceDefinition> definitions = parseSequenceDefinitions("# Emacs\n"
+									       "Ctrl + X, Ctrl + S = Save\r\n"
+									       "\n"
+									       "Ctrl  +  K,Ctrl + C\n"
+									       "Ctrl + X, Ctrl + = = Zoom\n"
+									       " , \n");
+	bool parsed = definitions.size() == 3 && definitions[0].steps.size() == 2 &&
+		      definitions[0].steps[1] == "Ctrl + S" && definitions[0].action == "Save" &&
+		      definitions[1].steps.size() == 2 && definitions[1].steps[0] == "Ctrl + K" &&
+		      definitions[1].action.empty() && definitions[2].steps[1] == "Ctrl + =" &&
+		      definitions[2].action == "Zoom";
+	if (!parsed) {
+		fprintf(stderr, "FAILED: sequence definitions parsed into %zu entries\n", definitions.size());
+		failures++;
+	}
+}
+
+void testMatching()
+{
+	SequenceMatcher matcher;
+	matcher.compile(parseSequenceDefinitions("Ctrl + X, Ctrl + S = Save\n"
+						 "Ctrl + K, Ctrl + C = Comment\n"
+						 "Ctrl + K, Ctrl + C, Ctrl + C = Comment Block\n"
+						 "G, G = Top\n"
+						 "Ctrl + X, Ctrl + S = Save File\n"));
+	if (matcher.sequenceCount() != 4) {
+		fprintf(stderr, "FAILED: %zu sequences compiled instead of 4\n", matcher.sequenceCount());
+		failures++;
+	}
+
+	// Later duplicates replace the action
+	expectCompletions(matcher, "two steps", {{"Ctrl + X", 0}, {"Ctrl + S", 100}}, "Ctrl + X, Ctrl + S", "Save File");
+
+	// A step that comes too late restarts matching, and the late chord is tried as a first step
+	expectCompletions(matcher, "step timeout", {{"Ctrl + X", 0}, {"Ctrl + S", 1600}}, "");
+	expectCompletions(matcher, "timeout then match", {{"Ctrl + X", 0}, {"Ctrl + X", 1600}, {"Ctrl + S", 3000}},
+			  "Ctrl + X, Ctrl + S", "Save File");
+
+	// The timeout is per step, not for the whole sequence
+	expectCompletions(matcher, "slow sequence", {{"Ctrl + K", 0}, {"Ctrl + C", 1400}, {"Ctrl + C", 2800}},
+			  "Ctrl + K, Ctrl + C | Ctrl + K, Ctrl + C, Ctrl + C", "Comment Block");
+
+	// A chord that does not continue the prefix aborts it, and may start another sequence
+	expectCompletions(matcher, "restart", {{"Ctrl + X", 0}, {"Ctrl + K", 100}, {"Ctrl + C", 200}}, "Ctrl + K, Ctrl + C",
+			  "Comment");
+	expectCompletions(matcher, "broken prefix", {{"Ctrl + X", 0}, {"A", 100}, {"Ctrl + S", 200}}, "");
+
+	// Releases are ignored, mouse actions break the prefix
+	expectCompletions(matcher, "release", {{"Ctrl + X", 0}, {"Ctrl + X", 50, ChordKind::Release}, {"Ctrl + S", 100}},
+			  "Ctrl + X, Ctrl + S", "Save File");
+	expectCompletions(matcher, "mouse", {{"Ctrl + X", 0}, {"Ctrl + Scroll Up", 50, ChordKind::Scroll}, {"Ctrl + S", 100}},
+			  "");
+
+	// A completed sequence without longer ones starts over, so the same steps complete it again
+	expectCompletions(matcher, "repeat", {{"G", 0}, {"G", 100}, {"G", 200}, {"G", 300}}, "G, G | G, G", "Top");
+
+	// reset() forgets the prefix
+	ChordEvent completed;
+	matcher.feed(makeChord("Ctrl + X", 0), completed);
+	matcher.reset();
+	if (matcher.feed(makeChord("Ctrl + S", 100), completed)) {
+		fprintf(stderr, "FAILED: a sequence completed across reset()\n");
+		failures++;
+	}
+
+	matcher.setStepTimeout(100);
+	expectCompletions(matcher, "shorter timeout", {{"Ctrl + X", 0}, {"Ctrl + S", 150}}, "");
+	expectCompletions(matcher, "within shorter timeout", {{"Ctrl + X", 0}, {"Ctrl + S", 90}}, "Ctrl + X, Ctrl + S",
+			  "Save File");
+
+	// Recompiling drops the partial match
+	matcher.setStepTimeout(SequenceMatcher::DEFAULT_STEP_TIMEOUT_MS);
+	matcher.feed(makeChord("Ctrl + X", 0), completed);
+	matcher.compile(parseSequenceDefinitions("Ctrl + X, Ctrl + S = Save\n"));
+	if (matcher.feed(makeChord("Ctrl + S", 100), completed)) {
+		fprintf(stderr, "FAILED: a sequence completed across compile()\n");
+		failures++;
+	}
+
+	matcher.compile({});
+	expectCompletions(matcher, "no sequences", {{"Ctrl + X", 0}, {"Ctrl + S", 100}}, "");
+}
+
+// Hundreds of sequences sharing first steps
+void testManySequences()
+{
+	std::vector<SequenceDefinition> definitions;
+	for (size_t i = 0; i < GENERATED_SEQUENCES; i++) {
+		definitions.push_back({{"Ctrl + F" + std::to_string(i % 12 + 1), "Alt + " + std::to_string(i)},
+				       "Action " + std::to_string(i)});
+	}
+
+	SequenceMatcher matcher;
+	matcher.compile(definitions);
+
+	int wrong = 0;
+	for (size_t i = 0; i < GENERATED_SEQUENCES; i++) {
+		ChordEvent completed;
+		std::string first = "Ctrl + F" + std::to_string(i % 12 + 1);
+		std::string second = "Alt + " + std::to_string(i);
+		bool early = matcher.feed(makeChord(first, i * 10), completed);
+		bool done = matcher.feed(makeChord(second, i * 10 + 5), completed);
+		if (early || !done || completed.action.view() != "Action " + std::to_string(i) ||
+		    completed.text.view() != first + ", " + second) {
+			wrong++;
+		}
+	}
+	if (matcher.sequenceCount() != GENERATED_SEQUENCES || wrong > 0) {
+		fprintf(stderr, "FAILED: %d of %zu generated sequences did not complete\n", wrong, GENERATED_SEQUENCES);
+		failures++;
+	}
+}
+
+} // namespace
+
+int main()
+{
+	testParse();
+	testMatching();
+	testManySequences();
+
+	if (failures > 0) {
+		fprintf(stderr, "%d sequence checks failed\n", failures);
+		return 1;
+	}
+	printf("All sequence checks passed\n");
+	return 0;
+}
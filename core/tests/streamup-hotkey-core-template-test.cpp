@@ -0,0 +1,153 @@
+// Compiles output templates and checks what they render, and that malformed templates are
+// rejected with the column of the mistake.
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "streamup-hotkey-core-template.hpp"
+
+namespace {
+
+int failures = 0;
+
+void expectRender(std::string_view source, const TemplateValues &values, std::string_view expected)
+{
+	OutputTemplate output;
+	std::string error;
+	if (!output.compile(source, error)) {
+		fprintf(stderr, "FAILED: '%.*s' did not compile: %s\n", (int)source.size(), source.data(), error.c_str());
+		failures++;
+		return;
+	}
+
+	std::string rendered;
+	output.render(values, rendered);
+	if (rendered != expected) {
+		fprintf(stderr, "FAILED: '%.*s' rendered '%s' instead of '%.*s'\n", (int)source.size(), source.data(),
+			rendered.c_str(), (int)expected.size(), expected.data());
+		failures++;
+	}
+}
+
+void expectError(std::string_view source, std::string_view expected)
+{
+	OutputTemplate output;
+	std::string error;
+	bool compiled = output.compile(source, error);
+
+	// A template that failed to compile renders nothing
+	std::string rendered = "stale";
+	TemplateValues values;
+	values.text = "Ctrl + C";
+	output.render(values, rendered);
+
+	if (compiled || error != expected || !rendered.empty() || output.uses(TemplateField::Text)) {
+		fprintf(stderr, "FAILED: '%.*s' gave '%s' instead of '%.*s'\n", (int)source.size(), source.data(),
+			compiled ? "no error" : error.c_str(), (int)expected.size(), expected.data());
+		failures++;
+	}
+}
+
+TemplateValues valuesOf(std::string_view combo, uint32_t count, std::string_view action, std::string_view app)
+{
+	TemplateValues values;
+	values.combo = combo;
+	values.text = combo;
+	values.count = count;
+	values.action = action;
+	values.app = app;
+	return values;
+}
+
+void testRender()
+{
+	const std::string_view counted = "{combo}{?count} x{count}{/count}{?action} - {action}{/action}";
+	expectRender(counted, valuesOf("Ctrl + C", 1, "", ""), "Ctrl + C");
+	expectRender(counted, valuesOf("Ctrl + C", 3, "Copy", ""), "Ctrl + C x3 - Copy");
+
+	// Nested sections, closed by name and by {/}
+	const std::string_view nested = "{?app}[{app}{?action}: {action}{/}] {/app}{combo}";
+	expectRender(nested, valuesOf("Ctrl + S", 1, "Save", "code"), "[code: Save] Ctrl + S");
+	expectRender(nested, valuesOf("Ctrl + S", 1, "", "code"), "[code] Ctrl + S");
+	expectRender(nested, valuesOf("Ctrl + S", 1, "Save", ""), "Ctrl + S");
+
+	// Inverted sections, and a held time that is unknown until the chord is released
+	TemplateValues held = valuesOf("Space", 1, "", "");
+	expectRender("{combo} {!held_ms}held{/held_ms}{?held_ms}{held_ms} ms{/held_ms}", held, "Space held");
+	held.heldMs = 250;
+	expectRender("{combo} {!held_ms}held{/held_ms}{?held_ms}{held_ms} ms{/held_ms}", held, "Space 250 ms");
+
+	// Escaped braces, and a lone closing brace taken literally
+	expectRender("{{combo}} {combo} }} }", valuesOf("A", 1, "", ""), "{combo} A } }");
+	expectRender("{apm}/min", TemplateValues(), "0/min");
+	expectRender("", valuesOf("A", 1, "", ""), "");
+
+	// Rendering replaces whatever the buffer held
+	OutputTemplate affixes;
+	affixes.compileAffixes("[", "]");
+	std::string rendered = "previous text";
+	affixes.render(valuesOf("Alt + Tab", 1, "", ""), rendered);
+	if (rendered != "[Alt + Tab]" || !affixes.uses(TemplateField::Text) || affixes.uses(TemplateField::Combo)) {
+		fprintf(stderr, "FAILED: affixes rendered '%s'\n", rendered.c_str());
+		failures++;
+	}
+}
+
+void testErrors()
+{
+	expectError("abc {combo", "column 5: '{' is never closed (write {{ for a literal brace)");
+	expectError("{combo} {nope}", "column 9: unknown field {nope}");
+	expectError("{}", "column 1: unknown field {}");
+	expectError("{/count}", "column 1: {/count} closes no section");
+	expectError("{?count}{?action}x{/count}{/action}", "column 19: {/count} does not close the innermost section");
+	expectError("{?count}x", "column 10: a section is never closed");
+}
+
+void testValues()
+{
+	ChordEvent chord;
+	chord.text.assign("Ctrl + Scroll Up \xC3\x97" "3"); // "×3", split so the 3 is not read as a hex digit
+	chord.action.assign("Zoom In");
+	chord.repeatCount = 3;
+
+	TemplateValues values;
+	values.heldMs = 100;
+	values.assign(chord, "code: ", "code");
+	if (values.combo != "Ctrl + Scroll Up" || values.text != "code: Ctrl + Scroll Up \xC3\x97" "3 (Zoom In)" ||
+	    values.action != "Zoom In" || values.app != "code" || values.count != 3 || values.heldMs != -1) {
+		fprintf(stderr, "FAILED: values of a merged chord are '%s' / '%s'\n", values.combo.c_str(), values.text.c_str());
+		failures++;
+	}
+}
+
+void testRateMeter()
+{
+	constexpr uint64_t SECOND = 1000000000ull;
+	ChordRateMeter meter;
+	for (int i = 0; i < 10; i++) {
+		meter.add(100 * SECOND + (uint64_t)i * SECOND / 2);
+	}
+	uint32_t withinMinute = meter.perMinute(150 * SECOND);
+	uint32_t afterMinute = meter.perMinute(165 * SECOND);
+	if (withinMinute != 10 || afterMinute != 0) {
+		fprintf(stderr, "FAILED: rate meter counted %u and then %u chords\n", withinMinute, afterMinute);
+		failures++;
+	}
+}
+
+} // namespace
+
+int main()
+{
+	testRender();
+	testErrors();
+	testValues();
+	testRateMeter();
+
+	if (failures > 0) {
+		fprintf(stderr, "%d template checks failed\n", failures);
+		return 1;
+	}
+	printf("All template checks passed\n");
+	return 0;
+}
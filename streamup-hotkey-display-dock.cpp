@@ -1,10 +1,14 @@
 #include "streamup-hotkey-display-dock.hpp"
 #include "streamup-hotkey-display-settings.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+#include "streamup-hotkey-core-engine.hpp"
 #include <obs.h>
 #include <QIcon>
+#include <QScrollBar>
 #include <QStyle>
 #include <QToolButton>
 #include <QThread>
+#include <utility>
 #include <obs-module.h>
 
 #ifdef _WIN32
@@ -35,20 +39,29 @@ extern void stopLinuxKeyboardHook();
 #endif
 
 extern obs_data_t *SaveLoadSettingsCallback(obs_data_t *save_data, bool saving);
+extern ChordLog chordLog;
+extern HotkeyEngine hotkeyEngine;
+
+// How often the open history view picks up new combinations, and how long typing pauses before it filters
+constexpr int HISTORY_REFRESH_INTERVAL_MS = 100;
+constexpr int HISTORY_FILTER_DELAY_MS = 150;
 
 HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 	: QFrame(parent),
 	  layout(new QVBoxLayout(this)),
 	  toolbar(new QToolBar(this)),
-	  label(new QLabel(this)),
+	  keycapDisplay(new KeycapDisplay(this)),
 	  toggleAction(new QAction(this)),
 	  settingsAction(new QAction(this)),
+	  historyAction(new QAction(this)),
+	  historyPanel(new QWidget(this)),
+	  historySearch(new QLineEdit(historyPanel)),
+	  historyView(new QListView(historyPanel)),
+	  historyModel(new ChordHistoryModel(chordLog, this)),
+	  historyTimer(new QTimer(this)),
+	  historyFilterTimer(new QTimer(this)),
 	  hookEnabled(false),
-	  sceneName(StyleConstants::DEFAULT_SCENE_NAME),
-	  textSource(StyleConstants::DEFAULT_TEXT_SOURCE),
 	  onScreenTime(StyleConstants::DEFAULT_ONSCREEN_TIME),
-	  prefix(""),
-	  suffix(""),
 	  clearTimer(new QTimer(this)),
 	  displayInTextSource(false)
 {
@@ -56,7 +69,7 @@ HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 	setObjectName("hotkeyDisplayDock");
 	layout->setObjectName("hotkeyDisplayLayout");
 	toolbar->setObjectName("hotkeyDisplayToolbar");
-	label->setObjectName("hotkeyDisplayLabel");
+	keycapDisplay->setObjectName("hotkeyDisplayKeycaps");
 
 	// Set frame properties (matching OBS dock structure)
 	setContentsMargins(0, 0, 0, 0);
@@ -67,48 +80,48 @@ HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 	layout->setContentsMargins(0, 0, 0, 0);
 	layout->setSpacing(0);
 
-	// Add top spacing (8px above label)
+	// Add top spacing (8px above the display)
 	layout->addSpacing(8);
 
-	// Create a horizontal layout to add left/right margins to the label only
-	QHBoxLayout *labelLayout = new QHBoxLayout();
-	labelLayout->setObjectName("hotkeyDisplayLabelLayout");
-	labelLayout->setContentsMargins(8, 0, 8, 0); // 8px left and right margins
-	labelLayout->setSpacing(0);
-
-	label->setAlignment(Qt::AlignCenter);
-	label->setFrameShape(QFrame::NoFrame);
-	label->setFrameShadow(QFrame::Plain);
-	label->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
-	label->setMinimumHeight(50);
-	label->setWordWrap(true);
-	label->setProperty("hotkeyState", "inactive");
-
-	// Use theme-aware styling
-	label->setStyleSheet(
-		"QLabel[hotkeyState=\"active\"] {"
-		"  border: 2px solid palette(highlight);"
-		"  border-radius: 4px;"
-		"  padding: 10px;"
-		"  font-size: 14pt;"
-		"  background: palette(base);"
-		"}"
-		"QLabel[hotkeyState=\"inactive\"] {"
-		"  border: 2px solid palette(mid);"
-		"  border-radius: 4px;"
-		"  padding: 10px;"
-		"  font-size: 14pt;"
-		"  background: palette(base);"
-		"}"
-	);
-
-	// Add label to the horizontal layout
-	labelLayout->addWidget(label);
-
-	// Add the label layout to main layout with stretch factor 1 (expands to fill space)
-	layout->addLayout(labelLayout, 1);
-
-	// Add spacing between label and toolbar (8px)
+	// Create a horizontal layout to add left/right margins to the display only
+	QHBoxLayout *displayLayout = new QHBoxLayout();
+	displayLayout->setObjectName("hotkeyDisplayKeycapsLayout");
+	displayLayout->setContentsMargins(8, 0, 8, 0); // 8px left and right margins
+	displayLayout->setSpacing(0);
+
+	keycapDisplay->setMinimumHeight(50);
+
+	// Add the display to the horizontal layout
+	displayLayout->addWidget(keycapDisplay);
+
+	// Add the display layout to main layout with stretch factor 1 (expands to fill space)
+	layout->addLayout(displayLayout, 1);
+
+	// History panel, hidden until toggled: a search field above a list of every combination shown
+	historyPanel->setObjectName("hotkeyDisplayHistoryPanel");
+	QVBoxLayout *historyLayout = new QVBoxLayout(historyPanel);
+	historyLayout->setContentsMargins(8, 8, 8, 0);
+	historyLayout->setSpacing(4);
+
+	historySearch->setObjectName("hotkeyDisplayHistorySearch");
+	historySearch->setPlaceholderText(obs_module_text("Dock.History.Search"));
+	historySearch->setClearButtonEnabled(true);
+	historySearch->setAccessibleName(obs_module_text("Dock.History.Search"));
+
+	// Uniform item sizes let the view skip measuring rows, which keeps 100k+ entries cheap to scroll
+	historyView->setObjectName("hotkeyDisplayHistoryView");
+	historyView->setModel(historyModel);
+	historyView->setUniformItemSizes(true);
+	historyView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	historyView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+	historyView->setAccessibleName(obs_module_text("Dock.History.Title"));
+
+	historyLayout->addWidget(historySearch);
+	historyLayout->addWidget(historyView, 1);
+	historyPanel->setVisible(false);
+	layout->addWidget(historyPanel, 2);
+
+	// Add spacing between display and toolbar (8px)
 	layout->addSpacing(8);
 
 	// Configure toolbar (matching OBS style)
@@ -130,13 +143,20 @@ HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 	settingsAction->setProperty("themeID", "configIconSmall");
 	settingsAction->setProperty("class", "icon-gear");
 
-	// Set accessible properties for the display label
-	label->setAccessibleName(obs_module_text("Dock.Description"));
-	label->setAccessibleDescription(obs_module_text("Dock.Label.Idle"));
+	// Configure history action
+	historyAction->setObjectName("hotkeyDisplayHistoryAction");
+	historyAction->setText(obs_module_text("Dock.Button.History"));
+	historyAction->setToolTip(obs_module_text("Dock.Tooltip.History"));
+	historyAction->setCheckable(true);
+
+	// Set accessible properties for the display
+	keycapDisplay->setAccessibleName(obs_module_text("Dock.Description"));
+	keycapDisplay->setAccessibleDescription(obs_module_text("Dock.Label.Idle"));
 
 	// Add actions to toolbar
 	toolbar->addAction(toggleAction);
 	toolbar->addSeparator();
+	toolbar->addAction(historyAction);
 	toolbar->addAction(settingsAction);
 
 	// Copy dynamic properties from actions to widgets (OBS pattern)
@@ -168,6 +188,16 @@ HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 		}
 	}
 
+	// Configure history button to show text (it has no themed icon)
+	QWidget *historyWidget = toolbar->widgetForAction(historyAction);
+	if (historyWidget) {
+		QToolButton *historyToolButton = qobject_cast<QToolButton *>(historyWidget);
+		if (historyToolButton) {
+			historyToolButton->setToolButtonStyle(Qt::ToolButtonTextOnly);
+			historyToolButton->setObjectName("hotkeyDisplayHistoryButton");
+		}
+	}
+
 	// Set object name for settings button widget
 	QWidget *settingsWidget = toolbar->widgetForAction(settingsAction);
 	if (settingsWidget) {
@@ -182,63 +212,164 @@ HotkeyDisplayDock::HotkeyDisplayDock(QWidget *parent)
 	connect(toggleAction, &QAction::triggered, this, &HotkeyDisplayDock::toggleKeyboardHook);
 	connect(settingsAction, &QAction::triggered, this, &HotkeyDisplayDock::openSettings);
 	connect(clearTimer, &QTimer::timeout, this, &HotkeyDisplayDock::clearDisplay);
-
-	// Load current settings
-	obs_data_t *settings = SaveLoadSettingsCallback(nullptr, false);
-	if (settings) {
-		sceneName = QString::fromUtf8(obs_data_get_string(settings, "sceneName"));
-		textSource = QString::fromUtf8(obs_data_get_string(settings, "textSource"));
-		onScreenTime = obs_data_get_int(settings, "onScreenTime");
-		prefix = QString::fromUtf8(obs_data_get_string(settings, "prefix"));
-		suffix = QString::fromUtf8(obs_data_get_string(settings, "suffix"));
-		displayInTextSource = obs_data_get_bool(settings, "displayInTextSource");
-		hookEnabled = obs_data_get_bool(settings, "hookEnabled");
-
-		// Use helper function to enable hooks if configured
-		if (hookEnabled) {
-			if (enableHooks()) {
-				updateUIState(true);
-			} else {
-				hookEnabled = false;
-				updateUIState(false);
-			}
+	connect(&sceneSourceIndex, &SceneSourceIndex::sceneIndexed, this, &HotkeyDisplayDock::onSceneIndexed);
+
+	// New rows arrive in batches from the refresh timer (or a finished filter scan)
+	historyTimer->setInterval(HISTORY_REFRESH_INTERVAL_MS);
+	historyFilterTimer->setSingleShot(true);
+	historyFilterTimer->setInterval(HISTORY_FILTER_DELAY_MS);
+	connect(historyAction, &QAction::toggled, this, &HotkeyDisplayDock::toggleHistory);
+	connect(historyTimer, &QTimer::timeout, historyModel, &ChordHistoryModel::refresh);
+	connect(historySearch, &QLineEdit::textChanged, historyFilterTimer, [this]() { historyFilterTimer->start(); });
+	connect(historyFilterTimer, &QTimer::timeout, this, [this]() { historyModel->setFilter(historySearch->text()); });
+	connect(historyModel, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+		QScrollBar *scrollBar = historyView->verticalScrollBar();
+		historyFollowsTail = scrollBar->value() == scrollBar->maximum();
+	});
+	connect(historyModel, &QAbstractItemModel::rowsInserted, this, [this]() {
+		if (historyFollowsTail) {
+			historyView->scrollToBottom();
 		}
+	});
 
-		obs_data_release(settings);
-	} else {
-		sceneName = StyleConstants::DEFAULT_SCENE_NAME;
-		textSource = StyleConstants::DEFAULT_TEXT_SOURCE;
-		onScreenTime = StyleConstants::DEFAULT_ONSCREEN_TIME;
-		prefix = "";
-		suffix = "";
-		displayInTextSource = false;
-	}
+	// Settings are applied by obs_module_load, which reads them once for the whole plugin
 }
 
-HotkeyDisplayDock::~HotkeyDisplayDock() {}
+HotkeyDisplayDock::~HotkeyDisplayDock()
+{
+	releaseOutputTargets();
+}
 
-void HotkeyDisplayDock::setLog(const QString &log)
+void HotkeyDisplayDock::setLog(const TemplateValues &chord)
 {
-	// Always update the dock's label
-	label->setText(log);
+	// Always update the dock's display
+	keycapDisplay->setChord(QString::fromUtf8(chord.text.data(), (int)chord.text.size()));
 
-	// Conditionally update the text source based on the setting
+	// Conditionally mirror the combination to every output target on the next video frame
 	if (displayInTextSource) {
-		if (sceneName == StyleConstants::DEFAULT_SCENE_NAME || textSource == StyleConstants::DEFAULT_TEXT_SOURCE || textSource.isEmpty()) {
-			blog(LOG_WARNING,
-			     "[StreamUP Hotkey Display] Scene or text source is not selected or invalid. Skipping text update.");
-			return;
-		}
+		outputOverlay.show(chord);
+	}
+
+	// Restart the timer with the on-screen time value
+	clearTimer->start(onScreenTime);
+}
+
+void HotkeyDisplayDock::setHeldTime(int64_t heldMs)
+{
+	if (displayInTextSource) {
+		outputOverlay.setHeldTime(heldMs);
+	}
+}
+
+void HotkeyDisplayDock::postChord(const ChordEvent &chord, std::string_view profilePrefix, std::string_view application,
+				  uint32_t apm)
+{
+	bool alreadyQueued;
+	{
+		std::lock_guard<std::mutex> lock(postedMutex);
+		postedValues.assign(chord, profilePrefix, application);
+		postedValues.apm = apm;
+		postedChordPending = true;
+		postedHeldPending = false; // A held time posted earlier belongs to the chord this replaces
+		alreadyQueued = postedDrainQueued;
+		postedDrainQueued = true;
+	}
+	queuePostedDrain(alreadyQueued);
+}
+
+void HotkeyDisplayDock::postHeldTime(int64_t heldMs)
+{
+	bool alreadyQueued;
+	{
+		std::lock_guard<std::mutex> lock(postedMutex);
+		postedHeldMs = heldMs;
+		postedHeldPending = true;
+		alreadyQueued = postedDrainQueued;
+		postedDrainQueued = true;
+	}
+	queuePostedDrain(alreadyQueued);
+}
 
-		if (textSource != StyleConstants::NO_TEXT_SOURCE) {
-			updateTextSource(log);
+void HotkeyDisplayDock::queuePostedDrain(bool alreadyQueued)
+{
+	if (!alreadyQueued) {
+		QMetaObject::invokeMethod(this, [this]() { drainPosted(); }, Qt::QueuedConnection);
+	}
+}
+
+void HotkeyDisplayDock::drainPosted()
+{
+	bool chordPending;
+	bool heldPending;
+	int64_t heldMs;
+	{
+		std::lock_guard<std::mutex> lock(postedMutex);
+		chordPending = postedChordPending;
+		heldPending = postedHeldPending;
+		heldMs = postedHeldMs;
+		postedChordPending = false;
+		postedHeldPending = false;
+		postedDrainQueued = false;
+		if (chordPending) {
+			std::swap(postedValues, drainedValues);
 		}
+	}
 
-		showSource();
+	if (chordPending) {
+		setLog(drainedValues);
+	}
+	if (heldPending) {
+		setHeldTime(heldMs);
 	}
+}
 
-	// Restart the timer with the on-screen time value
-	clearTimer->start(onScreenTime);
+void HotkeyDisplayDock::showMessage(const QString &message)
+{
+	clearTimer->stop();
+	keycapDisplay->setMessage(message);
+}
+
+void HotkeyDisplayDock::setStartingState()
+{
+	const char *labelDesc = obs_module_text("Dock.Label.Starting");
+
+	// Capture is deferred until OBS has finished loading; block toggling until it reports back
+	toggleAction->setChecked(true);
+	toggleAction->setEnabled(false);
+	toggleAction->setText(obs_module_text("Dock.Button.Starting"));
+
+	keycapDisplay->setMessage(QString::fromUtf8(labelDesc));
+	keycapDisplay->setState(KeycapDisplay::State::Starting);
+	keycapDisplay->setAccessibleDescription(labelDesc);
+}
+
+void HotkeyDisplayDock::startDeferredCapture()
+{
+	if (!enableHooks()) {
+		onCaptureStarted(false);
+		return;
+	}
+
+#ifndef __linux__
+	onCaptureStarted(true);
+#endif
+	// On Linux the hook thread reports back once the X connection and keymap are ready
+}
+
+void HotkeyDisplayDock::onCaptureStarted(bool success)
+{
+	toggleAction->setEnabled(true);
+	if (keycapDisplay->state() == KeycapDisplay::State::Starting) {
+		keycapDisplay->clear();
+	}
+
+	if (!success) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Key capture failed to start");
+		disableHooks();
+	}
+
+	hookEnabled = success;
+	updateUIState(success);
 }
 
 void HotkeyDisplayDock::toggleKeyboardHook()
@@ -252,6 +383,7 @@ void HotkeyDisplayDock::toggleKeyboardHook()
 		// Enable hooks
 		if (enableHooks()) {
 			hookEnabled = true;
+			resolveOutputTargets();
 			updateUIState(true);
 		} else {
 			// Failed to enable, revert action state
@@ -292,145 +424,72 @@ void HotkeyDisplayDock::openSettings()
 		// Update the dock's settings after applying new settings
 		obs_data_t *settings = SaveLoadSettingsCallback(nullptr, false);
 		if (settings) {
-			sceneName = QString::fromUtf8(obs_data_get_string(settings, "sceneName"));
-			textSource = QString::fromUtf8(obs_data_get_string(settings, "textSource"));
+			setOutputTargets(loadOutputTargets(settings));
 			onScreenTime = obs_data_get_int(settings, "onScreenTime");
-			prefix = QString::fromUtf8(obs_data_get_string(settings, "prefix"));
-			suffix = QString::fromUtf8(obs_data_get_string(settings, "suffix"));
 			obs_data_release(settings);
 		}
+		resolveOutputTargets();
 	}
 
 	delete settingsDialog;
 }
 
+void HotkeyDisplayDock::toggleHistory(bool visible)
+{
+	historyPanel->setVisible(visible);
+	if (visible) {
+		historyModel->refresh();
+		historyView->scrollToBottom();
+		historyTimer->start();
+	} else {
+		historyTimer->stop();
+	}
+}
+
 void HotkeyDisplayDock::clearDisplay()
 {
-	label->clear();
-	hideSource();
 	resetToListeningState(); // Reset to listening state after clearing the display
 }
 
-void HotkeyDisplayDock::updateTextSource(const QString &text)
+void HotkeyDisplayDock::setOutputTargets(const std::vector<OutputTargetConfig> &targets)
 {
-	if (!displayInTextSource || sceneName == StyleConstants::DEFAULT_SCENE_NAME || textSource.isEmpty() ||
-	    textSource == StyleConstants::NO_TEXT_SOURCE) {
-		blog(LOG_WARNING,
-		     "[StreamUP Hotkey Display] Scene or text source is not selected or invalid. Skipping text update.");
-		return;
-	}
-
-	if (sceneAndSourceExist() && !textSource.isEmpty()) {
-		obs_source_t *source = obs_get_source_by_name(textSource.toUtf8().constData());
-		if (source) {
-			obs_data_t *settings = obs_source_get_settings(source);
-			QString formattedText = prefix + text + suffix;
-			obs_data_set_string(settings, "text", formattedText.toUtf8().constData());
-			obs_source_update(source, settings);
-			obs_data_release(settings);
-			obs_source_release(source);
-		} else {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Source '%s' not found!", textSource.toUtf8().constData());
-		}
-	} else {
-		blog(LOG_WARNING, "[StreamUP Hotkey Display] Text source is empty or does not exist!");
-	}
+	outputOverlay.setTargets(targets);
 }
 
-void HotkeyDisplayDock::showSource()
+std::vector<OutputTargetConfig> HotkeyDisplayDock::getOutputTargetConfigs() const
 {
-	if (!displayInTextSource) {
-		return;
-	}
-
-	if (sceneName == StyleConstants::DEFAULT_SCENE_NAME || textSource.isEmpty() || textSource == StyleConstants::NO_TEXT_SOURCE) {
-		blog(LOG_WARNING,
-		     "[StreamUP Hotkey Display] Scene or text source is not selected or invalid. Skipping show source.");
-		return;
-	}
-
-	if (sceneAndSourceExist()) {
-		obs_source_t *scene = obs_get_source_by_name(sceneName.toUtf8().constData());
-		if (scene) {
-			obs_scene_t *sceneAsScene = obs_scene_from_source(scene);
-			obs_sceneitem_t *item = obs_scene_find_source(sceneAsScene, textSource.toUtf8().constData());
-			if (item) {
-				obs_sceneitem_set_visible(item, true);
-			} else {
-				blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene item '%s' not found in scene '%s'!",
-				     textSource.toUtf8().constData(), sceneName.toUtf8().constData());
-			}
-			obs_source_release(scene);
-		} else {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene '%s' not found!", sceneName.toUtf8().constData());
-		}
-	} else {
-		blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene name or text source is empty or does not exist!");
-	}
+	return outputOverlay.targetConfigs();
 }
 
-void HotkeyDisplayDock::hideSource()
+void HotkeyDisplayDock::releaseOutputTargets()
 {
-	if (!displayInTextSource) {
-		return;
-	}
-
-	if (sceneName == StyleConstants::DEFAULT_SCENE_NAME || textSource.isEmpty() || textSource == StyleConstants::NO_TEXT_SOURCE) {
-		blog(LOG_WARNING,
-		     "[StreamUP Hotkey Display] Scene or text source is not selected or invalid. Skipping hide source.");
-		return;
-	}
-
-	if (sceneAndSourceExist()) {
-		obs_source_t *scene = obs_get_source_by_name(sceneName.toUtf8().constData());
-		if (scene) {
-			obs_scene_t *sceneAsScene = obs_scene_from_source(scene);
-			obs_sceneitem_t *item = obs_scene_find_source(sceneAsScene, textSource.toUtf8().constData());
-			if (item) {
-				obs_sceneitem_set_visible(item, false);
-			} else {
-				blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene item '%s' not found in scene '%s'!",
-				     textSource.toUtf8().constData(), sceneName.toUtf8().constData());
-			}
-			obs_source_release(scene);
-		} else {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene '%s' not found!", sceneName.toUtf8().constData());
-		}
-	} else {
-		blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene name or text source is empty or does not exist!");
-	}
+	outputOverlay.clear();
 }
 
-bool HotkeyDisplayDock::sceneAndSourceExist()
+void HotkeyDisplayDock::resolveOutputTargets()
 {
-	if (sceneName.isEmpty() || textSource.isEmpty()) {
-		if (displayInTextSource) {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene name or text source is empty!");
-		}
-		return false;
-	}
+	outputOverlay.resolve(sceneSourceIndex);
+}
 
-	obs_source_t *scene = obs_get_source_by_name(sceneName.toUtf8().constData());
-	if (!scene) {
-		if (displayInTextSource) {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Scene '%s' does not exist!", sceneName.toUtf8().constData());
+void HotkeyDisplayDock::onSceneIndexed(const QString &sceneName)
+{
+	// Items of a target's scene changed, possibly inside one of its groups or nested scenes
+	for (const OutputTargetConfig &target : outputOverlay.targetConfigs()) {
+		if (target.sceneName == sceneName) {
+			resolveOutputTargets();
+			return;
 		}
-		return false;
 	}
+}
 
-	obs_scene_t *sceneAsScene = obs_scene_from_source(scene);
-	obs_sceneitem_t *item = obs_scene_find_source(sceneAsScene, textSource.toUtf8().constData());
-	obs_source_release(scene);
-
-	if (!item) {
-		if (displayInTextSource) {
-			blog(LOG_WARNING, "[StreamUP Hotkey Display] Source '%s' does not exist in scene '%s'!",
-			     textSource.toUtf8().constData(), sceneName.toUtf8().constData());
-		}
-		return false;
-	}
+void HotkeyDisplayDock::unresolveOutputTargets()
+{
+	outputOverlay.unresolve();
+}
 
-	return true;
+void HotkeyDisplayDock::hideAllOutputTargets()
+{
+	outputOverlay.hideAll();
 }
 
 void HotkeyDisplayDock::stopAllActivities()
@@ -438,12 +497,14 @@ void HotkeyDisplayDock::stopAllActivities()
 	if (clearTimer->isActive()) {
 		clearTimer->stop();
 	}
-	label->clear();
+	keycapDisplay->clear();
 }
 
 void HotkeyDisplayDock::resetToListeningState()
 {
-	stopAllActivities();
+	// The on-screen time is over: fade the combination out rather than blanking it
+	clearTimer->stop();
+	keycapDisplay->expire();
 	// Ensure the hook is enabled to listen for the next key press
 #ifdef _WIN32
 	if (!keyboardHook) {
@@ -534,7 +595,11 @@ void HotkeyDisplayDock::disableHooks()
 	stopLinuxKeyboardHook();
 #endif
 
+	// Keys released while nothing listens would otherwise stay held into the next start
+	hotkeyEngine.reset();
+
 	stopAllActivities();
+	hideAllOutputTargets();
 }
 
 void HotkeyDisplayDock::updateUIState(bool enabled)
@@ -542,14 +607,11 @@ void HotkeyDisplayDock::updateUIState(bool enabled)
 	const char *actionText = enabled ? obs_module_text("Dock.Button.Disable") : obs_module_text("Dock.Button.Enable");
 	const char *actionTooltip = enabled ? obs_module_text("Dock.Tooltip.Disable") : obs_module_text("Dock.Tooltip.Enable");
 	const char *labelDesc = enabled ? obs_module_text("Dock.Label.Active") : obs_module_text("Dock.Label.Idle");
-	const char *state = enabled ? "active" : "inactive";
 
 	toggleAction->setChecked(enabled);
 	toggleAction->setText(actionText);
 	toggleAction->setToolTip(actionTooltip);
 
-	label->setProperty("hotkeyState", state);
-	label->setAccessibleDescription(labelDesc);
-	label->style()->unpolish(label);
-	label->style()->polish(label);
+	keycapDisplay->setState(enabled ? KeycapDisplay::State::Active : KeycapDisplay::State::Inactive);
+	keycapDisplay->setAccessibleDescription(labelDesc);
 }
@@ -3,14 +3,23 @@
 #ifndef STREAMUP_HOTKEY_DISPLAY_DOCK_HPP
 #define STREAMUP_HOTKEY_DISPLAY_DOCK_HPP
 
+#include <QByteArray>
 #include <QFrame>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
 #include <QAction>
 #include <QToolBar>
 #include <QTimer>
 #include <obs.h>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "streamup-hotkey-display-history.hpp"
+#include "streamup-hotkey-display-keycaps.hpp"
+#include "streamup-hotkey-display-output.hpp"
+#include "streamup-hotkey-display-scenes.hpp"
 
 // Default value constants
 namespace StyleConstants {
@@ -18,6 +27,11 @@ constexpr const char *DEFAULT_SCENE_NAME = "Default Scene";
 constexpr const char *DEFAULT_TEXT_SOURCE = "Default Text Source";
 constexpr const char *NO_TEXT_SOURCE = "No text source available";
 constexpr int DEFAULT_ONSCREEN_TIME = 100;
+constexpr int DEFAULT_COALESCE_WINDOW = 400;
+constexpr int DEFAULT_SEQUENCE_TIMEOUT = 1500;
+constexpr int DEFAULT_GAMEPAD_DEADZONE = 25; // Percent of full stick deflection
+constexpr int DEFAULT_MOUSE_MOTION_RATE = 120; // Drag path samples per second
+constexpr int DEFAULT_OVERLAY_PORT = 4460;       // Browser overlay server on 127.0.0.1
 } // namespace StyleConstants
 
 class HotkeyDisplayDock : public QFrame {
@@ -27,39 +41,67 @@ public:
 	HotkeyDisplayDock(QWidget *parent = nullptr);
 	~HotkeyDisplayDock();
 
-	void setLog(const QString &log);
+	// Shows a chord in the dock and, rendered through each target's template, in every output target
+	void setLog(const TemplateValues &chord);
+	// Completes {held_ms} in the output targets once the chord last shown is released
+	void setHeldTime(int64_t heldMs);
+	bool outputsWantHeldTime() const { return outputOverlay.wantsHeldTime(); }
+	// Dispatcher thread: hand a chord, or the held time of the chord posted last, to setLog() and
+	// setHeldTime() on the UI thread. The values go into buffers the dock keeps, and only the first
+	// post since the UI thread last drained them queues a call, so a burst costs no allocation.
+	void postChord(const ChordEvent &chord, std::string_view profilePrefix, std::string_view application, uint32_t apm);
+	void postHeldTime(int64_t heldMs);
+	// Shows a status or error in the dock only, as wrapped text that stays until the next combination
+	void showMessage(const QString &message);
 	void setDisplayInTextSource(bool enabled) { displayInTextSource = enabled; }
 
+	// Output targets (scene + text source pairs that mirror the dock display)
+	void setOutputTargets(const std::vector<OutputTargetConfig> &targets);
+	std::vector<OutputTargetConfig> getOutputTargetConfigs() const;
+	void releaseOutputTargets();
+
+	// Text sources per scene and the items showing them, kept current in the background
+	SceneSourceIndex &getSceneSourceIndex() { return sceneSourceIndex; }
+
 public slots:
 	void toggleKeyboardHook();
 	void openSettings();
+	void toggleHistory(bool visible);
 	void clearDisplay();
+	void resolveOutputTargets();
+	void unresolveOutputTargets();
+	void onSceneIndexed(const QString &sceneName);
+
+	// Startup: the dock shows a "starting" state until the deferred hook start reports back
+	void setStartingState();
+	void startDeferredCapture();
+	void onCaptureStarted(bool success);
 
 	bool isHookEnabled() const { return hookEnabled; }
 	void setHookEnabled(bool enabled) { hookEnabled = enabled; }
 	QAction *getToggleAction() const { return toggleAction; }
-	QLabel *getLabel() const { return label; }
+	KeycapDisplay *getKeycapDisplay() const { return keycapDisplay; }
 
 public:
 	QVBoxLayout *layout;
 	QToolBar *toolbar;
-	QLabel *label;
+	KeycapDisplay *keycapDisplay;
 	QAction *toggleAction;
 	QAction *settingsAction;
+	QAction *historyAction;
+	QWidget *historyPanel;
+	QLineEdit *historySearch;
+	QListView *historyView;
+	ChordHistoryModel *historyModel;
+	QTimer *historyTimer;
+	QTimer *historyFilterTimer;
 	bool hookEnabled;
-	QString sceneName;
-	QString textSource;
 	int onScreenTime;
-	QString prefix;
-	QString suffix;
 	QTimer *clearTimer;
 	bool displayInTextSource;
 
 private:
-	void updateTextSource(const QString &text);
-	void showSource();
-	void hideSource();
-	bool sceneAndSourceExist();
+	void hideAllOutputTargets();
 	void stopAllActivities();
 	void resetToListeningState();
 
@@ -67,6 +109,25 @@ private:
 	bool enableHooks();
 	void disableHooks();
 	void updateUIState(bool enabled);
+
+	void queuePostedDrain(bool alreadyQueued);
+	void drainPosted();
+
+	// The history view sticks to the newest row while it is scrolled to the bottom
+	bool historyFollowsTail = true;
+
+	// Text, visibility and expiry of the output targets are applied once per video frame
+	OutputTargetOverlay outputOverlay;
+
+	std::mutex postedMutex; // Protects the posted* members
+	TemplateValues postedValues;
+	TemplateValues drainedValues; // UI thread only; swapped with postedValues so both keep their capacity
+	int64_t postedHeldMs = -1;
+	bool postedChordPending = false;
+	bool postedHeldPending = false;
+	bool postedDrainQueued = false;
+
+	SceneSourceIndex sceneSourceIndex;
 };
 
 #endif // STREAMUP_HOTKEY_DISPLAY_DOCK_HPP
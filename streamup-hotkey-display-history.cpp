@@ -0,0 +1,216 @@
+#include "streamup-hotkey-display-history.hpp"
+#include <QMetaObject>
+#include <algorithm>
+
+namespace {
+
+constexpr uint64_t SCAN_CHUNK = 4096; // Entries checked per lock of the log
+
+char asciiLower(char c)
+{
+	return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+bool containsIgnoringCase(std::string_view text, std::string_view lowerNeedle)
+{
+	if (lowerNeedle.size() > text.size()) {
+		return false;
+	}
+	for (size_t start = 0; start + lowerNeedle.size() <= text.size(); start++) {
+		size_t i = 0;
+		while (i < lowerNeedle.size() && asciiLower(text[start + i]) == lowerNeedle[i]) {
+			i++;
+		}
+		if (i == lowerNeedle.size()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace
+
+ChordHistoryModel::ChordHistoryModel(const ChordLog &log, QObject *parent)
+	: QAbstractListModel(parent),
+	  log(log),
+	  currentGeneration(std::make_shared<std::atomic<uint64_t>>(0))
+{
+	// One scan at a time; a new filter makes the running one stop at its next chunk
+	scanPool.setMaxThreadCount(1);
+	log.range(firstSequence, endSequence);
+	logRevision = log.revision();
+}
+
+ChordHistoryModel::~ChordHistoryModel()
+{
+	currentGeneration->store(++filterGeneration);
+	scanPool.waitForDone();
+}
+
+int ChordHistoryModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid()) {
+		return 0;
+	}
+	return isFiltering() ? (int)matches.size() : (int)(endSequence - firstSequence);
+}
+
+QVariant ChordHistoryModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount() || role != Qt::DisplayRole) {
+		return QVariant();
+	}
+
+	// Entries the log dropped since the last refresh() show as empty rows until then
+	QString text;
+	uint64_t sequence = sequenceAt(index.row());
+	log.visit(sequence, sequence + 1, [&text](uint64_t, const ChordLogEntry &entry) {
+		text = QString::fromUtf8(entry.text.data(), (int)entry.text.size());
+	});
+	return text;
+}
+
+void ChordHistoryModel::refresh()
+{
+	uint64_t first, end;
+	log.range(first, end);
+
+	// A replacement (a growing "×N" count) rewrites the newest entry, which may already be a row
+	uint64_t revision = log.revision();
+	bool newestReplaced = revision != logRevision;
+
+	if (isFiltering()) {
+		// Checks the newest entry against the filter again with the next scan. A running scan may
+		// have read the old text, so this waits until it is done.
+		if (newestReplaced && !scanRunning) {
+			logRevision = revision;
+			if (scannedEnd > first) {
+				scannedEnd--;
+				if (!matches.empty() && matches.back() == scannedEnd) {
+					int row = (int)matches.size() - 1;
+					beginRemoveRows(QModelIndex(), row, row);
+					matches.pop_back();
+					endRemoveRows();
+				}
+			}
+		}
+
+		size_t dropped = 0;
+		while (dropped < matches.size() && matches[dropped] < first) {
+			dropped++;
+		}
+		if (dropped > 0) {
+			beginRemoveRows(QModelIndex(), 0, (int)dropped - 1);
+			matches.erase(matches.begin(), matches.begin() + dropped);
+			endRemoveRows();
+		}
+		if (!scanRunning && end > scannedEnd) {
+			startScan(std::max(scannedEnd, first), end);
+		}
+		return;
+	}
+
+	if (first > firstSequence) {
+		uint64_t dropped = std::min(first, endSequence) - firstSequence;
+		if (dropped > 0) {
+			beginRemoveRows(QModelIndex(), 0, (int)dropped - 1);
+			firstSequence += dropped;
+			endRemoveRows();
+		}
+		// Everything shown was dropped and more besides: start over at the log's first entry
+		firstSequence = std::max(firstSequence, first);
+		endSequence = std::max(endSequence, firstSequence);
+	}
+	logRevision = revision;
+	if (newestReplaced && endSequence > firstSequence) {
+		QModelIndex newest = index(rowCount() - 1);
+		emit dataChanged(newest, newest);
+	}
+	if (end > endSequence) {
+		int rows = rowCount();
+		beginInsertRows(QModelIndex(), rows, rows + (int)(end - endSequence) - 1);
+		endSequence = end;
+		endInsertRows();
+	}
+}
+
+void ChordHistoryModel::setFilter(const QString &filter)
+{
+	std::string lowered = filter.trimmed().toUtf8().toStdString();
+	std::transform(lowered.begin(), lowered.end(), lowered.begin(), asciiLower);
+	if (lowered == filterText) {
+		return;
+	}
+
+	currentGeneration->store(++filterGeneration);
+	scanRunning = false;
+
+	beginResetModel();
+	filterText = lowered;
+	matches.clear();
+	log.range(firstSequence, endSequence);
+	logRevision = log.revision();
+	scannedEnd = firstSequence;
+	endResetModel();
+
+	if (isFiltering()) {
+		startScan(firstSequence, endSequence);
+	}
+}
+
+uint64_t ChordHistoryModel::sequenceAt(int row) const
+{
+	return isFiltering() ? matches[(size_t)row] : firstSequence + (uint64_t)row;
+}
+
+void ChordHistoryModel::startScan(uint64_t from, uint64_t to)
+{
+	scanRunning = true;
+	uint64_t generation = filterGeneration;
+	std::shared_ptr<std::atomic<uint64_t>> current = currentGeneration;
+	std::string needle = filterText;
+	const ChordLog *source = &log;
+
+	scanPool.start([this, generation, current, needle, source, from, to]() {
+		// Each chunk's matches are posted as soon as it is scanned, so the first rows show up
+		// without waiting for the whole log; queued calls arrive in order
+		for (uint64_t chunk = from; chunk < to; chunk += SCAN_CHUNK) {
+			if (current->load() != generation) {
+				return;
+			}
+			uint64_t chunkEnd = std::min(chunk + SCAN_CHUNK, to);
+			std::vector<uint64_t> found;
+			source->visit(chunk, chunkEnd, [&](uint64_t sequence, const ChordLogEntry &entry) {
+				if (containsIgnoringCase(entry.text, needle)) {
+					found.push_back(sequence);
+				}
+			});
+
+			bool finished = chunkEnd == to;
+			if (found.empty() && !finished) {
+				continue;
+			}
+			auto deliver = [this, generation, chunkEnd, finished, found = std::move(found)]() mutable {
+				addMatches(generation, chunkEnd, finished, std::move(found));
+			};
+			QMetaObject::invokeMethod(this, std::move(deliver), Qt::QueuedConnection);
+		}
+	});
+}
+
+void ChordHistoryModel::addMatches(uint64_t generation, uint64_t scannedTo, bool finished, std::vector<uint64_t> found)
+{
+	if (generation != filterGeneration) {
+		return;
+	}
+	scanRunning = !finished;
+	scannedEnd = scannedTo;
+
+	// Entries dropped while the scan ran are removed by the next refresh()
+	if (!found.empty()) {
+		int rows = rowCount();
+		beginInsertRows(QModelIndex(), rows, rows + (int)found.size() - 1);
+		matches.insert(matches.end(), found.begin(), found.end());
+		endInsertRows();
+	}
+}
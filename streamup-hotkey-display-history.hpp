@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_HISTORY_HPP
+#define STREAMUP_HOTKEY_DISPLAY_HISTORY_HPP
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "streamup-hotkey-core-history.hpp"
+
+// List model over the chord log, oldest chord first. Rows are read from the log when the view asks
+// for them, so only the visible ones are ever turned into QStrings. refresh() turns everything
+// recorded since the last call into one row insertion (and entries the log has dropped into one
+// removal) instead of resetting the model. With a filter set, the rows are the matching entries;
+// the log is scanned on a worker thread in chunks and each chunk's matches are appended as soon
+// as it has been scanned.
+class ChordHistoryModel : public QAbstractListModel {
+	Q_OBJECT
+
+public:
+	explicit ChordHistoryModel(const ChordLog &log, QObject *parent = nullptr);
+	~ChordHistoryModel();
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+	void refresh();
+	// Keeps the entries whose text contains the filter (ASCII case-insensitive); empty shows all
+	void setFilter(const QString &filter);
+	bool isFiltering() const { return !filterText.empty(); }
+
+private:
+	uint64_t sequenceAt(int row) const;
+	void startScan(uint64_t from, uint64_t to);
+	// Matches of one scanned chunk; the last chunk of a scan is finished
+	void addMatches(uint64_t generation, uint64_t scannedTo, bool finished, std::vector<uint64_t> found);
+
+	const ChordLog &log;
+
+	// Unfiltered rows are the entries [firstSequence, endSequence)
+	uint64_t firstSequence = 0;
+	uint64_t endSequence = 0;
+	uint64_t logRevision = 0; // ChordLog::revision() at the last refresh()
+
+	// Filtered rows are the matching entries; everything before scannedEnd has been checked
+	std::string filterText; // Lowercase UTF-8
+	std::deque<uint64_t> matches;
+	uint64_t scannedEnd = 0;
+	bool scanRunning = false;
+	uint64_t filterGeneration = 0;
+	std::shared_ptr<std::atomic<uint64_t>> currentGeneration; // Lets running scans notice they are stale
+	QThreadPool scanPool;
+};
+
+#endif // STREAMUP_HOTKEY_DISPLAY_HISTORY_HPP
@@ -0,0 +1,381 @@
+#include "streamup-hotkey-display-keycaps.hpp"
+#include <QEvent>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QTextOption>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int FRAME_BORDER = 2;
+constexpr int FRAME_RADIUS = 4;
+constexpr int FRAME_PADDING = 10;
+constexpr int ITEM_SPACING = 6;
+constexpr int ROW_SPACING = 6;
+constexpr int KEYCAP_PADDING_X = 8;
+constexpr int KEYCAP_PADDING_Y = 3;
+constexpr int KEYCAP_DEPTH = 2; // Darker lower edge that makes a keycap look raised
+constexpr qreal KEYCAP_RADIUS = 4.0;
+constexpr int MAX_CACHED_ITEMS = 256; // Per cache; far more than the distinct keys a session shows
+constexpr int EXPIRY_FADE_MS = 150;
+
+const QString CHORD_SEPARATOR = QStringLiteral(" + ");
+const QString COUNT_PREFIX = QString::fromUtf8(" \xC3\x97"); // " ×", appended by the coalescer
+
+QSize ceilSize(const QSizeF &size)
+{
+	return QSize((int)std::ceil(size.width()), (int)std::ceil(size.height()));
+}
+
+} // namespace
+
+KeycapDisplay::KeycapDisplay(QWidget *parent) : QWidget(parent), fade(new QVariantAnimation(this))
+{
+	setAttribute(Qt::WA_OpaquePaintEvent);
+	setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
+	updateFonts();
+
+	fade->setStartValue(1.0);
+	fade->setEndValue(0.0);
+	fade->setDuration(EXPIRY_FADE_MS);
+	connect(fade, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
+		opacity = value.toReal();
+		update(contentBounds);
+	});
+	connect(fade, &QVariantAnimation::finished, this, &KeycapDisplay::clear);
+}
+
+void KeycapDisplay::setChord(const QString &chord)
+{
+	fade->stop();
+	opacity = 1.0;
+
+	// Repeats of the shown chord (autorepeat, a running count that did not change) only cancel the fade
+	if (message.isEmpty() && chord == chordText && !items.empty()) {
+		update(contentBounds);
+		return;
+	}
+
+	QRect previousBounds = contentBounds;
+	chordText = chord;
+	message.clear();
+	parseChord(chord);
+	layoutContent();
+	repaintContent(previousBounds);
+}
+
+void KeycapDisplay::setMessage(const QString &text)
+{
+	fade->stop();
+	opacity = 1.0;
+
+	QRect previousBounds = contentBounds;
+	chordText.clear();
+	items.clear();
+	message = text;
+	messageText.setText(text);
+	layoutContent();
+	repaintContent(previousBounds);
+}
+
+void KeycapDisplay::expire()
+{
+	if (!isEmpty() && fade->state() != QAbstractAnimation::Running) {
+		fade->start();
+	}
+}
+
+void KeycapDisplay::clear()
+{
+	fade->stop();
+	opacity = 1.0;
+
+	QRect previousBounds = contentBounds;
+	chordText.clear();
+	items.clear();
+	message.clear();
+	contentBounds = QRect();
+	update(previousBounds);
+}
+
+void KeycapDisplay::setState(State state)
+{
+	if (state == displayState) {
+		return;
+	}
+	displayState = state;
+	update(); // The frame changes
+}
+
+QSize KeycapDisplay::sizeHint() const
+{
+	return QSize(200, 60);
+}
+
+QSize KeycapDisplay::minimumSizeHint() const
+{
+	return QSize(0, 50);
+}
+
+void KeycapDisplay::paintEvent(QPaintEvent *event)
+{
+	checkPixelRatio();
+
+	QPainter painter(this);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.fillRect(event->rect(), palette().color(QPalette::Window));
+
+	// Only the part inside the update region is actually rasterised
+	QPen framePen(palette().color(displayState == State::Active ? QPalette::Highlight : QPalette::Mid), FRAME_BORDER);
+	if (displayState == State::Starting) {
+		framePen.setStyle(Qt::DashLine);
+	}
+	painter.setPen(framePen);
+	painter.setBrush(palette().color(QPalette::Base));
+	qreal inset = FRAME_BORDER / 2.0;
+	painter.drawRoundedRect(QRectF(rect()).adjusted(inset, inset, -inset, -inset), FRAME_RADIUS, FRAME_RADIUS);
+
+	if (isEmpty() || !event->rect().intersects(contentBounds)) {
+		return;
+	}
+
+	painter.setOpacity(opacity);
+	painter.setFont(textFont);
+	if (!message.isEmpty()) {
+		painter.setPen(palette().color(QPalette::Text));
+		painter.drawStaticText(contentBounds.topLeft(), messageText);
+		return;
+	}
+
+	QColor textColor = palette().color(QPalette::Text);
+	QColor separatorColor = textColor;
+	separatorColor.setAlphaF(0.6f);
+	for (const Item &item : items) {
+		if (!event->rect().intersects(item.rect)) {
+			continue;
+		}
+		switch (item.kind) {
+		case ItemKind::Keycap:
+			painter.drawPixmap(item.rect.topLeft(), keycapPixmap(item.text));
+			break;
+		case ItemKind::Separator:
+			painter.setPen(separatorColor);
+			painter.drawStaticText(item.rect.topLeft(), staticText(item.text));
+			break;
+		case ItemKind::Count:
+			painter.setPen(palette().color(QPalette::Highlight));
+			painter.drawStaticText(item.rect.topLeft(), staticText(item.text));
+			break;
+		case ItemKind::Caption:
+			painter.setPen(textColor);
+			painter.drawStaticText(item.rect.topLeft(), staticText(item.text));
+			break;
+		}
+	}
+}
+
+void KeycapDisplay::resizeEvent(QResizeEvent *event)
+{
+	QWidget::resizeEvent(event);
+	layoutContent();
+}
+
+void KeycapDisplay::changeEvent(QEvent *event)
+{
+	QWidget::changeEvent(event);
+	switch (event->type()) {
+	case QEvent::FontChange:
+	case QEvent::PaletteChange:
+	case QEvent::StyleChange:
+		updateFonts();
+		keycaps.clear();
+		texts.clear();
+		layoutContent();
+		update();
+		break;
+	default:
+		break;
+	}
+}
+
+void KeycapDisplay::parseChord(const QString &chord)
+{
+	items.clear();
+	QString keys = chord;
+
+	// "<keys>[ ×<count>][ (<action>)]", see formatChordDisplay() and ChordCoalescer
+	QString caption;
+	int captionStart = keys.endsWith(QLatin1Char(')')) ? keys.lastIndexOf(QStringLiteral(" (")) : -1;
+	if (captionStart > 0) {
+		caption = keys.mid(captionStart + 1);
+		keys.truncate(captionStart);
+	}
+	QString count;
+	int countStart = keys.lastIndexOf(COUNT_PREFIX);
+	if (countStart > 0) {
+		bool isNumber = false;
+		keys.mid(countStart + COUNT_PREFIX.size()).toUInt(&isNumber);
+		if (isNumber) {
+			count = keys.mid(countStart + 1);
+			keys.truncate(countStart);
+		}
+	}
+
+	for (const QString &key : keys.split(CHORD_SEPARATOR, Qt::SkipEmptyParts)) {
+		if (!items.empty()) {
+			items.push_back({ItemKind::Separator, QStringLiteral("+"), QRect()});
+		}
+		items.push_back({ItemKind::Keycap, key, QRect()});
+	}
+	if (!count.isEmpty()) {
+		items.push_back({ItemKind::Count, count, QRect()});
+	}
+	if (!caption.isEmpty()) {
+		items.push_back({ItemKind::Caption, caption, QRect()});
+	}
+}
+
+void KeycapDisplay::layoutContent()
+{
+	checkPixelRatio();
+	QRect area = contentArea();
+
+	if (!message.isEmpty()) {
+		QTextOption option(Qt::AlignHCenter);
+		option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+		messageText.setTextOption(option);
+		messageText.setTextFormat(Qt::PlainText);
+		messageText.setTextWidth(area.width());
+		messageText.prepare(QTransform(), textFont);
+		int height = ceilSize(messageText.size()).height();
+		contentBounds = QRect(area.left(), area.top() + (area.height() - height) / 2, area.width(), height);
+		return;
+	}
+
+	// Flow the items into rows that wrap at the frame, then centre each row and the rows as a whole
+	struct Row {
+		size_t first;
+		size_t end;
+		int width;
+		int height;
+	};
+	QVarLengthArray<Row, 4> rows;
+	for (size_t i = 0; i < items.size(); i++) {
+		Item &item = items[i];
+		QSize size = item.kind == ItemKind::Keycap ? ceilSize(keycapPixmap(item.text).deviceIndependentSize())
+							    : ceilSize(staticText(item.text).size());
+		item.rect = QRect(QPoint(), size);
+
+		if (rows.isEmpty() || rows.back().width + ITEM_SPACING + size.width() > area.width()) {
+			rows.append({i, i + 1, size.width(), size.height()});
+			continue;
+		}
+		Row &row = rows.back();
+		row.end = i + 1;
+		row.width += ITEM_SPACING + size.width();
+		row.height = std::max(row.height, size.height());
+	}
+
+	int totalHeight = rows.isEmpty() ? 0 : ROW_SPACING * (int)(rows.size() - 1);
+	for (const Row &row : rows) {
+		totalHeight += row.height;
+	}
+
+	contentBounds = QRect();
+	int y = area.top() + (area.height() - totalHeight) / 2;
+	for (const Row &row : rows) {
+		int x = area.left() + (area.width() - row.width) / 2;
+		for (size_t i = row.first; i < row.end; i++) {
+			QRect &rect = items[i].rect;
+			rect.moveTo(x, y + (row.height - rect.height()) / 2);
+			x += rect.width() + ITEM_SPACING;
+			contentBounds |= rect;
+		}
+		y += row.height + ROW_SPACING;
+	}
+}
+
+QRect KeycapDisplay::contentArea() const
+{
+	int inset = FRAME_BORDER + FRAME_PADDING;
+	return rect().adjusted(inset, inset, -inset, -inset);
+}
+
+void KeycapDisplay::updateFonts()
+{
+	textFont = font();
+	textFont.setPointSizeF(14.0);
+	keyFont = font();
+	keyFont.setPointSizeF(12.0);
+	keyFont.setWeight(QFont::DemiBold);
+}
+
+void KeycapDisplay::checkPixelRatio()
+{
+	// Moving the dock to a screen with another scale factor invalidates every cached pixmap
+	qreal ratio = devicePixelRatioF();
+	if (ratio != pixelRatio) {
+		pixelRatio = ratio;
+		keycaps.clear();
+	}
+}
+
+const QPixmap &KeycapDisplay::keycapPixmap(const QString &key)
+{
+	auto it = keycaps.constFind(key);
+	if (it != keycaps.constEnd()) {
+		return *it;
+	}
+	if (keycaps.size() >= MAX_CACHED_ITEMS) {
+		keycaps.clear();
+	}
+
+	QFontMetricsF metrics(keyFont);
+	QSize size = ceilSize(QSizeF(metrics.horizontalAdvance(key) + 2 * KEYCAP_PADDING_X,
+				     metrics.height() + 2 * KEYCAP_PADDING_Y + KEYCAP_DEPTH));
+	size.setWidth(std::max(size.width(), size.height())); // Single letters get square caps
+
+	QPixmap pixmap(size * pixelRatio);
+	pixmap.setDevicePixelRatio(pixelRatio);
+	pixmap.fill(Qt::transparent);
+
+	QPainter painter(&pixmap);
+	painter.setRenderHint(QPainter::Antialiasing);
+	QRectF face(0.5, 0.5, size.width() - 1.0, size.height() - 1.0 - KEYCAP_DEPTH);
+	painter.setPen(Qt::NoPen);
+	painter.setBrush(palette().color(QPalette::Dark));
+	painter.drawRoundedRect(face.translated(0, KEYCAP_DEPTH), KEYCAP_RADIUS, KEYCAP_RADIUS);
+	painter.setPen(QPen(palette().color(QPalette::Mid), 1.0));
+	painter.setBrush(palette().color(QPalette::Button));
+	painter.drawRoundedRect(face, KEYCAP_RADIUS, KEYCAP_RADIUS);
+	painter.setFont(keyFont);
+	painter.setPen(palette().color(QPalette::ButtonText));
+	painter.drawText(face, Qt::AlignCenter, key);
+	painter.end();
+
+	return *keycaps.insert(key, pixmap);
+}
+
+const QStaticText &KeycapDisplay::staticText(const QString &text)
+{
+	auto it = texts.constFind(text);
+	if (it != texts.constEnd()) {
+		return *it;
+	}
+	if (texts.size() >= MAX_CACHED_ITEMS) {
+		texts.clear();
+	}
+
+	QStaticText prepared(text);
+	prepared.setTextFormat(Qt::PlainText);
+	prepared.prepare(QTransform(), textFont);
+	return *texts.insert(text, prepared);
+}
+
+void KeycapDisplay::repaintContent(const QRect &previousBounds)
+{
+	update(previousBounds | contentBounds);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_KEYCAPS_HPP
+#define STREAMUP_HOTKEY_DISPLAY_KEYCAPS_HPP
+
+#include <QFont>
+#include <QHash>
+#include <QPixmap>
+#include <QRect>
+#include <QStaticText>
+#include <QString>
+#include <QVariantAnimation>
+#include <QWidget>
+#include <vector>
+
+// The dock's display. Draws a chord ("Ctrl + Shift + P (Command Palette)") as keycaps rendered once into cached
+// pixmaps, with the separators, count and action from cached QStaticText. Showing a chord only places those, never
+// changes the size hint (so the dock is not laid out again) and repaints the area covered by the old and new chord;
+// expiry fades that area out. The frame reflects the capture state and is painted directly, without a stylesheet.
+class KeycapDisplay : public QWidget {
+	Q_OBJECT
+
+public:
+	enum class State {
+		Inactive,
+		Active,
+		Starting,
+	};
+
+	explicit KeycapDisplay(QWidget *parent = nullptr);
+
+	void setChord(const QString &chord);
+	// Plain word-wrapped text instead of keycaps, e.g. a status or an error
+	void setMessage(const QString &text);
+	// Fades the chord out and then clears it
+	void expire();
+	void clear();
+	bool isEmpty() const { return items.empty() && message.isEmpty(); }
+
+	void setState(State state);
+	State state() const { return displayState; }
+
+	QSize sizeHint() const override;
+	QSize minimumSizeHint() const override;
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void resizeEvent(QResizeEvent *event) override;
+	void changeEvent(QEvent *event) override;
+
+private:
+	enum class ItemKind {
+		Keycap,
+		Separator,
+		Count,
+		Caption,
+	};
+
+	struct Item {
+		ItemKind kind;
+		QString text;
+		QRect rect;
+	};
+
+	void parseChord(const QString &chord);
+	void layoutContent();
+	QRect contentArea() const;
+	void updateFonts();
+	void checkPixelRatio();
+	const QPixmap &keycapPixmap(const QString &key);
+	const QStaticText &staticText(const QString &text);
+	void repaintContent(const QRect &previousBounds);
+
+	State displayState = State::Inactive;
+	QString chordText;
+	std::vector<Item> items;
+	QString message;
+	QStaticText messageText;
+	QRect contentBounds; // Everything the chord or message covers; what a change has to repaint
+	qreal opacity = 1.0;
+	QVariantAnimation *fade;
+
+	QFont keyFont;
+	QFont textFont;
+	qreal pixelRatio = 0.0;
+	QHash<QString, QPixmap> keycaps;
+	QHash<QString, QStaticText> texts;
+};
+
+#endif // STREAMUP_HOTKEY_DISPLAY_KEYCAPS_HPP
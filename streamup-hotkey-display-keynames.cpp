@@ -0,0 +1,204 @@
+#include "streamup-hotkey-display-keynames.hpp"
+#include "streamup-hotkey-core-gamepad.hpp"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef __APPLE__
+#include <ApplicationServices/ApplicationServices.h>
+#include <Carbon/Carbon.h>
+#endif
+
+#ifdef __linux__
+#include "streamup-hotkey-display-xkb.hpp"
+#endif
+
+namespace {
+
+#ifndef __linux__
+struct StaticKeyName {
+	int keyCode;
+	const char *name;
+};
+
+// Key name lookup tables, registered in the interned table on first use
+#ifdef _WIN32
+const StaticKeyName staticKeyNames[] = {
+	{VK_LBUTTON, "Left Click"},  {VK_RBUTTON, "Right Click"},  {VK_MBUTTON, "Middle Click"},
+	{VK_XBUTTON1, "X Button 1"}, {VK_XBUTTON2, "X Button 2"},  {VK_CONTROL, "Ctrl"},
+	{VK_LCONTROL, "Ctrl"},       {VK_RCONTROL, "Ctrl"},        {VK_MENU, "Alt"},
+	{VK_LMENU, "Alt"},           {VK_RMENU, "Alt"},            {VK_SHIFT, "Shift"},
+	{VK_LSHIFT, "Shift"},        {VK_RSHIFT, "Shift"},         {VK_LWIN, "Win"},
+	{VK_RWIN, "Win"},            {VK_RETURN, "Enter"},         {VK_SPACE, "Space"},
+	{VK_BACK, "Backspace"},      {VK_TAB, "Tab"},              {VK_ESCAPE, "Escape"},
+	{VK_PRIOR, "Page Up"},       {VK_NEXT, "Page Down"},       {VK_END, "End"},
+	{VK_HOME, "Home"},           {VK_LEFT, "Left Arrow"},      {VK_UP, "Up Arrow"},
+	{VK_RIGHT, "Right Arrow"},   {VK_DOWN, "Down Arrow"},      {VK_INSERT, "Insert"},
+	{VK_DELETE, "Delete"},       {VK_F1, "F1"},                {VK_F2, "F2"},
+	{VK_F3, "F3"},               {VK_F4, "F4"},                {VK_F5, "F5"},
+	{VK_F6, "F6"},               {VK_F7, "F7"},                {VK_F8, "F8"},
+	{VK_F9, "F9"},               {VK_F10, "F10"},              {VK_F11, "F11"},
+	{VK_F12, "F12"}};
+#endif
+
+#ifdef __APPLE__
+const StaticKeyName staticKeyNames[] = {
+	{kVK_Control, "Ctrl"},          {kVK_RightControl, "Ctrl"},   {kVK_Command, "Cmd"},
+	{kVK_RightCommand, "Cmd"},      {kVK_Option, "Alt"},          {kVK_RightOption, "Alt"},
+	{kVK_Shift, "Shift"},           {kVK_RightShift, "Shift"},    {kVK_ANSI_KeypadEnter, "Enter"},
+	{kVK_Return, "Enter"},          {kVK_Space, "Space"},         {kVK_Delete, "Backspace"},
+	{kVK_Tab, "Tab"},               {kVK_Escape, "Escape"},       {kVK_PageUp, "Page Up"},
+	{kVK_PageDown, "Page Down"},    {kVK_End, "End"},             {kVK_Home, "Home"},
+	{kVK_LeftArrow, "Left Arrow"},  {kVK_UpArrow, "Up Arrow"},    {kVK_RightArrow, "Right Arrow"},
+	{kVK_DownArrow, "Down Arrow"},  {kVK_Help, "Insert"},         {kVK_F1, "F1"},
+	{kVK_F2, "F2"},                 {kVK_F3, "F3"},               {kVK_F4, "F4"},
+	{kVK_F5, "F5"},                 {kVK_F6, "F6"},               {kVK_F7, "F7"},
+	{kVK_F8, "F8"},                 {kVK_F9, "F9"},               {kVK_F10, "F10"},
+	{kVK_F11, "F11"},               {kVK_F12, "F12"}};
+#endif
+
+// Resolve a key that is not in the static table. Only called once per key code.
+std::string resolveKeyName(int keyCode)
+{
+#ifdef _WIN32
+	UINT scanCode = MapVirtualKey(keyCode, MAPVK_VK_TO_VSC);
+	char keyName[128];
+	if (GetKeyNameTextA(scanCode << 16, keyName, sizeof(keyName)) > 0) {
+		return std::string(keyName);
+	}
+#endif
+
+#ifdef __APPLE__
+	// Translate the virtual key through the active keyboard layout
+	std::string name;
+	TISInputSourceRef inputSource = TISCopyCurrentKeyboardLayoutInputSource();
+	if (inputSource) {
+		CFDataRef layoutData = (CFDataRef)TISGetInputSourceProperty(inputSource, kTISPropertyUnicodeKeyLayoutData);
+		if (layoutData) {
+			const UCKeyboardLayout *layout = (const UCKeyboardLayout *)CFDataGetBytePtr(layoutData);
+			UInt32 deadKeyState = 0;
+			UniChar chars[4];
+			UniCharCount length = 0;
+			OSStatus status = UCKeyTranslate(layout, (UInt16)keyCode, kUCKeyActionDisplay, 0, LMGetKbdType(),
+							 kUCKeyTranslateNoDeadKeysBit, &deadKeyState, 4, &length, chars);
+			if (status == noErr && length > 0) {
+				CFMutableStringRef str = CFStringCreateMutable(kCFAllocatorDefault, 0);
+				CFStringAppendCharacters(str, chars, length);
+				CFStringUppercase(str, nullptr);
+				char buffer[32];
+				if (CFStringGetCString(str, buffer, sizeof(buffer), kCFStringEncodingUTF8)) {
+					name = buffer;
+				}
+				CFRelease(str);
+			}
+		}
+		CFRelease(inputSource);
+	}
+	if (!name.empty()) {
+		return name;
+	}
+#endif
+
+	return "Unknown";
+}
+
+class KeyNameTable {
+public:
+	KeyNameTable()
+	{
+		for (const StaticKeyName &entry : staticKeyNames) {
+			insert(entry.keyCode, entry.name);
+		}
+	}
+
+	std::string_view lookup(int keyCode)
+	{
+		// Fast path: dense range covers virtual keys and keycodes on every platform
+		if (keyCode >= 0 && keyCode < DENSE_RANGE) {
+			const std::string *name = dense[keyCode].load(std::memory_order_acquire);
+			if (name) {
+				return *name;
+			}
+		} else {
+			std::shared_lock<std::shared_mutex> lock(sparseMutex);
+			auto it = sparse.find(keyCode);
+			if (it != sparse.end()) {
+				return *it->second;
+			}
+		}
+
+		// First time this key is seen: resolve through the OS once and cache the result
+		return *insert(keyCode, resolveKeyName(keyCode));
+	}
+
+private:
+	static constexpr int DENSE_RANGE = 256;
+
+	const std::string *insert(int keyCode, std::string name)
+	{
+		std::unique_lock<std::shared_mutex> lock(sparseMutex);
+
+		// Another thread may have resolved the same key while we were resolving it
+		if (keyCode >= 0 && keyCode < DENSE_RANGE) {
+			if (const std::string *existing = dense[keyCode].load(std::memory_order_acquire)) {
+				return existing;
+			}
+		} else {
+			auto it = sparse.find(keyCode);
+			if (it != sparse.end()) {
+				return it->second;
+			}
+		}
+
+		// std::deque never relocates elements on push_back, so views stay valid
+		storage.push_back(std::move(name));
+		const std::string *interned = &storage.back();
+
+		if (keyCode >= 0 && keyCode < DENSE_RANGE) {
+			dense[keyCode].store(interned, std::memory_order_release);
+		} else {
+			sparse.emplace(keyCode, interned);
+		}
+		return interned;
+	}
+
+	std::array<std::atomic<const std::string *>, DENSE_RANGE> dense{};
+	std::unordered_map<int, const std::string *> sparse;
+	std::shared_mutex sparseMutex; // Protects sparse and storage
+	std::deque<std::string> storage;
+};
+
+KeyNameTable &keyNameTable()
+{
+	static KeyNameTable table;
+	return table;
+}
+#endif
+
+} // namespace
+
+std::string_view getKeyName(int keyCode)
+{
+	if (isGamepadKeyCode(keyCode)) {
+		return gamepadKeyName(keyCode);
+	}
+
+#ifdef __linux__
+	// Labels are keycode-indexed tables built from the active XKB layout
+	const XkbLayoutLabels *layout = xkbKeymapCache().active();
+	if (layout && keyCode >= 0 && keyCode < XKB_KEYCODE_COUNT) {
+		return layout->labels[keyCode];
+	}
+	return "Unknown";
+#else
+	return keyNameTable().lookup(keyCode);
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_KEYNAMES_HPP
+#define STREAMUP_HOTKEY_DISPLAY_KEYNAMES_HPP
+
+#include <string_view>
+
+// Display name for a platform key code. Names are interned: keys in the static table are
+// registered up front, any other key is resolved once (OS fallback) the first time it is
+// seen and cached, so every later lookup is a table index. On Linux names come from the
+// active XKB layout table instead (see streamup-hotkey-display-xkb.hpp). The returned view
+// always points at NUL-terminated storage; use it before the next keymap change.
+std::string_view getKeyName(int keyCode);
+
+#endif // STREAMUP_HOTKEY_DISPLAY_KEYNAMES_HPP
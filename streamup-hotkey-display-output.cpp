@@ -0,0 +1,349 @@
+#include "streamup-hotkey-display-output.hpp"
+#include "streamup-hotkey-display-dock.hpp"
+#include "streamup-hotkey-display-scenes.hpp"
+#include <QByteArray>
+#include <obs-module.h>
+
+OutputTargetConfig::OutputTargetConfig()
+	: sceneName(StyleConstants::DEFAULT_SCENE_NAME),
+	  textSource(StyleConstants::DEFAULT_TEXT_SOURCE),
+	  prefix(""),
+	  suffix(""),
+	  textTemplate(""),
+	  onScreenTime(StyleConstants::DEFAULT_ONSCREEN_TIME)
+{
+}
+
+bool OutputTargetConfig::isConfigured() const
+{
+	return !sceneName.isEmpty() && sceneName != StyleConstants::DEFAULT_SCENE_NAME && !textSource.isEmpty() &&
+	       textSource != StyleConstants::DEFAULT_TEXT_SOURCE && textSource != StyleConstants::NO_TEXT_SOURCE;
+}
+
+QString OutputTargetConfig::displayName() const
+{
+	return sceneName + " / " + textSource;
+}
+
+void OutputTarget::resolve(const SceneSourceIndex &index)
+{
+	release();
+
+	// Compiled once per resolve, which only follows settings and scene changes
+	QByteArray templateUtf8 = config.textTemplate.toUtf8();
+	std::string error;
+	if (templateUtf8.isEmpty() || !format.compile(std::string_view(templateUtf8.constData(), templateUtf8.size()), error)) {
+		if (!error.empty()) {
+			blog(LOG_WARNING, "[StreamUP Hotkey Display] Template of '%s' ignored, %s",
+			     config.displayName().toUtf8().constData(), error.c_str());
+		}
+		QByteArray prefixUtf8 = config.prefix.toUtf8();
+		QByteArray suffixUtf8 = config.suffix.toUtf8();
+		format.compileAffixes(std::string_view(prefixUtf8.constData(), prefixUtf8.size()),
+				      std::string_view(suffixUtf8.constData(), suffixUtf8.size()));
+	}
+
+	if (!config.isConfigured()) {
+		return;
+	}
+
+	// Not indexed yet: the index reports the scene once it is, and the targets are resolved again
+	if (!index.textSourceItems(config.sceneName, config.textSource, sceneItems)) {
+		return;
+	}
+
+	if (sceneItems.empty()) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Source '%s' does not exist in scene '%s'!",
+		     config.textSource.toUtf8().constData(), config.sceneName.toUtf8().constData());
+		return;
+	}
+
+	weakSource = obs_source_get_weak_source(obs_sceneitem_get_source(sceneItems.front()));
+}
+
+void OutputTarget::release()
+{
+	if (weakSource) {
+		obs_weak_source_release(weakSource);
+		weakSource = nullptr;
+	}
+	for (obs_sceneitem_t *item : sceneItems) {
+		obs_sceneitem_release(item);
+	}
+	sceneItems.clear();
+}
+
+OutputTargetOverlay::OutputTargetOverlay()
+{
+	obs_add_tick_callback(frameTick, this);
+}
+
+OutputTargetOverlay::~OutputTargetOverlay()
+{
+	// Waits for a running tick, so nothing below is used by the video thread anymore
+	obs_remove_tick_callback(frameTick, this);
+	clear();
+	obs_data_release(textSettings);
+}
+
+void OutputTargetOverlay::setTargets(const std::vector<OutputTargetConfig> &configs)
+{
+	std::vector<OutputTarget> next(configs.size());
+	for (size_t i = 0; i < configs.size(); i++) {
+		next[i].config = configs[i];
+	}
+	replaceTargets(next, false);
+}
+
+std::vector<OutputTargetConfig> OutputTargetOverlay::targetConfigs() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<OutputTargetConfig> configs;
+	configs.reserve(targets.size());
+	for (const OutputTarget &target : targets) {
+		configs.push_back(target.config);
+	}
+	return configs;
+}
+
+void OutputTargetOverlay::resolve(const SceneSourceIndex &index)
+{
+	// Look the handles up without holding the lock the video thread takes every frame
+	std::vector<OutputTargetConfig> configs = targetConfigs();
+	std::vector<OutputTarget> next(configs.size());
+	for (size_t i = 0; i < configs.size(); i++) {
+		next[i].config = configs[i];
+		next[i].resolve(index);
+	}
+	replaceTargets(next, true);
+}
+
+void OutputTargetOverlay::unresolve()
+{
+	setTargets(targetConfigs());
+}
+
+void OutputTargetOverlay::clear()
+{
+	std::vector<OutputTarget> next;
+	replaceTargets(next, false);
+}
+
+void OutputTargetOverlay::replaceTargets(std::vector<OutputTarget> &next, bool keepFrameState)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (keepFrameState) {
+			for (size_t i = 0; i < next.size() && i < targets.size(); i++) {
+				const OutputTarget &previous = targets[i];
+				next[i].textPending = previous.textPending;
+				next[i].hidePending = previous.hidePending;
+				next[i].visible = previous.visible;
+				next[i].hideTime = previous.hideTime;
+				if (next[i].sceneItems == previous.sceneItems) {
+					next[i].shownText = previous.shownText;
+				}
+			}
+		}
+		next.swap(targets);
+
+		bool heldTime = false;
+		for (const OutputTarget &target : targets) {
+			heldTime = heldTime || target.format.uses(TemplateField::HeldMs);
+		}
+		heldTimeWanted.store(heldTime, std::memory_order_relaxed);
+	}
+
+	for (OutputTarget &target : next) {
+		target.release();
+	}
+}
+
+void OutputTargetOverlay::show(const TemplateValues &values)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pendingValues = values;
+	for (OutputTarget &target : targets) {
+		target.textPending = true;
+	}
+}
+
+void OutputTargetOverlay::hideAll()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (OutputTarget &target : targets) {
+		target.textPending = false;
+		target.textRefresh = false;
+		target.hidePending = true;
+	}
+}
+
+void OutputTargetOverlay::setHeldTime(int64_t heldMs)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pendingValues.heldMs = heldMs;
+	for (OutputTarget &target : targets) {
+		if (target.visible && !target.hidePending && target.format.uses(TemplateField::HeldMs)) {
+			target.textRefresh = true;
+		}
+	}
+}
+
+void OutputTargetOverlay::frameTick(void *data, float)
+{
+	static_cast<OutputTargetOverlay *>(data)->tick(obs_get_video_frame_time());
+}
+
+void OutputTargetOverlay::tick(uint64_t frameTime)
+{
+	size_t updateCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (OutputTarget &target : targets) {
+			if (!target.isResolved()) {
+				// Nothing to show it on; by the time the source turns up the chord would be stale
+				target.textPending = false;
+				target.textRefresh = false;
+				continue;
+			}
+
+			obs_source_t *source = nullptr;
+			bool visible = false;
+			if (target.textPending || (target.textRefresh && target.visible)) {
+				target.format.render(pendingValues, target.renderBuffer);
+				if (target.renderBuffer != target.shownText) {
+					source = obs_weak_source_get_source(target.weakSource);
+					if (!source) {
+						// The text source was removed, drop the stale handles until the next resolve
+						target.release();
+						continue;
+					}
+					target.shownText.swap(target.renderBuffer);
+				}
+
+				// Expiry counts from the frame that first shows the text
+				if (target.textPending) {
+					target.hideTime = frameTime + (uint64_t)target.config.onScreenTime * 1000000;
+				}
+				target.textPending = false;
+				target.textRefresh = false;
+				target.hidePending = false;
+				target.visible = true;
+				visible = true;
+			} else if (target.hidePending || (target.visible && frameTime >= target.hideTime)) {
+				target.textRefresh = false;
+				target.hidePending = false;
+				target.visible = false;
+			} else {
+				continue;
+			}
+
+			for (obs_sceneitem_t *item : target.sceneItems) {
+				if (updateCount == frameUpdates.size()) {
+					frameUpdates.emplace_back();
+				}
+				FrameUpdate &update = frameUpdates[updateCount++];
+				obs_sceneitem_addref(item);
+				update.sceneItem = item;
+				update.visible = visible;
+				update.source = source;
+				if (source) {
+					update.text.assign(target.shownText);
+					source = nullptr; // The text only needs setting once
+				}
+			}
+		}
+	}
+
+	if (updateCount == 0) {
+		return;
+	}
+
+	if (!textSettings) {
+		textSettings = obs_data_create();
+	}
+
+	// Text goes first so a target never becomes visible with its previous text for a frame
+	for (size_t i = 0; i < updateCount; i++) {
+		FrameUpdate &update = frameUpdates[i];
+		if (update.source) {
+			obs_data_set_string(textSettings, "text", update.text.c_str());
+			obs_source_update(update.source, textSettings);
+			obs_source_release(update.source);
+			update.source = nullptr;
+		}
+
+		// Compare with the item itself since the user may have toggled it by hand
+		if (obs_sceneitem_visible(update.sceneItem) != update.visible) {
+			obs_sceneitem_set_visible(update.sceneItem, update.visible);
+		}
+		obs_sceneitem_release(update.sceneItem);
+		update.sceneItem = nullptr;
+	}
+}
+
+std::vector<OutputTargetConfig> loadOutputTargets(obs_data_t *settings)
+{
+	std::vector<OutputTargetConfig> targets;
+	if (!settings) {
+		return targets;
+	}
+
+	obs_data_array_t *array = obs_data_get_array(settings, "outputTargets");
+	if (array) {
+		size_t count = obs_data_array_count(array);
+		targets.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			obs_data_t *item = obs_data_array_item(array, i);
+			OutputTargetConfig target;
+			target.sceneName = QString::fromUtf8(obs_data_get_string(item, "sceneName"));
+			target.textSource = QString::fromUtf8(obs_data_get_string(item, "textSource"));
+			target.prefix = QString::fromUtf8(obs_data_get_string(item, "prefix"));
+			target.suffix = QString::fromUtf8(obs_data_get_string(item, "suffix"));
+			target.textTemplate = QString::fromUtf8(obs_data_get_string(item, "template"));
+			target.onScreenTime = (int)obs_data_get_int(item, "onScreenTime");
+			if (target.onScreenTime <= 0) {
+				target.onScreenTime = StyleConstants::DEFAULT_ONSCREEN_TIME;
+			}
+			targets.push_back(target);
+			obs_data_release(item);
+		}
+		obs_data_array_release(array);
+		return targets;
+	}
+
+	// Migrate the single scene/source pair used by older versions
+	QString legacySource = QString::fromUtf8(obs_data_get_string(settings, "textSource"));
+	if (!legacySource.isEmpty()) {
+		OutputTargetConfig target;
+		target.sceneName = QString::fromUtf8(obs_data_get_string(settings, "sceneName"));
+		target.textSource = legacySource;
+		target.prefix = QString::fromUtf8(obs_data_get_string(settings, "prefix"));
+		target.suffix = QString::fromUtf8(obs_data_get_string(settings, "suffix"));
+		target.onScreenTime = (int)obs_data_get_int(settings, "onScreenTime");
+		if (target.onScreenTime <= 0) {
+			target.onScreenTime = StyleConstants::DEFAULT_ONSCREEN_TIME;
+		}
+		targets.push_back(target);
+	}
+
+	return targets;
+}
+
+void saveOutputTargets(obs_data_t *settings, const std::vector<OutputTargetConfig> &targets)
+{
+	obs_data_array_t *array = obs_data_array_create();
+	for (const OutputTargetConfig &target : targets) {
+		obs_data_t *item = obs_data_create();
+		obs_data_set_string(item, "sceneName", target.sceneName.toUtf8().constData());
+		obs_data_set_string(item, "textSource", target.textSource.toUtf8().constData());
+		obs_data_set_string(item, "prefix", target.prefix.toUtf8().constData());
+		obs_data_set_string(item, "suffix", target.suffix.toUtf8().constData());
+		obs_data_set_string(item, "template", target.textTemplate.toUtf8().constData());
+		obs_data_set_int(item, "onScreenTime", target.onScreenTime);
+		obs_data_array_push_back(array, item);
+		obs_data_release(item);
+	}
+	obs_data_set_array(settings, "outputTargets", array);
+	obs_data_array_release(array);
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_OUTPUT_HPP
+#define STREAMUP_HOTKEY_DISPLAY_OUTPUT_HPP
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <obs.h>
+#include "streamup-hotkey-core-template.hpp"
+
+class SceneSourceIndex;
+
+// User-facing configuration of a single output target (scene + text source pair)
+struct OutputTargetConfig {
+	QString sceneName;
+	QString textSource;
+	QString prefix;
+	QString suffix;
+	QString textTemplate; // Replaces prefix and suffix when set, see OutputTemplate
+	int onScreenTime;
+
+	OutputTargetConfig();
+
+	// True when both the scene and the text source have been chosen by the user
+	bool isConfigured() const;
+
+	// Short label used in the settings list, e.g. "Scene / Text"
+	QString displayName() const;
+};
+
+// Runtime state of an output target. Handles are resolved once (on settings apply, scene
+// collection changes or when the scene's items change) so that per-event updates never look
+// anything up by name. The text source may sit in a group or nested scene, and may be shown
+// by several items; all of them are shown and hidden together.
+struct OutputTarget {
+	OutputTargetConfig config;
+
+	// Compiled from the template, or from prefix and suffix without one, so a chord only renders
+	OutputTemplate format;
+
+	obs_weak_source_t *weakSource = nullptr;
+	std::vector<obs_sceneitem_t *> sceneItems;
+
+	// Frame state, owned by OutputTargetOverlay and only touched under its lock
+	bool textPending = false;
+	bool textRefresh = false; // Re-render a shown target without restarting its on-screen time
+	bool hidePending = false;
+	bool visible = false;
+	uint64_t hideTime = 0;    // Video frame time at which the target is hidden again
+	std::string shownText;    // Last text sent to the source, so repeats skip the update
+	std::string renderBuffer; // Where the next text is rendered; swapped with shownText when it differs
+
+	bool isResolved() const { return weakSource && !sceneItems.empty(); }
+	void resolve(const SceneSourceIndex &index);
+	void release();
+};
+
+// Drives every output target from the video thread. show() and hideAll() only record the
+// latest request; a tick callback applies it once per rendered frame, so a burst of chords costs
+// at most one template render and source update per target per frame, identical text is never
+// re-sent, and targets hide on the first frame past their on-screen time instead of whenever a Qt
+// timer fires.
+class OutputTargetOverlay {
+public:
+	OutputTargetOverlay();
+	~OutputTargetOverlay();
+
+	void setTargets(const std::vector<OutputTargetConfig> &configs);
+	std::vector<OutputTargetConfig> targetConfigs() const;
+
+	// Handle (re)resolution happens on the UI thread; the tick only uses resolved handles
+	void resolve(const SceneSourceIndex &index);
+	void unresolve();
+	void clear();
+
+	// Queue for the next frame. Safe to call from any thread.
+	void show(const TemplateValues &values);
+	void hideAll();
+
+	// Fills in {held_ms} for the chord last passed to show(), in the targets still showing it
+	void setHeldTime(int64_t heldMs);
+	bool wantsHeldTime() const { return heldTimeWanted.load(std::memory_order_relaxed); }
+
+private:
+	// One scene item's changes for the current frame, applied after the lock is dropped
+	struct FrameUpdate {
+		obs_source_t *source = nullptr; // Only set when the text changes, on the target's first item
+		obs_sceneitem_t *sceneItem = nullptr;
+		std::string text;
+		bool visible = false;
+	};
+
+	// Swaps in a new target list and releases the old handles outside the lock. keepFrameState
+	// carries visibility and expiry over so a re-resolve does not strand a shown target.
+	void replaceTargets(std::vector<OutputTarget> &next, bool keepFrameState);
+
+	static void frameTick(void *data, float seconds);
+	void tick(uint64_t frameTime);
+
+	mutable std::mutex mutex; // Protects targets and pendingValues
+	std::vector<OutputTarget> targets;
+	TemplateValues pendingValues;
+	std::atomic<bool> heldTimeWanted{false}; // Some target's template shows {held_ms}
+
+	// Video thread only. Entries are reused from frame to frame so their text keeps its capacity.
+	std::vector<FrameUpdate> frameUpdates;
+	obs_data_t *textSettings = nullptr;
+};
+
+// Persistence helpers. Older configs that only stored a single sceneName/textSource pair
+// are migrated to a one-entry target list on load.
+std::vector<OutputTargetConfig> loadOutputTargets(obs_data_t *settings);
+void saveOutputTargets(obs_data_t *settings, const std::vector<OutputTargetConfig> &targets);
+
+#endif // STREAMUP_HOTKEY_DISPLAY_OUTPUT_HPP
@@ -0,0 +1,447 @@
+#include "streamup-hotkey-display-scenes.hpp"
+#include <algorithm>
+#include <cstring>
+
+SceneSourceIndex::SceneSourceIndex(QObject *parent) : QObject(parent)
+{
+	// One pass at a time, so the first pass and later re-indexing never race each other
+	worker.setMaxThreadCount(1);
+}
+
+SceneSourceIndex::~SceneSourceIndex()
+{
+	stop();
+}
+
+void SceneSourceIndex::start()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (running) {
+			return;
+		}
+		running = true;
+		firstPassDone = false;
+	}
+
+	signal_handler_t *handler = obs_get_signal_handler();
+	signal_handler_connect(handler, "source_create", sourceCreated, this);
+	signal_handler_connect(handler, "source_remove", sourceRemoved, this);
+	signal_handler_connect(handler, "source_destroy", sourceRemoved, this);
+	signal_handler_connect(handler, "source_rename", sourceRenamed, this);
+
+	worker.start([this]() {
+		// Take references first so the source list is not locked while the items are walked
+		std::vector<obs_source_t *> sceneSources;
+		obs_enum_scenes(
+			[](void *param, obs_source_t *scene) {
+				// Groups are listed too, but they are walked as part of the scenes that hold them
+				if (!isScene(scene)) {
+					return true;
+				}
+				if (obs_source_t *ref = obs_source_get_ref(scene)) {
+					static_cast<std::vector<obs_source_t *> *>(param)->push_back(ref);
+				}
+				return true;
+			},
+			&sceneSources);
+
+		for (obs_source_t *scene : sceneSources) {
+			indexScene(scene);
+			obs_source_release(scene);
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		firstPassDone = running;
+	});
+}
+
+void SceneSourceIndex::stop()
+{
+	std::vector<obs_weak_source_t *> dropped;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!running) {
+			return;
+		}
+		running = false;
+		firstPassDone = false;
+		dropped.swap(pending);
+	}
+
+	signal_handler_t *handler = obs_get_signal_handler();
+	signal_handler_disconnect(handler, "source_create", sourceCreated, this);
+	signal_handler_disconnect(handler, "source_remove", sourceRemoved, this);
+	signal_handler_disconnect(handler, "source_destroy", sourceRemoved, this);
+	signal_handler_disconnect(handler, "source_rename", sourceRenamed, this);
+
+	// A running pass sees running == false and stops adding scenes
+	worker.waitForDone();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (SceneEntry &entry : scenes) {
+			dropped.push_back(entry.weakScene);
+			releaseItems(entry.textItems);
+		}
+		scenes.clear();
+		dropped.insert(dropped.end(), groups.begin(), groups.end());
+		groups.clear();
+	}
+
+	for (obs_weak_source_t *weakSource : dropped) {
+		if (obs_source_t *source = obs_weak_source_get_source(weakSource)) {
+			disconnectSceneSignals(source);
+			obs_source_release(source);
+		}
+		obs_weak_source_release(weakSource);
+	}
+}
+
+bool SceneSourceIndex::textSources(const QString &sceneName, QStringList &sources) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = scenes.constFind(sceneName);
+	if (it != scenes.constEnd()) {
+		sources = it->textSources;
+		return true;
+	}
+	sources.clear();
+	return firstPassDone;
+}
+
+bool SceneSourceIndex::textSourceItems(const QString &sceneName, const QString &sourceName,
+				       std::vector<obs_sceneitem_t *> &items) const
+{
+	items.clear();
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = scenes.constFind(sceneName);
+	if (it == scenes.constEnd()) {
+		return firstPassDone;
+	}
+	auto found = it->textItems.constFind(sourceName);
+	if (found != it->textItems.constEnd()) {
+		for (obs_sceneitem_t *item : *found) {
+			obs_sceneitem_addref(item);
+			items.push_back(item);
+		}
+	}
+	return true;
+}
+
+bool SceneSourceIndex::isTextSource(obs_source_t *source)
+{
+	// Unversioned ids cover text_gdiplus_v3 and text_ft2_source_v2 as well
+	const char *id = obs_source_get_unversioned_id(source);
+	return id && (strcmp(id, "text_gdiplus") == 0 || strcmp(id, "text_ft2_source") == 0 ||
+		      strcmp(id, "text_pango_source") == 0);
+}
+
+bool SceneSourceIndex::isScene(obs_source_t *source)
+{
+	return source && obs_source_is_scene(source);
+}
+
+void SceneSourceIndex::queueChange(obs_source_t *container)
+{
+	obs_weak_source_t *weakContainer = obs_source_get_weak_source(container);
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!running) {
+		obs_weak_source_release(weakContainer);
+		return;
+	}
+	pending.push_back(weakContainer);
+	if (!workerQueued) {
+		workerQueued = true;
+		worker.start([this]() { indexPending(); });
+	}
+}
+
+void SceneSourceIndex::indexPending()
+{
+	for (;;) {
+		std::vector<obs_weak_source_t *> batch;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (pending.empty()) {
+				workerQueued = false;
+				return;
+			}
+			batch.swap(pending);
+		}
+
+		// A change inside a group or nested scene re-walks every scene it shows in, each once per batch
+		std::vector<obs_source_t *> changedScenes;
+		auto addScene = [&changedScenes](obs_source_t *scene) {
+			if (std::find(changedScenes.begin(), changedScenes.end(), scene) != changedScenes.end()) {
+				obs_source_release(scene);
+			} else {
+				changedScenes.push_back(scene);
+			}
+		};
+
+		for (obs_weak_source_t *weakContainer : batch) {
+			obs_source_t *container = obs_weak_source_get_source(weakContainer);
+			obs_weak_source_release(weakContainer);
+			if (!container) {
+				continue;
+			}
+
+			QString name = QString::fromUtf8(obs_source_get_name(container));
+			std::vector<obs_source_t *> found;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (const SceneEntry &entry : scenes) {
+					if (entry.containers.contains(name)) {
+						if (obs_source_t *scene = obs_weak_source_get_source(entry.weakScene)) {
+							found.push_back(scene);
+						}
+					}
+				}
+			}
+			for (obs_source_t *scene : found) {
+				addScene(scene);
+			}
+
+			// Scenes created since the last walk are not in the map yet
+			if (isScene(container)) {
+				if (obs_source_t *scene = obs_source_get_ref(container)) {
+					addScene(scene);
+				}
+			}
+			obs_source_release(container);
+		}
+
+		for (obs_source_t *scene : changedScenes) {
+			indexScene(scene);
+			obs_source_release(scene);
+		}
+	}
+}
+
+void SceneSourceIndex::indexScene(obs_source_t *scene)
+{
+	QString name = QString::fromUtf8(obs_source_get_name(scene));
+	SceneWalk walk;
+	walk.containers.insert(name);
+	walkScene(obs_scene_from_source(scene), walk);
+
+	bool newScene = false;
+	bool changed = false;
+	std::vector<obs_source_t *> newGroups;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (running) {
+			SceneEntry &entry = scenes[name];
+			if (!entry.weakScene) {
+				entry.weakScene = obs_source_get_weak_source(scene);
+				newScene = true;
+			}
+			changed = newScene || entry.textSources != walk.textSources || entry.textItems != walk.textItems;
+			entry.textSources = walk.textSources;
+			entry.containers = walk.containers;
+			entry.textItems.swap(walk.textItems); // The walk now holds the previous items
+
+			for (obs_source_t *group : walk.groups) {
+				if (!isWatchedGroup(group)) {
+					groups.push_back(obs_source_get_weak_source(group));
+					newGroups.push_back(group);
+				}
+			}
+		}
+	}
+
+	releaseItems(walk.textItems);
+
+	// stop() waits for this thread before it disconnects every scene and group it knows about
+	for (obs_source_t *group : newGroups) {
+		connectSceneSignals(group);
+	}
+	for (obs_source_t *group : walk.groups) {
+		obs_source_release(group);
+	}
+	if (newScene) {
+		connectSceneSignals(scene);
+	}
+	if (changed) {
+		emit sceneIndexed(name);
+	}
+}
+
+void SceneSourceIndex::walkScene(obs_scene_t *scene, SceneWalk &walk)
+{
+	obs_scene_enum_items(
+		scene,
+		[](obs_scene_t *, obs_sceneitem_t *item, void *param) {
+			SceneWalk &walk = *static_cast<SceneWalk *>(param);
+			obs_source_t *source = obs_sceneitem_get_source(item);
+			if (isTextSource(source)) {
+				QString name = QString::fromUtf8(obs_source_get_name(source));
+				std::vector<obs_sceneitem_t *> &items = walk.textItems[name];
+				if (items.empty()) {
+					walk.textSources.append(name);
+				}
+				obs_sceneitem_addref(item);
+				items.push_back(item);
+				return true;
+			}
+
+			bool group = obs_sceneitem_is_group(item);
+			obs_scene_t *inner = group ? obs_sceneitem_group_get_scene(item) : obs_scene_from_source(source);
+			if (!inner) {
+				return true;
+			}
+
+			// Each group and nested scene is walked once, so a scene used twice adds no duplicate items
+			QString name = QString::fromUtf8(obs_source_get_name(source));
+			if (walk.containers.contains(name)) {
+				return true;
+			}
+			walk.containers.insert(name);
+			if (group) {
+				if (obs_source_t *ref = obs_source_get_ref(source)) {
+					walk.groups.push_back(ref);
+				}
+			}
+			walkScene(inner, walk);
+			return true;
+		},
+		&walk);
+}
+
+void SceneSourceIndex::releaseItems(TextItems &items)
+{
+	for (std::vector<obs_sceneitem_t *> &sourceItems : items) {
+		for (obs_sceneitem_t *item : sourceItems) {
+			obs_sceneitem_release(item);
+		}
+	}
+	items.clear();
+}
+
+bool SceneSourceIndex::isWatchedGroup(obs_source_t *group) const
+{
+	for (obs_weak_source_t *weakGroup : groups) {
+		if (obs_weak_source_references_source(weakGroup, group)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void SceneSourceIndex::connectSceneSignals(obs_source_t *scene)
+{
+	signal_handler_t *handler = obs_source_get_signal_handler(scene);
+	signal_handler_connect(handler, "item_add", sceneItemsChanged, this);
+	signal_handler_connect(handler, "item_remove", sceneItemsChanged, this);
+}
+
+void SceneSourceIndex::disconnectSceneSignals(obs_source_t *scene)
+{
+	signal_handler_t *handler = obs_source_get_signal_handler(scene);
+	signal_handler_disconnect(handler, "item_add", sceneItemsChanged, this);
+	signal_handler_disconnect(handler, "item_remove", sceneItemsChanged, this);
+}
+
+void SceneSourceIndex::sourceCreated(void *data, calldata_t *calldata)
+{
+	obs_source_t *source = static_cast<obs_source_t *>(calldata_ptr(calldata, "source"));
+	if (isScene(source)) {
+		static_cast<SceneSourceIndex *>(data)->queueChange(source);
+	}
+}
+
+void SceneSourceIndex::sourceRemoved(void *data, calldata_t *calldata)
+{
+	SceneSourceIndex *index = static_cast<SceneSourceIndex *>(data);
+	obs_source_t *source = static_cast<obs_source_t *>(calldata_ptr(calldata, "source"));
+	if (source && obs_source_is_group(source)) {
+		// Its items went with it; the scenes that showed the group get item_remove themselves
+		obs_weak_source_t *weakGroup = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(index->mutex);
+			for (auto it = index->groups.begin(); it != index->groups.end(); ++it) {
+				if (obs_weak_source_references_source(*it, source)) {
+					weakGroup = *it;
+					index->groups.erase(it);
+					break;
+				}
+			}
+		}
+		if (weakGroup) {
+			index->disconnectSceneSignals(source);
+			obs_weak_source_release(weakGroup);
+		}
+		return;
+	}
+	if (!isScene(source)) {
+		return;
+	}
+
+	QString name = QString::fromUtf8(obs_source_get_name(source));
+	obs_weak_source_t *weakScene = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(index->mutex);
+		auto it = index->scenes.find(name);
+		if (it == index->scenes.end() || !obs_weak_source_references_source(it->weakScene, source)) {
+			return;
+		}
+		weakScene = it->weakScene;
+		releaseItems(it->textItems);
+		index->scenes.erase(it);
+	}
+
+	index->disconnectSceneSignals(source);
+	obs_weak_source_release(weakScene);
+	emit index->sceneIndexed(name);
+}
+
+void SceneSourceIndex::sourceRenamed(void *data, calldata_t *calldata)
+{
+	SceneSourceIndex *index = static_cast<SceneSourceIndex *>(data);
+	obs_source_t *source = static_cast<obs_source_t *>(calldata_ptr(calldata, "source"));
+	QString previousName = QString::fromUtf8(calldata_string(calldata, "prev_name"));
+	QString newName = QString::fromUtf8(calldata_string(calldata, "new_name"));
+
+	QStringList changed;
+	std::vector<obs_source_t *> stale;
+	{
+		std::lock_guard<std::mutex> lock(index->mutex);
+		if (isScene(source)) {
+			auto it = index->scenes.find(previousName);
+			if (it != index->scenes.end()) {
+				SceneEntry entry = *it;
+				index->scenes.erase(it);
+				entry.containers.remove(previousName);
+				entry.containers.insert(newName);
+				index->scenes.insert(newName, entry);
+				changed << previousName << newName;
+			}
+		}
+
+		// Anything else that knows the source by its old name is walked again
+		for (const SceneEntry &entry : index->scenes) {
+			if (entry.containers.contains(previousName) || entry.textItems.contains(previousName)) {
+				if (obs_source_t *scene = obs_weak_source_get_source(entry.weakScene)) {
+					stale.push_back(scene);
+				}
+			}
+		}
+	}
+
+	for (obs_source_t *scene : stale) {
+		index->queueChange(scene);
+		obs_source_release(scene);
+	}
+	for (const QString &sceneName : changed) {
+		emit index->sceneIndexed(sceneName);
+	}
+}
+
+void SceneSourceIndex::sceneItemsChanged(void *data, calldata_t *calldata)
+{
+	obs_scene_t *scene = static_cast<obs_scene_t *>(calldata_ptr(calldata, "scene"));
+	if (scene) {
+		static_cast<SceneSourceIndex *>(data)->queueChange(obs_scene_get_source(scene));
+	}
+}
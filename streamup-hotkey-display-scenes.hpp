@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_SCENES_HPP
+#define STREAMUP_HOTKEY_DISPLAY_SCENES_HPP
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <mutex>
+#include <vector>
+#include <obs.h>
+
+// Text sources of every scene in the current scene collection, for the settings dialog and the
+// output targets. Each scene is walked through its groups and nested scenes, so a text source is
+// listed under every scene it shows in, together with the scene items that hold it. The collection
+// is indexed on a worker thread once OBS has finished loading, so neither opening the dialog nor
+// resolving a target enumerates scene items. Afterwards libobs signals keep it current: item_add
+// and item_remove on a scene or group re-index just the scenes that contain it, and source
+// creation, removal and renames keep the scene list in step.
+class SceneSourceIndex : public QObject {
+	Q_OBJECT
+
+public:
+	explicit SceneSourceIndex(QObject *parent = nullptr);
+	~SceneSourceIndex();
+
+	// UI thread. start() indexes the current collection; stop() must run before it is torn down.
+	void start();
+	void stop();
+
+	// False while the scene has not been reached by the first pass yet. Scenes that do not exist
+	// return true with no sources once that pass is done.
+	bool textSources(const QString &sceneName, QStringList &sources) const;
+
+	// Adds a reference to every scene item of the text source within the scene, whether it sits in
+	// the scene itself, in a group or in a nested scene. Same return value as textSources().
+	bool textSourceItems(const QString &sceneName, const QString &sourceName, std::vector<obs_sceneitem_t *> &items) const;
+
+	static bool isTextSource(obs_source_t *source);
+
+signals:
+	// A scene's text sources changed or became known. Usually emitted from the worker thread.
+	void sceneIndexed(const QString &sceneName);
+
+private:
+	using TextItems = QHash<QString, std::vector<obs_sceneitem_t *>>; // References held
+
+	struct SceneEntry {
+		obs_weak_source_t *weakScene = nullptr;
+		QStringList textSources; // In item order, each listed once
+		TextItems textItems;
+		QSet<QString> containers; // The scene itself plus every group and nested scene walked
+	};
+
+	// What one walk of a scene found, gathered before the lock is taken
+	struct SceneWalk {
+		QStringList textSources;
+		TextItems textItems;
+		QSet<QString> containers;
+		std::vector<obs_source_t *> groups; // References held
+	};
+
+	void queueChange(obs_source_t *container);
+	void indexPending();
+	void indexScene(obs_source_t *scene);
+	void connectSceneSignals(obs_source_t *scene);
+	void disconnectSceneSignals(obs_source_t *scene);
+	bool isWatchedGroup(obs_source_t *group) const;
+
+	static void walkScene(obs_scene_t *scene, SceneWalk &walk);
+	static void releaseItems(TextItems &items);
+	static bool isScene(obs_source_t *source);
+	static void sourceCreated(void *data, calldata_t *calldata);
+	static void sourceRemoved(void *data, calldata_t *calldata);
+	static void sourceRenamed(void *data, calldata_t *calldata);
+	static void sceneItemsChanged(void *data, calldata_t *calldata);
+
+	mutable std::mutex mutex; // Protects everything below
+	bool running = false;
+	bool firstPassDone = false;
+	QHash<QString, SceneEntry> scenes;
+	std::vector<obs_weak_source_t *> groups;  // Groups whose item signals are connected
+	std::vector<obs_weak_source_t *> pending; // Scenes and groups whose items changed
+	bool workerQueued = false;
+
+	QThreadPool worker;
+};
+
+#endif // STREAMUP_HOTKEY_DISPLAY_SCENES_HPP
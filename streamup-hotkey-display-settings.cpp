@@ -1,5 +1,8 @@
 #include "streamup-hotkey-display-settings.hpp"
 #include <obs-module.h>
+#include <QCompleter>
+#include <QFileDialog>
+#include <algorithm>
 
 extern obs_data_t *SaveLoadSettingsCallback(obs_data_t *save_data, bool saving);
 
@@ -13,13 +16,17 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	  timeLayout(new QHBoxLayout()),
 	  prefixLayout(new QHBoxLayout()),
 	  suffixLayout(new QHBoxLayout()),
+	  templateLayout(new QHBoxLayout()),
 	  sceneLabel(new QLabel(obs_module_text("Settings.Label.Scene"), this)),
 	  sourceLabel(new QLabel(obs_module_text("Settings.Label.TextSource"), this)),
 	  timeLabel(new QLabel(obs_module_text("Settings.Label.OnScreenTime"), this)),
 	  prefixLabel(new QLabel(obs_module_text("Settings.Label.Prefix"), this)),
 	  suffixLabel(new QLabel(obs_module_text("Settings.Label.Suffix"), this)),
+	  templateLabel(new QLabel(obs_module_text("Settings.Label.Template"), this)),
 	  prefixLineEdit(new QLineEdit(this)),
 	  suffixLineEdit(new QLineEdit(this)),
+	  templateLineEdit(new QLineEdit(this)),
+	  templateErrorLabel(new QLabel(this)),
 	  sceneComboBox(new QComboBox(this)),
 	  sourceComboBox(new QComboBox(this)),
 	  timeSpinBox(new QSpinBox(this)),
@@ -27,6 +34,12 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	  closeButton(new QPushButton(obs_module_text("Settings.Button.Close"), this)),
 	  displayInTextSourceCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.DisplayInTextSource"), this)),
 	  textSourceGroupBox(new QGroupBox(obs_module_text("Settings.Group.TextSource"), this)),
+	  targetListWidget(new QListWidget(this)),
+	  addTargetButton(new QPushButton(obs_module_text("Settings.Button.AddTarget"), this)),
+	  removeTargetButton(new QPushButton(obs_module_text("Settings.Button.RemoveTarget"), this)),
+	  targetTimeLabel(new QLabel(obs_module_text("Settings.Label.TargetOnScreenTime"), this)),
+	  targetTimeSpinBox(new QSpinBox(this)),
+	  currentTargetIndex(-1),
 	  singleKeyGroupBox(new QGroupBox(obs_module_text("Settings.Group.SingleKeyCapture"), this)),
 	  captureNumpadCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.CaptureNumpad"), this)),
 	  captureNumbersCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.CaptureNumbers"), this)),
@@ -34,7 +47,34 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	  capturePunctuationCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.CapturePunctuation"), this)),
 	  whitelistLabel(new QLabel(obs_module_text("Settings.Label.Whitelist"), this)),
 	  whitelistLineEdit(new QLineEdit(this)),
-	  enableLoggingCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.EnableLogging"), this))
+	  enableLoggingCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.EnableLogging"), this)),
+	  websocketBroadcastCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.WebsocketBroadcast"), this)),
+	  eventSocketCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.EventSocket"), this)),
+	  overlayServerCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.OverlayServer"), this)),
+	  overlayPortLabel(new QLabel(obs_module_text("Settings.Label.OverlayPort"), this)),
+	  overlayPortSpinBox(new QSpinBox(this)),
+	  lowLatencyCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.LowLatency"), this)),
+	  lowLatencyCpuLabel(new QLabel(obs_module_text("Settings.Label.LowLatencyCpu"), this)),
+	  lowLatencyCpuSpinBox(new QSpinBox(this)),
+	  captureGamepadCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.CaptureGamepad"), this)),
+	  gamepadDeadzoneLabel(new QLabel(obs_module_text("Settings.Label.GamepadDeadzone"), this)),
+	  gamepadDeadzoneSpinBox(new QSpinBox(this)),
+	  coalesceLabel(new QLabel(obs_module_text("Settings.Label.CoalesceWindow"), this)),
+	  coalesceSpinBox(new QSpinBox(this)),
+	  captureMouseDragsCheckBox(new QCheckBox(obs_module_text("Settings.Checkbox.CaptureMouseDrags"), this)),
+	  mouseMotionRateLabel(new QLabel(obs_module_text("Settings.Label.MouseMotionRate"), this)),
+	  mouseMotionRateSpinBox(new QSpinBox(this)),
+	  subtitleFormatLabel(new QLabel(obs_module_text("Settings.Label.SubtitleFormat"), this)),
+	  subtitleFormatComboBox(new QComboBox(this)),
+	  sequenceLabel(new QLabel(obs_module_text("Settings.Label.KeySequences"), this)),
+	  sequenceTextEdit(new QPlainTextEdit(this)),
+	  sequenceTimeoutLabel(new QLabel(obs_module_text("Settings.Label.SequenceTimeout"), this)),
+	  sequenceTimeoutSpinBox(new QSpinBox(this)),
+	  actionDictionaryLabel(new QLabel(obs_module_text("Settings.Label.ActionDictionary"), this)),
+	  actionDictionaryLineEdit(new QLineEdit(this)),
+	  actionDictionaryBrowseButton(new QPushButton(obs_module_text("Settings.Button.Browse"), this)),
+	  appProfileLabel(new QLabel(obs_module_text("Settings.Label.AppProfiles"), this)),
+	  appProfileTextEdit(new QPlainTextEdit(this))
 {
 	setWindowTitle(obs_module_text("Settings.Title"));
 	setAccessibleName(obs_module_text("Settings.Title"));
@@ -51,6 +91,17 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	sourceComboBox->setAccessibleName(obs_module_text("Settings.Label.TextSource"));
 	sourceComboBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.TextSource"));
 
+	// Type-ahead search: the combos are editable only to filter their items, never to add new ones
+	for (QComboBox *comboBox : {sceneComboBox, sourceComboBox}) {
+		comboBox->setEditable(true);
+		comboBox->setInsertPolicy(QComboBox::NoInsert);
+		comboBox->completer()->setCompletionMode(QCompleter::PopupCompletion);
+		comboBox->completer()->setFilterMode(Qt::MatchContains);
+		comboBox->completer()->setCaseSensitivity(Qt::CaseInsensitive);
+	}
+	sceneComboBox->lineEdit()->setPlaceholderText(obs_module_text("Settings.Placeholder.SceneSearch"));
+	sourceComboBox->lineEdit()->setPlaceholderText(obs_module_text("Settings.Placeholder.SourceSearch"));
+
 	timeSpinBox->setToolTip(obs_module_text("Settings.Tooltip.OnScreenTime"));
 	timeSpinBox->setAccessibleName(obs_module_text("Settings.Label.OnScreenTime"));
 	timeSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.OnScreenTime"));
@@ -65,6 +116,13 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	suffixLineEdit->setAccessibleDescription(obs_module_text("Settings.Tooltip.Suffix"));
 	suffixLineEdit->setPlaceholderText(obs_module_text("Settings.Placeholder.Suffix"));
 
+	templateLineEdit->setToolTip(obs_module_text("Settings.Tooltip.Template"));
+	templateLineEdit->setAccessibleName(obs_module_text("Settings.Label.Template"));
+	templateLineEdit->setAccessibleDescription(obs_module_text("Settings.Tooltip.Template"));
+	templateLineEdit->setPlaceholderText(obs_module_text("Settings.Placeholder.Template"));
+	templateErrorLabel->setWordWrap(true);
+	templateErrorLabel->setVisible(false);
+
 	applyButton->setToolTip(obs_module_text("Settings.Tooltip.Apply"));
 	applyButton->setAccessibleName(obs_module_text("Settings.Button.Apply"));
 	applyButton->setAccessibleDescription(obs_module_text("Settings.Tooltip.Apply"));
@@ -81,18 +139,116 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 
 	textSourceGroupBox->setAccessibleName(obs_module_text("Settings.Group.TextSource"));
 
+	targetListWidget->setToolTip(obs_module_text("Settings.Tooltip.Targets"));
+	targetListWidget->setAccessibleName(obs_module_text("Settings.Label.Targets"));
+	targetListWidget->setAccessibleDescription(obs_module_text("Settings.Tooltip.Targets"));
+	targetListWidget->setMaximumHeight(100);
+
+	addTargetButton->setToolTip(obs_module_text("Settings.Tooltip.AddTarget"));
+	addTargetButton->setAccessibleName(obs_module_text("Settings.Button.AddTarget"));
+	removeTargetButton->setToolTip(obs_module_text("Settings.Tooltip.RemoveTarget"));
+	removeTargetButton->setAccessibleName(obs_module_text("Settings.Button.RemoveTarget"));
+
+	targetTimeSpinBox->setToolTip(obs_module_text("Settings.Tooltip.TargetOnScreenTime"));
+	targetTimeSpinBox->setAccessibleName(obs_module_text("Settings.Label.TargetOnScreenTime"));
+	targetTimeSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.TargetOnScreenTime"));
+	targetTimeSpinBox->setRange(100, 10000);
+	targetTimeSpinBox->setSingleStep(1);
+
 	// Set accessible properties for labels
 	sceneLabel->setAccessibleName(obs_module_text("Settings.Label.Scene"));
 	sourceLabel->setAccessibleName(obs_module_text("Settings.Label.TextSource"));
 	timeLabel->setAccessibleName(obs_module_text("Settings.Label.OnScreenTime"));
 	prefixLabel->setAccessibleName(obs_module_text("Settings.Label.Prefix"));
 	suffixLabel->setAccessibleName(obs_module_text("Settings.Label.Suffix"));
+	templateLabel->setAccessibleName(obs_module_text("Settings.Label.Template"));
 
 	// Configure timeSpinBox
 	timeSpinBox->setRange(100, 10000);
 	timeSpinBox->setSingleStep(1);
 
-	// Populate sceneComboBox
+	coalesceSpinBox->setToolTip(obs_module_text("Settings.Tooltip.CoalesceWindow"));
+	coalesceSpinBox->setAccessibleName(obs_module_text("Settings.Label.CoalesceWindow"));
+	coalesceSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.CoalesceWindow"));
+	coalesceSpinBox->setRange(0, 5000);
+	coalesceSpinBox->setSingleStep(50);
+	coalesceLabel->setAccessibleName(obs_module_text("Settings.Label.CoalesceWindow"));
+
+	captureMouseDragsCheckBox->setToolTip(obs_module_text("Settings.Tooltip.CaptureMouseDrags"));
+	captureMouseDragsCheckBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.CaptureMouseDrags"));
+	mouseMotionRateSpinBox->setToolTip(obs_module_text("Settings.Tooltip.MouseMotionRate"));
+	mouseMotionRateSpinBox->setAccessibleName(obs_module_text("Settings.Label.MouseMotionRate"));
+	mouseMotionRateSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.MouseMotionRate"));
+	mouseMotionRateSpinBox->setRange(10, 1000);
+	mouseMotionRateSpinBox->setSingleStep(10);
+	mouseMotionRateSpinBox->setSuffix(" Hz");
+	mouseMotionRateLabel->setAccessibleName(obs_module_text("Settings.Label.MouseMotionRate"));
+
+	overlayServerCheckBox->setToolTip(obs_module_text("Settings.Tooltip.OverlayServer"));
+	overlayServerCheckBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.OverlayServer"));
+	overlayPortSpinBox->setToolTip(obs_module_text("Settings.Tooltip.OverlayServer"));
+	overlayPortSpinBox->setAccessibleName(obs_module_text("Settings.Label.OverlayPort"));
+	overlayPortSpinBox->setRange(1024, 65535);
+	overlayPortLabel->setAccessibleName(obs_module_text("Settings.Label.OverlayPort"));
+
+	lowLatencyCheckBox->setToolTip(obs_module_text("Settings.Tooltip.LowLatency"));
+	lowLatencyCheckBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.LowLatency"));
+	lowLatencyCpuSpinBox->setToolTip(obs_module_text("Settings.Tooltip.LowLatencyCpu"));
+	lowLatencyCpuSpinBox->setAccessibleName(obs_module_text("Settings.Label.LowLatencyCpu"));
+	lowLatencyCpuSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.LowLatencyCpu"));
+	lowLatencyCpuSpinBox->setRange(-1, 255);
+	lowLatencyCpuSpinBox->setSpecialValueText(obs_module_text("Settings.LowLatencyCpu.Any"));
+	lowLatencyCpuLabel->setAccessibleName(obs_module_text("Settings.Label.LowLatencyCpu"));
+
+	captureGamepadCheckBox->setToolTip(obs_module_text("Settings.Tooltip.CaptureGamepad"));
+	captureGamepadCheckBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.CaptureGamepad"));
+	gamepadDeadzoneSpinBox->setToolTip(obs_module_text("Settings.Tooltip.GamepadDeadzone"));
+	gamepadDeadzoneSpinBox->setAccessibleName(obs_module_text("Settings.Label.GamepadDeadzone"));
+	gamepadDeadzoneSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.GamepadDeadzone"));
+	gamepadDeadzoneSpinBox->setRange(5, 90);
+	gamepadDeadzoneSpinBox->setSuffix(" %");
+	gamepadDeadzoneLabel->setAccessibleName(obs_module_text("Settings.Label.GamepadDeadzone"));
+
+	subtitleFormatComboBox->addItem(obs_module_text("Settings.SubtitleFormat.None"), "none");
+	subtitleFormatComboBox->addItem(obs_module_text("Settings.SubtitleFormat.Srt"), "srt");
+	subtitleFormatComboBox->addItem(obs_module_text("Settings.SubtitleFormat.WebVtt"), "vtt");
+	subtitleFormatComboBox->addItem(obs_module_text("Settings.SubtitleFormat.Binary"), "binary");
+	subtitleFormatComboBox->setToolTip(obs_module_text("Settings.Tooltip.SubtitleFormat"));
+	subtitleFormatComboBox->setAccessibleName(obs_module_text("Settings.Label.SubtitleFormat"));
+	subtitleFormatComboBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.SubtitleFormat"));
+	subtitleFormatLabel->setAccessibleName(obs_module_text("Settings.Label.SubtitleFormat"));
+
+	sequenceTextEdit->setToolTip(obs_module_text("Settings.Tooltip.KeySequences"));
+	sequenceTextEdit->setAccessibleName(obs_module_text("Settings.Label.KeySequences"));
+	sequenceTextEdit->setAccessibleDescription(obs_module_text("Settings.Tooltip.KeySequences"));
+	sequenceTextEdit->setPlaceholderText(obs_module_text("Settings.Placeholder.KeySequences"));
+	sequenceTextEdit->setTabChangesFocus(true);
+	sequenceTextEdit->setMaximumHeight(100);
+	sequenceLabel->setAccessibleName(obs_module_text("Settings.Label.KeySequences"));
+
+	sequenceTimeoutSpinBox->setToolTip(obs_module_text("Settings.Tooltip.SequenceTimeout"));
+	sequenceTimeoutSpinBox->setAccessibleName(obs_module_text("Settings.Label.SequenceTimeout"));
+	sequenceTimeoutSpinBox->setAccessibleDescription(obs_module_text("Settings.Tooltip.SequenceTimeout"));
+	sequenceTimeoutSpinBox->setRange(100, 10000);
+	sequenceTimeoutSpinBox->setSingleStep(100);
+	sequenceTimeoutLabel->setAccessibleName(obs_module_text("Settings.Label.SequenceTimeout"));
+
+	actionDictionaryLineEdit->setToolTip(obs_module_text("Settings.Tooltip.ActionDictionary"));
+	actionDictionaryLineEdit->setAccessibleName(obs_module_text("Settings.Label.ActionDictionary"));
+	actionDictionaryLineEdit->setAccessibleDescription(obs_module_text("Settings.Tooltip.ActionDictionary"));
+	actionDictionaryLineEdit->setPlaceholderText(obs_module_text("Settings.Placeholder.ActionDictionary"));
+	actionDictionaryBrowseButton->setAccessibleName(obs_module_text("Settings.Button.Browse"));
+	actionDictionaryLabel->setAccessibleName(obs_module_text("Settings.Label.ActionDictionary"));
+
+	appProfileTextEdit->setToolTip(obs_module_text("Settings.Tooltip.AppProfiles"));
+	appProfileTextEdit->setAccessibleName(obs_module_text("Settings.Label.AppProfiles"));
+	appProfileTextEdit->setAccessibleDescription(obs_module_text("Settings.Tooltip.AppProfiles"));
+	appProfileTextEdit->setPlaceholderText(obs_module_text("Settings.Placeholder.AppProfiles"));
+	appProfileTextEdit->setTabChangesFocus(true);
+	appProfileTextEdit->setMaximumHeight(100);
+	appProfileLabel->setAccessibleName(obs_module_text("Settings.Label.AppProfiles"));
+
+	// Populate sceneComboBox (names only; the text sources come from the dock's background index)
 	PopulateSceneComboBox();
 
 	// Add widgets to layouts
@@ -108,12 +264,28 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	suffixLayout->addWidget(suffixLabel);
 	suffixLayout->addWidget(suffixLineEdit);
 
+	templateLayout->addWidget(templateLabel);
+	templateLayout->addWidget(templateLineEdit);
+
+	QHBoxLayout *targetButtonLayout = new QHBoxLayout();
+	targetButtonLayout->addWidget(addTargetButton);
+	targetButtonLayout->addWidget(removeTargetButton);
+
+	QHBoxLayout *targetTimeLayout = new QHBoxLayout();
+	targetTimeLayout->addWidget(targetTimeLabel);
+	targetTimeLayout->addWidget(targetTimeSpinBox);
+
 	// Create and configure textSourceGroupBox layout
 	QVBoxLayout *textSourceLayout = new QVBoxLayout();
+	textSourceLayout->addWidget(targetListWidget);
+	textSourceLayout->addLayout(targetButtonLayout);
 	textSourceLayout->addLayout(sceneLayout);
 	textSourceLayout->addLayout(sourceLayout);
 	textSourceLayout->addLayout(prefixLayout);
 	textSourceLayout->addLayout(suffixLayout);
+	textSourceLayout->addLayout(templateLayout);
+	textSourceLayout->addWidget(templateErrorLabel);
+	textSourceLayout->addLayout(targetTimeLayout);
 	textSourceGroupBox->setLayout(textSourceLayout);
 
 	// Create and configure time layout
@@ -121,6 +293,39 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 	timeLayout->addWidget(timeLabel);
 	timeLayout->addWidget(timeSpinBox);
 
+	QHBoxLayout *overlayPortLayout = new QHBoxLayout();
+	overlayPortLayout->addWidget(overlayPortLabel);
+	overlayPortLayout->addWidget(overlayPortSpinBox);
+
+	QHBoxLayout *lowLatencyCpuLayout = new QHBoxLayout();
+	lowLatencyCpuLayout->addWidget(lowLatencyCpuLabel);
+	lowLatencyCpuLayout->addWidget(lowLatencyCpuSpinBox);
+
+	QHBoxLayout *gamepadDeadzoneLayout = new QHBoxLayout();
+	gamepadDeadzoneLayout->addWidget(gamepadDeadzoneLabel);
+	gamepadDeadzoneLayout->addWidget(gamepadDeadzoneSpinBox);
+
+	QHBoxLayout *coalesceLayout = new QHBoxLayout();
+	coalesceLayout->addWidget(coalesceLabel);
+	coalesceLayout->addWidget(coalesceSpinBox);
+
+	QHBoxLayout *mouseMotionRateLayout = new QHBoxLayout();
+	mouseMotionRateLayout->addWidget(mouseMotionRateLabel);
+	mouseMotionRateLayout->addWidget(mouseMotionRateSpinBox);
+
+	QHBoxLayout *subtitleFormatLayout = new QHBoxLayout();
+	subtitleFormatLayout->addWidget(subtitleFormatLabel);
+	subtitleFormatLayout->addWidget(subtitleFormatComboBox);
+
+	QHBoxLayout *sequenceTimeoutLayout = new QHBoxLayout();
+	sequenceTimeoutLayout->addWidget(sequenceTimeoutLabel);
+	sequenceTimeoutLayout->addWidget(sequenceTimeoutSpinBox);
+
+	QHBoxLayout *actionDictionaryLayout = new QHBoxLayout();
+	actionDictionaryLayout->addWidget(actionDictionaryLabel);
+	actionDictionaryLayout->addWidget(actionDictionaryLineEdit);
+	actionDictionaryLayout->addWidget(actionDictionaryBrowseButton);
+
 	buttonLayout->addWidget(applyButton);
 	buttonLayout->addWidget(closeButton);
 
@@ -144,30 +349,95 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 
 	// Set tooltip for logging checkbox
 	enableLoggingCheckBox->setToolTip(obs_module_text("Settings.Tooltip.EnableLogging"));
+	websocketBroadcastCheckBox->setToolTip(obs_module_text("Settings.Tooltip.WebsocketBroadcast"));
+	eventSocketCheckBox->setToolTip(obs_module_text("Settings.Tooltip.EventSocket"));
+#ifdef _WIN32
+	eventSocketCheckBox->setVisible(false);
+	overlayServerCheckBox->setVisible(false);
+	overlayPortLabel->setVisible(false);
+	overlayPortSpinBox->setVisible(false);
+#endif
+#ifndef __linux__
+	// The active window is only tracked by the X11 backend
+	appProfileLabel->setVisible(false);
+	appProfileTextEdit->setVisible(false);
+	// Controllers are read from /dev/input
+	captureGamepadCheckBox->setVisible(false);
+	gamepadDeadzoneLabel->setVisible(false);
+	gamepadDeadzoneSpinBox->setVisible(false);
+#endif
 
 	mainLayout->addWidget(displayInTextSourceCheckBox);
 	mainLayout->addWidget(textSourceGroupBox); // Add the group box to the main layout
 	mainLayout->addWidget(singleKeyGroupBox); // Add the single key capture group box
 	mainLayout->addWidget(enableLoggingCheckBox); // Add the logging checkbox
+	mainLayout->addWidget(websocketBroadcastCheckBox);
+	mainLayout->addWidget(eventSocketCheckBox);
+	mainLayout->addWidget(overlayServerCheckBox);
+	mainLayout->addLayout(overlayPortLayout);
+	mainLayout->addWidget(lowLatencyCheckBox);
+	mainLayout->addLayout(lowLatencyCpuLayout);
+	mainLayout->addWidget(captureGamepadCheckBox);
+	mainLayout->addLayout(gamepadDeadzoneLayout);
 	mainLayout->addLayout(timeLayout);         // Add the time layout to the main layout
+	mainLayout->addLayout(coalesceLayout);
+	mainLayout->addWidget(captureMouseDragsCheckBox);
+	mainLayout->addLayout(mouseMotionRateLayout);
+	mainLayout->addLayout(subtitleFormatLayout);
+	mainLayout->addWidget(sequenceLabel);
+	mainLayout->addWidget(sequenceTextEdit);
+	mainLayout->addLayout(sequenceTimeoutLayout);
+	mainLayout->addLayout(actionDictionaryLayout);
+	mainLayout->addWidget(appProfileLabel);
+	mainLayout->addWidget(appProfileTextEdit);
 	mainLayout->addLayout(buttonLayout);
 	setLayout(mainLayout);
 
 	// Set up proper tab order for keyboard navigation
-	setTabOrder(displayInTextSourceCheckBox, sceneComboBox);
+	setTabOrder(displayInTextSourceCheckBox, targetListWidget);
+	setTabOrder(targetListWidget, addTargetButton);
+	setTabOrder(addTargetButton, removeTargetButton);
+	setTabOrder(removeTargetButton, sceneComboBox);
 	setTabOrder(sceneComboBox, sourceComboBox);
 	setTabOrder(sourceComboBox, prefixLineEdit);
 	setTabOrder(prefixLineEdit, suffixLineEdit);
-	setTabOrder(suffixLineEdit, timeSpinBox);
-	setTabOrder(timeSpinBox, applyButton);
+	setTabOrder(suffixLineEdit, templateLineEdit);
+	setTabOrder(templateLineEdit, targetTimeSpinBox);
+	setTabOrder(targetTimeSpinBox, timeSpinBox);
+	setTabOrder(timeSpinBox, overlayServerCheckBox);
+	setTabOrder(overlayServerCheckBox, overlayPortSpinBox);
+	setTabOrder(overlayPortSpinBox, lowLatencyCheckBox);
+	setTabOrder(lowLatencyCheckBox, lowLatencyCpuSpinBox);
+	setTabOrder(lowLatencyCpuSpinBox, captureGamepadCheckBox);
+	setTabOrder(captureGamepadCheckBox, gamepadDeadzoneSpinBox);
+	setTabOrder(gamepadDeadzoneSpinBox, coalesceSpinBox);
+	setTabOrder(coalesceSpinBox, captureMouseDragsCheckBox);
+	setTabOrder(captureMouseDragsCheckBox, mouseMotionRateSpinBox);
+	setTabOrder(mouseMotionRateSpinBox, subtitleFormatComboBox);
+	setTabOrder(subtitleFormatComboBox, sequenceTextEdit);
+	setTabOrder(sequenceTextEdit, sequenceTimeoutSpinBox);
+	setTabOrder(sequenceTimeoutSpinBox, actionDictionaryLineEdit);
+	setTabOrder(actionDictionaryLineEdit, actionDictionaryBrowseButton);
+	setTabOrder(actionDictionaryBrowseButton, appProfileTextEdit);
+	setTabOrder(appProfileTextEdit, applyButton);
 	setTabOrder(applyButton, closeButton);
 
 	// Connect signals to slots
 	connect(applyButton, &QPushButton::clicked, this, &StreamupHotkeyDisplaySettings::applySettings);
 	connect(closeButton, &QPushButton::clicked, this, &StreamupHotkeyDisplaySettings::close);
-	connect(sceneComboBox, &QComboBox::currentTextChanged, this, &StreamupHotkeyDisplaySettings::onSceneChanged);
+	// Only a chosen scene counts, not every keystroke of a search
+	connect(sceneComboBox, &QComboBox::currentIndexChanged, this,
+		[this]() { onSceneChanged(sceneComboBox->currentText()); });
+	connect(&hotkeyDisplayDock->getSceneSourceIndex(), &SceneSourceIndex::sceneIndexed, this,
+		&StreamupHotkeyDisplaySettings::onSceneIndexed);
+	connect(templateLineEdit, &QLineEdit::textChanged, this, &StreamupHotkeyDisplaySettings::onTemplateChanged);
+	connect(targetListWidget, &QListWidget::currentRowChanged, this,
+		&StreamupHotkeyDisplaySettings::onTargetSelectionChanged);
+	connect(addTargetButton, &QPushButton::clicked, this, &StreamupHotkeyDisplaySettings::addTarget);
+	connect(removeTargetButton, &QPushButton::clicked, this, &StreamupHotkeyDisplaySettings::removeTarget);
 	connect(displayInTextSourceCheckBox, &QCheckBox::toggled, this,
 		&StreamupHotkeyDisplaySettings::onDisplayInTextSourceToggled); // Connect checkbox toggle
+	connect(actionDictionaryBrowseButton, &QPushButton::clicked, this, &StreamupHotkeyDisplaySettings::browseActionDictionary);
 
 	// Load current settings
 	obs_data_t *settings = SaveLoadSettingsCallback(nullptr, false);
@@ -180,21 +450,15 @@ StreamupHotkeyDisplaySettings::StreamupHotkeyDisplaySettings(HotkeyDisplayDock *
 void StreamupHotkeyDisplaySettings::LoadSettings(obs_data_t *settings)
 {
 	// Existing settings
-	sceneName = QString::fromUtf8(obs_data_get_string(settings, "sceneName"));
-	sceneComboBox->setCurrentText(sceneName);
-	PopulateSourceComboBox(sceneName);
-	textSource = QString::fromUtf8(obs_data_get_string(settings, "textSource"));
-	sourceComboBox->setCurrentText(textSource);
 	onScreenTime = obs_data_get_int(settings, "onScreenTime");
 	timeSpinBox->setValue(onScreenTime);
 	displayInTextSource = obs_data_get_bool(settings, "displayInTextSource");
 	displayInTextSourceCheckBox->setChecked(displayInTextSource);
 
-	// New settings
-	QString prefix = QString::fromUtf8(obs_data_get_string(settings, "prefix"));
-	prefixLineEdit->setText(prefix);
-	QString suffix = QString::fromUtf8(obs_data_get_string(settings, "suffix"));
-	suffixLineEdit->setText(suffix);
+	// Output targets (migrates the legacy single scene/source pair)
+	outputTargets = loadOutputTargets(settings);
+	currentTargetIndex = -1;
+	refreshTargetList();
 
 	// Single key capture settings
 	captureNumpad = obs_data_get_bool(settings, "captureNumpad");
@@ -212,6 +476,67 @@ void StreamupHotkeyDisplaySettings::LoadSettings(obs_data_t *settings)
 	enableLogging = obs_data_get_bool(settings, "enableLogging");
 	enableLoggingCheckBox->setChecked(enableLogging);
 
+	// Websocket broadcast (kept on for settings saved before it existed)
+	websocketBroadcast = !obs_data_has_user_value(settings, "websocketBroadcast") ||
+			     obs_data_get_bool(settings, "websocketBroadcast");
+	websocketBroadcastCheckBox->setChecked(websocketBroadcast);
+
+	// Local event socket
+	eventSocketEnabled = obs_data_get_bool(settings, "eventSocketEnabled");
+	eventSocketCheckBox->setChecked(eventSocketEnabled);
+
+	// Browser overlay server
+	overlayServerEnabled = obs_data_get_bool(settings, "overlayServerEnabled");
+	overlayServerCheckBox->setChecked(overlayServerEnabled);
+	overlayServerPort = obs_data_has_user_value(settings, "overlayServerPort")
+				    ? (int)obs_data_get_int(settings, "overlayServerPort")
+				    : StyleConstants::DEFAULT_OVERLAY_PORT;
+	overlayPortSpinBox->setValue(overlayServerPort);
+
+	// Low-latency capture
+	lowLatencyMode = obs_data_get_bool(settings, "lowLatencyMode");
+	lowLatencyCheckBox->setChecked(lowLatencyMode);
+	lowLatencyCpu = obs_data_has_user_value(settings, "lowLatencyCpu") ? (int)obs_data_get_int(settings, "lowLatencyCpu") : -1;
+	lowLatencyCpuSpinBox->setValue(lowLatencyCpu);
+
+	// Gamepad capture
+	captureGamepad = obs_data_get_bool(settings, "captureGamepad");
+	captureGamepadCheckBox->setChecked(captureGamepad);
+	gamepadDeadzone = obs_data_has_user_value(settings, "gamepadDeadzone") ? (int)obs_data_get_int(settings, "gamepadDeadzone")
+										: StyleConstants::DEFAULT_GAMEPAD_DEADZONE;
+	gamepadDeadzoneSpinBox->setValue(gamepadDeadzone);
+
+	// Mouse burst merging (0 is a valid value, so fall back only when unset)
+	coalesceWindow = obs_data_has_user_value(settings, "coalesceWindow") ? (int)obs_data_get_int(settings, "coalesceWindow")
+									      : StyleConstants::DEFAULT_COALESCE_WINDOW;
+	coalesceSpinBox->setValue(coalesceWindow);
+
+	// Drag gestures
+	captureMouseDrags = obs_data_get_bool(settings, "captureMouseDrags");
+	captureMouseDragsCheckBox->setChecked(captureMouseDrags);
+	mouseMotionRate = obs_data_has_user_value(settings, "mouseMotionRate") ? (int)obs_data_get_int(settings, "mouseMotionRate")
+										: StyleConstants::DEFAULT_MOUSE_MOTION_RATE;
+	mouseMotionRateSpinBox->setValue(mouseMotionRate);
+
+	// Recording subtitles (unknown values fall back to none)
+	subtitleFormat = QString::fromUtf8(obs_data_get_string(settings, "subtitleFormat"));
+	subtitleFormatComboBox->setCurrentIndex(std::max(subtitleFormatComboBox->findData(subtitleFormat), 0));
+
+	// Multi-stroke sequences
+	keySequences = QString::fromUtf8(obs_data_get_string(settings, "keySequences"));
+	sequenceTextEdit->setPlainText(keySequences);
+	sequenceTimeout = obs_data_has_user_value(settings, "sequenceTimeout") ? (int)obs_data_get_int(settings, "sequenceTimeout")
+										: StyleConstants::DEFAULT_SEQUENCE_TIMEOUT;
+	sequenceTimeoutSpinBox->setValue(sequenceTimeout);
+
+	// Shortcut dictionary
+	actionDictionaryPath = QString::fromUtf8(obs_data_get_string(settings, "actionDictionary"));
+	actionDictionaryLineEdit->setText(actionDictionaryPath);
+
+	// Per-application profiles
+	appProfiles = QString::fromUtf8(obs_data_get_string(settings, "appProfiles"));
+	appProfileTextEdit->setPlainText(appProfiles);
+
 	onDisplayInTextSourceToggled(displayInTextSource); // Set initial visibility of related settings
 }
 
@@ -220,14 +545,12 @@ void StreamupHotkeyDisplaySettings::SaveSettings()
 	obs_data_t *settings = obs_data_create();
 
 	// Existing settings
-	obs_data_set_string(settings, "sceneName", sceneComboBox->currentText().toUtf8().constData());
-	obs_data_set_string(settings, "textSource", sourceComboBox->currentText().toUtf8().constData());
 	obs_data_set_int(settings, "onScreenTime", timeSpinBox->value());
 	obs_data_set_bool(settings, "displayInTextSource", displayInTextSourceCheckBox->isChecked());
 
-	// New settings
-	obs_data_set_string(settings, "prefix", prefixLineEdit->text().toUtf8().constData());
-	obs_data_set_string(settings, "suffix", suffixLineEdit->text().toUtf8().constData());
+	// Output targets
+	storeCurrentTarget();
+	saveOutputTargets(settings, outputTargets);
 
 	// Single key capture settings
 	obs_data_set_bool(settings, "captureNumpad", captureNumpadCheckBox->isChecked());
@@ -239,18 +562,53 @@ void StreamupHotkeyDisplaySettings::SaveSettings()
 	// Logging settings
 	obs_data_set_bool(settings, "enableLogging", enableLoggingCheckBox->isChecked());
 
+	// Websocket broadcast
+	obs_data_set_bool(settings, "websocketBroadcast", websocketBroadcastCheckBox->isChecked());
+
+	// Local event socket
+	obs_data_set_bool(settings, "eventSocketEnabled", eventSocketCheckBox->isChecked());
+
+	// Browser overlay server
+	obs_data_set_bool(settings, "overlayServerEnabled", overlayServerCheckBox->isChecked());
+	obs_data_set_int(settings, "overlayServerPort", overlayPortSpinBox->value());
+
+	// Low-latency capture
+	obs_data_set_bool(settings, "lowLatencyMode", lowLatencyCheckBox->isChecked());
+	obs_data_set_int(settings, "lowLatencyCpu", lowLatencyCpuSpinBox->value());
+
+	// Gamepad capture
+	obs_data_set_bool(settings, "captureGamepad", captureGamepadCheckBox->isChecked());
+	obs_data_set_int(settings, "gamepadDeadzone", gamepadDeadzoneSpinBox->value());
+
+	// Mouse burst merging
+	obs_data_set_int(settings, "coalesceWindow", coalesceSpinBox->value());
+
+	// Drag gestures
+	obs_data_set_bool(settings, "captureMouseDrags", captureMouseDragsCheckBox->isChecked());
+	obs_data_set_int(settings, "mouseMotionRate", mouseMotionRateSpinBox->value());
+
+	// Recording subtitles
+	obs_data_set_string(settings, "subtitleFormat", subtitleFormatComboBox->currentData().toString().toUtf8().constData());
+
+	// Multi-stroke sequences
+	obs_data_set_string(settings, "keySequences", sequenceTextEdit->toPlainText().toUtf8().constData());
+	obs_data_set_int(settings, "sequenceTimeout", sequenceTimeoutSpinBox->value());
+
+	// Shortcut dictionary
+	obs_data_set_string(settings, "actionDictionary", actionDictionaryLineEdit->text().trimmed().toUtf8().constData());
+
+	// Per-application profiles
+	obs_data_set_string(settings, "appProfiles", appProfileTextEdit->toPlainText().toUtf8().constData());
+
 	SaveLoadSettingsCallback(settings, true);
 	obs_data_release(settings);
 }
 
 void StreamupHotkeyDisplaySettings::applySettings()
 {
-	sceneName = sceneComboBox->currentText();
-	textSource = sourceComboBox->currentText();
+	storeCurrentTarget();
 	onScreenTime = timeSpinBox->value();
 	displayInTextSource = displayInTextSourceCheckBox->isChecked();
-	QString newPrefix = prefixLineEdit->text();
-	QString newSuffix = suffixLineEdit->text();
 
 	// Single key capture settings
 	captureNumpad = captureNumpadCheckBox->isChecked();
@@ -262,14 +620,50 @@ void StreamupHotkeyDisplaySettings::applySettings()
 	// Logging settings
 	enableLogging = enableLoggingCheckBox->isChecked();
 
+	// Websocket broadcast
+	websocketBroadcast = websocketBroadcastCheckBox->isChecked();
+
+	// Local event socket
+	eventSocketEnabled = eventSocketCheckBox->isChecked();
+
+	// Browser overlay server
+	overlayServerEnabled = overlayServerCheckBox->isChecked();
+	overlayServerPort = overlayPortSpinBox->value();
+
+	// Low-latency capture
+	lowLatencyMode = lowLatencyCheckBox->isChecked();
+	lowLatencyCpu = lowLatencyCpuSpinBox->value();
+
+	// Gamepad capture
+	captureGamepad = captureGamepadCheckBox->isChecked();
+	gamepadDeadzone = gamepadDeadzoneSpinBox->value();
+
+	// Mouse burst merging
+	coalesceWindow = coalesceSpinBox->value();
+
+	// Drag gestures
+	captureMouseDrags = captureMouseDragsCheckBox->isChecked();
+	mouseMotionRate = mouseMotionRateSpinBox->value();
+
+	// Recording subtitles
+	subtitleFormat = subtitleFormatComboBox->currentData().toString();
+
+	// Multi-stroke sequences
+	keySequences = sequenceTextEdit->toPlainText();
+	sequenceTimeout = sequenceTimeoutSpinBox->value();
+
+	// Shortcut dictionary
+	actionDictionaryPath = actionDictionaryLineEdit->text().trimmed();
+
+	// Per-application profiles
+	appProfiles = appProfileTextEdit->toPlainText();
+
 	SaveSettings();
 
 	if (hotkeyDisplayDock) {
-		hotkeyDisplayDock->sceneName = sceneName;
-		hotkeyDisplayDock->textSource = textSource;
+		hotkeyDisplayDock->setOutputTargets(outputTargets);
+		hotkeyDisplayDock->resolveOutputTargets();
 		hotkeyDisplayDock->onScreenTime = onScreenTime;
-		hotkeyDisplayDock->prefix = newPrefix;
-		hotkeyDisplayDock->suffix = newSuffix;
 		hotkeyDisplayDock->setDisplayInTextSource(displayInTextSource); // Apply the setting to the dock
 	}
 
@@ -284,70 +678,185 @@ void StreamupHotkeyDisplaySettings::applySettings()
 	accept(); // Close the dialog
 }
 
+void StreamupHotkeyDisplaySettings::storeCurrentTarget()
+{
+	if (currentTargetIndex < 0 || currentTargetIndex >= (int)outputTargets.size()) {
+		return;
+	}
+
+	// Half-typed searches that match no item keep the stored names
+	OutputTargetConfig &target = outputTargets[currentTargetIndex];
+	if (sceneComboBox->findText(sceneComboBox->currentText()) >= 0) {
+		target.sceneName = sceneComboBox->currentText();
+	}
+	if (sourceComboBox->findText(sourceComboBox->currentText()) >= 0) {
+		target.textSource = sourceComboBox->currentText();
+	}
+	target.prefix = prefixLineEdit->text();
+	target.suffix = suffixLineEdit->text();
+	target.textTemplate = templateLineEdit->text();
+	target.onScreenTime = targetTimeSpinBox->value();
+
+	if (QListWidgetItem *item = targetListWidget->item(currentTargetIndex)) {
+		item->setText(target.displayName());
+	}
+}
+
+void StreamupHotkeyDisplaySettings::loadTarget(int index)
+{
+	currentTargetIndex = index;
+
+	bool hasTarget = index >= 0 && index < (int)outputTargets.size();
+	sceneComboBox->setEnabled(hasTarget);
+	sourceComboBox->setEnabled(hasTarget);
+	prefixLineEdit->setEnabled(hasTarget);
+	suffixLineEdit->setEnabled(hasTarget);
+	templateLineEdit->setEnabled(hasTarget);
+	targetTimeSpinBox->setEnabled(hasTarget);
+	removeTargetButton->setEnabled(hasTarget);
+
+	if (!hasTarget) {
+		return;
+	}
+
+	const OutputTargetConfig &target = outputTargets[index];
+	// Scenes that no longer exist stay visible as text rather than silently switching to another one
+	sceneComboBox->blockSignals(true);
+	int sceneIndex = sceneComboBox->findText(target.sceneName);
+	if (sceneIndex >= 0) {
+		sceneComboBox->setCurrentIndex(sceneIndex);
+	} else {
+		sceneComboBox->setEditText(target.sceneName);
+	}
+	sceneComboBox->blockSignals(false);
+	PopulateSourceComboBox(target.sceneName, target.textSource);
+	prefixLineEdit->setText(target.prefix);
+	suffixLineEdit->setText(target.suffix);
+	templateLineEdit->setText(target.textTemplate);
+	targetTimeSpinBox->setValue(target.onScreenTime);
+}
+
+void StreamupHotkeyDisplaySettings::refreshTargetList()
+{
+	targetListWidget->blockSignals(true);
+	targetListWidget->clear();
+	for (const OutputTargetConfig &target : outputTargets) {
+		targetListWidget->addItem(target.displayName());
+	}
+	targetListWidget->blockSignals(false);
+
+	int index = outputTargets.empty() ? -1 : 0;
+	targetListWidget->setCurrentRow(index);
+	loadTarget(index);
+}
+
+void StreamupHotkeyDisplaySettings::onTargetSelectionChanged(int row)
+{
+	storeCurrentTarget();
+	loadTarget(row);
+}
+
+void StreamupHotkeyDisplaySettings::addTarget()
+{
+	storeCurrentTarget();
+
+	OutputTargetConfig target;
+	if (sceneComboBox->count() > 0) {
+		target.sceneName = sceneComboBox->itemText(0);
+	}
+	outputTargets.push_back(target);
+	targetListWidget->addItem(target.displayName());
+
+	// Selecting the new row stores nothing (already stored above) and loads the new entry
+	currentTargetIndex = -1;
+	targetListWidget->setCurrentRow((int)outputTargets.size() - 1);
+}
+
+void StreamupHotkeyDisplaySettings::removeTarget()
+{
+	int row = targetListWidget->currentRow();
+	if (row < 0 || row >= (int)outputTargets.size()) {
+		return;
+	}
+
+	outputTargets.erase(outputTargets.begin() + row);
+	currentTargetIndex = -1;
+
+	targetListWidget->blockSignals(true);
+	delete targetListWidget->takeItem(row);
+	targetListWidget->blockSignals(false);
+
+	int next = std::min(row, (int)outputTargets.size() - 1);
+	targetListWidget->setCurrentRow(next);
+	loadTarget(next);
+}
+
 void StreamupHotkeyDisplaySettings::onSceneChanged(const QString &sceneName)
 {
-	QString previousSource = sourceComboBox->currentText();
-	PopulateSourceComboBox(sceneName);
-	if (!previousSource.isEmpty()) {
-		sourceComboBox->setCurrentText(previousSource);
+	PopulateSourceComboBox(sceneName, sourceComboBox->currentText());
+}
+
+void StreamupHotkeyDisplaySettings::onSceneIndexed(const QString &sceneName)
+{
+	if (sceneName == sceneComboBox->currentText()) {
+		PopulateSourceComboBox(sceneName, sourceComboBox->currentText());
 	}
 }
 
+void StreamupHotkeyDisplaySettings::onTemplateChanged(const QString &text)
+{
+	// Compiled the same way the output targets do, so mistakes show while typing
+	OutputTemplate compiled;
+	std::string error;
+	QByteArray textUtf8 = text.toUtf8();
+	bool valid = text.isEmpty() || compiled.compile(std::string_view(textUtf8.constData(), textUtf8.size()), error);
+	templateErrorLabel->setText(
+		valid ? QString() : QString(obs_module_text("Settings.Template.Error")).arg(QString::fromStdString(error)));
+	templateErrorLabel->setVisible(!valid);
+}
+
 void StreamupHotkeyDisplaySettings::PopulateSceneComboBox()
 {
+	sceneComboBox->blockSignals(true);
 	sceneComboBox->clear();
 
+	// Only the scene list itself, in the user's order; it is a cheap walk over the frontend's list
 	struct obs_frontend_source_list scenes = {{{0}}};
 	obs_frontend_get_scenes(&scenes);
 
+	QStringList names;
 	for (size_t i = 0; i < scenes.sources.num; i++) {
-		obs_source_t *source = scenes.sources.array[i];
-		const char *name = obs_source_get_name(source);
-		sceneComboBox->addItem(QString::fromUtf8(name));
+		names.append(QString::fromUtf8(obs_source_get_name(scenes.sources.array[i])));
 	}
+	sceneComboBox->addItems(names);
 
 	obs_frontend_source_list_free(&scenes);
+	sceneComboBox->blockSignals(false);
 }
 
-void StreamupHotkeyDisplaySettings::PopulateSourceComboBox(const QString &sceneName)
+void StreamupHotkeyDisplaySettings::PopulateSourceComboBox(const QString &sceneName, const QString &selection)
 {
+	sourceComboBox->blockSignals(true);
 	sourceComboBox->clear();
 
-	obs_source_t *scene = obs_get_source_by_name(sceneName.toUtf8().constData());
-	if (!scene) {
-		sourceComboBox->addItem(StyleConstants::NO_TEXT_SOURCE);
-		return;
+	QStringList sources;
+	if (!hotkeyDisplayDock->getSceneSourceIndex().textSources(sceneName, sources)) {
+		// Not indexed yet: keep the current choice selectable until sceneIndexed() refills the list
+		sourceComboBox->lineEdit()->setPlaceholderText(obs_module_text("Settings.Placeholder.SourceLoading"));
+		if (!selection.isEmpty() && selection != StyleConstants::NO_TEXT_SOURCE) {
+			sourceComboBox->addItem(selection);
+		}
+	} else {
+		sourceComboBox->lineEdit()->setPlaceholderText(obs_module_text("Settings.Placeholder.SourceSearch"));
+		if (sources.isEmpty()) {
+			sources.append(StyleConstants::NO_TEXT_SOURCE);
+		}
+		sourceComboBox->addItems(sources);
 	}
 
-	obs_scene_t *sceneAsScene = obs_scene_from_source(scene);
-	obs_scene_enum_items(
-		sceneAsScene,
-		[](obs_scene_t * /*scene*/, obs_sceneitem_t *item, void *param) {
-			StreamupHotkeyDisplaySettings *settingsDialog = static_cast<StreamupHotkeyDisplaySettings *>(param);
-			obs_source_t *source = obs_sceneitem_get_source(item);
-			const char *sourceId = obs_source_get_id(source);
-
-			// Support all text source types across platforms
-			// Windows: text_gdiplus, text_gdiplus_v3
-			// Cross-platform: text_ft2_source_v2, text_ft2_source
-			// Linux: text_pango_source
-			if (strcmp(sourceId, "text_gdiplus") == 0 ||
-			    strcmp(sourceId, "text_gdiplus_v3") == 0 ||
-			    strcmp(sourceId, "text_ft2_source_v2") == 0 ||
-			    strcmp(sourceId, "text_ft2_source") == 0 ||
-			    strcmp(sourceId, "text_pango_source") == 0) {
-				const char *sourceName = obs_source_get_name(source);
-				settingsDialog->sourceComboBox->addItem(QString::fromUtf8(sourceName));
-			}
-			return true;
-		},
-		this);
-
-	obs_source_release(scene);
-
-	if (sourceComboBox->count() == 0) {
-		sourceComboBox->addItem(StyleConstants::NO_TEXT_SOURCE);
-	}
+	int selected = sourceComboBox->findText(selection);
+	sourceComboBox->setCurrentIndex(selected >= 0 ? selected : 0);
+	sourceComboBox->blockSignals(false);
 }
 
 void StreamupHotkeyDisplaySettings::onDisplayInTextSourceToggled(bool checked)
@@ -355,3 +864,13 @@ void StreamupHotkeyDisplaySettings::onDisplayInTextSourceToggled(bool checked)
 	textSourceGroupBox->setVisible(checked);
 	adjustSize();
 }
+
+void StreamupHotkeyDisplaySettings::browseActionDictionary()
+{
+	QString path = QFileDialog::getOpenFileName(this, obs_module_text("Settings.Label.ActionDictionary"),
+						    actionDictionaryLineEdit->text(),
+						    obs_module_text("Settings.Filter.ActionDictionary"));
+	if (!path.isEmpty()) {
+		actionDictionaryLineEdit->setText(path);
+	}
+}
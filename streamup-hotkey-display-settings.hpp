@@ -13,6 +13,9 @@
 #include <QLineEdit>
 #include <QCheckBox>
 #include <QGroupBox>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <vector>
 #include <obs-frontend-api.h>
 #include "streamup-hotkey-display-dock.hpp"
 
@@ -25,10 +28,10 @@ public:
 	void SaveSettings();
 
 	void PopulateSceneComboBox();
-	void PopulateSourceComboBox(const QString &sceneName);
+	// Fills the text sources of the scene from the dock's index and selects selection if present
+	void PopulateSourceComboBox(const QString &sceneName, const QString &selection);
 
-	QString sceneName;
-	QString textSource;
+	std::vector<OutputTargetConfig> outputTargets;
 	int onScreenTime;
 	bool displayInTextSource;
 
@@ -42,6 +45,42 @@ public:
 	// Logging settings
 	bool enableLogging;
 
+	// Per-chord obs-websocket broadcast (key_pressed and friends)
+	bool websocketBroadcast;
+
+	// Local event socket and browser overlay server (macOS / Linux)
+	bool eventSocketEnabled;
+	bool overlayServerEnabled;
+	int overlayServerPort;
+
+	// Low-latency capture: raised thread priority, locked event rings, optional CPU (-1 = any)
+	bool lowLatencyMode;
+	int lowLatencyCpu;
+
+	// Gamepad and joystick capture (Linux evdev) and the stick deadzone (%)
+	bool captureGamepad;
+	int gamepadDeadzone;
+
+	// Mouse burst merging window (ms)
+	int coalesceWindow;
+
+	// Drag gestures and the drag path sample rate (Hz)
+	bool captureMouseDrags;
+	int mouseMotionRate;
+
+	// Recording subtitle sidecar format ("none", "srt", "vtt" or "binary")
+	QString subtitleFormat;
+
+	// Multi-stroke sequences, one "Ctrl + X, Ctrl + S = Save" per line, and the step timeout (ms)
+	QString keySequences;
+	int sequenceTimeout;
+
+	// Compiled shortcut dictionary (.suhkact) that labels chords with their action
+	QString actionDictionaryPath;
+
+	// Per-application capture profiles, "[window class]" sections (Linux)
+	QString appProfiles;
+
 private:
 	HotkeyDisplayDock *hotkeyDisplayDock;
 	QVBoxLayout *mainLayout;
@@ -51,13 +90,17 @@ private:
 	QHBoxLayout *timeLayout;
 	QHBoxLayout *prefixLayout;
 	QHBoxLayout *suffixLayout;
+	QHBoxLayout *templateLayout;
 	QLabel *sceneLabel;
 	QLabel *sourceLabel;
 	QLabel *timeLabel;
 	QLabel *prefixLabel;
 	QLabel *suffixLabel;
+	QLabel *templateLabel;
 	QLineEdit *prefixLineEdit;
 	QLineEdit *suffixLineEdit;
+	QLineEdit *templateLineEdit;
+	QLabel *templateErrorLabel;
 	QComboBox *sceneComboBox;
 	QComboBox *sourceComboBox;
 	QSpinBox *timeSpinBox;
@@ -66,6 +109,14 @@ private:
 	QCheckBox *displayInTextSourceCheckBox;
 	QGroupBox *textSourceGroupBox;
 
+	// Output target list UI elements
+	QListWidget *targetListWidget;
+	QPushButton *addTargetButton;
+	QPushButton *removeTargetButton;
+	QLabel *targetTimeLabel;
+	QSpinBox *targetTimeSpinBox;
+	int currentTargetIndex;
+
 	// Single key capture UI elements
 	QGroupBox *singleKeyGroupBox;
 	QCheckBox *captureNumpadCheckBox;
@@ -77,11 +128,64 @@ private:
 
 	// Logging UI elements
 	QCheckBox *enableLoggingCheckBox;
+	QCheckBox *websocketBroadcastCheckBox;
+	QCheckBox *eventSocketCheckBox;
+	QCheckBox *overlayServerCheckBox;
+	QLabel *overlayPortLabel;
+	QSpinBox *overlayPortSpinBox;
+
+	// Low-latency capture UI elements
+	QCheckBox *lowLatencyCheckBox;
+	QLabel *lowLatencyCpuLabel;
+	QSpinBox *lowLatencyCpuSpinBox;
+
+	// Gamepad capture UI elements
+	QCheckBox *captureGamepadCheckBox;
+	QLabel *gamepadDeadzoneLabel;
+	QSpinBox *gamepadDeadzoneSpinBox;
+
+	// Mouse burst merging UI elements
+	QLabel *coalesceLabel;
+	QSpinBox *coalesceSpinBox;
+
+	// Drag gesture UI elements
+	QCheckBox *captureMouseDragsCheckBox;
+	QLabel *mouseMotionRateLabel;
+	QSpinBox *mouseMotionRateSpinBox;
+
+	// Recording subtitle UI elements
+	QLabel *subtitleFormatLabel;
+	QComboBox *subtitleFormatComboBox;
+
+	// Multi-stroke sequence UI elements
+	QLabel *sequenceLabel;
+	QPlainTextEdit *sequenceTextEdit;
+	QLabel *sequenceTimeoutLabel;
+	QSpinBox *sequenceTimeoutSpinBox;
+
+	// Shortcut dictionary UI elements
+	QLabel *actionDictionaryLabel;
+	QLineEdit *actionDictionaryLineEdit;
+	QPushButton *actionDictionaryBrowseButton;
+
+	// Per-application profile UI elements
+	QLabel *appProfileLabel;
+	QPlainTextEdit *appProfileTextEdit;
+
+	void storeCurrentTarget();
+	void loadTarget(int index);
+	void refreshTargetList();
 
 private slots:
 	void applySettings();
+	void onTargetSelectionChanged(int row);
+	void addTarget();
+	void removeTarget();
 	void onSceneChanged(const QString &sceneName);
+	void onSceneIndexed(const QString &sceneName);
+	void onTemplateChanged(const QString &text);
 	void onDisplayInTextSourceToggled(bool checked); // Slot for checkbox state change
+	void browseActionDictionary();
 };
 
 #endif // STREAMUP_HOTKEY_DISPLAY_SETTINGS_HPP
@@ -0,0 +1,403 @@
+#include "streamup-hotkey-display-websocket.hpp"
+#include "streamup-hotkey-display-keynames.hpp"
+#include <obs.h>
+#include <util/platform.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr size_t MAX_SUBSCRIPTIONS = 32;
+constexpr size_t MAX_BATCH_EVENTS = 64; // Per subscription and frame; the rest is counted as dropped
+
+enum SubscriptionKind : uint8_t {
+	SUBSCRIPTION_KIND_PRESS = 1 << 0,
+	SUBSCRIPTION_KIND_RELEASE = 1 << 1,
+	SUBSCRIPTION_KIND_MOUSE = 1 << 2,
+	SUBSCRIPTION_KIND_SCROLL = 1 << 3,
+	SUBSCRIPTION_KIND_GAMEPAD = 1 << 4,
+	SUBSCRIPTION_KIND_GESTURE = 1 << 5,
+	SUBSCRIPTION_KIND_ALL = 0x3F,
+};
+
+struct Subscription {
+	uint32_t id = 0;
+	uint8_t kinds = SUBSCRIPTION_KIND_ALL;
+	std::vector<std::string> patterns;
+	uint64_t minIntervalNs = 0;
+	uint64_t lastSentTime = 0;
+	uint64_t dropped = 0;
+	std::vector<ChordEvent> pending; // Reserved up front so the sink never allocates
+};
+
+obs_websocket_vendor websocketVendor = nullptr;
+
+std::mutex subscriptionMutex; // Protects subscriptions and nextSubscriptionId
+std::vector<std::unique_ptr<Subscription>> subscriptions;
+uint32_t nextSubscriptionId = 1;
+std::atomic<size_t> subscriptionCount{0};
+std::atomic<bool> broadcastEnabled{false};
+
+// Only touched by the tick callback
+std::vector<ChordEvent> batchEvents;
+
+uint8_t subscriptionKindOf(ChordKind kind)
+{
+	switch (kind) {
+	case ChordKind::Keyboard:
+		return SUBSCRIPTION_KIND_PRESS;
+	case ChordKind::Release:
+		return SUBSCRIPTION_KIND_RELEASE;
+	case ChordKind::Mouse:
+		return SUBSCRIPTION_KIND_MOUSE;
+	case ChordKind::Scroll:
+		return SUBSCRIPTION_KIND_SCROLL;
+	case ChordKind::Gamepad:
+		return SUBSCRIPTION_KIND_GAMEPAD;
+	case ChordKind::Gesture:
+		return SUBSCRIPTION_KIND_GESTURE;
+	}
+	return 0;
+}
+
+const char *subscriptionKindName(ChordKind kind)
+{
+	switch (kind) {
+	case ChordKind::Keyboard:
+		return "press";
+	case ChordKind::Release:
+		return "release";
+	case ChordKind::Mouse:
+		return "mouse";
+	case ChordKind::Scroll:
+		return "scroll";
+	case ChordKind::Gamepad:
+		return "gamepad";
+	case ChordKind::Gesture:
+		return "gesture";
+	}
+	return "";
+}
+
+char asciiLower(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// Case-insensitive glob match: '*' matches any run of characters, '?' exactly one byte
+bool matchesPattern(std::string_view pattern, std::string_view text)
+{
+	size_t p = 0;
+	size_t t = 0;
+	size_t star = std::string_view::npos;
+	size_t starText = 0;
+
+	while (t < text.size()) {
+		if (p < pattern.size() && pattern[p] == '*') {
+			star = p++;
+			starText = t;
+		} else if (p < pattern.size() && (pattern[p] == '?' || asciiLower(pattern[p]) == asciiLower(text[t]))) {
+			p++;
+			t++;
+		} else if (star != std::string_view::npos) {
+			p = star + 1;
+			t = ++starText;
+		} else {
+			return false;
+		}
+	}
+
+	while (p < pattern.size() && pattern[p] == '*') {
+		p++;
+	}
+	return p == pattern.size();
+}
+
+bool subscriptionMatches(const Subscription &subscription, const ChordEvent &chord)
+{
+	if (!(subscription.kinds & subscriptionKindOf(chord.kind))) {
+		return false;
+	}
+	if (subscription.patterns.empty()) {
+		return true;
+	}
+	for (const std::string &pattern : subscription.patterns) {
+		if (matchesPattern(pattern, chord.text.view())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Calls visit for every trimmed, non-empty item of a separated list
+template<typename Visitor> void forEachListItem(std::string_view list, char separator, Visitor visit)
+{
+	while (!list.empty()) {
+		size_t end = list.find(separator);
+		std::string_view item = list.substr(0, end);
+		list = end == std::string_view::npos ? std::string_view() : list.substr(end + 1);
+
+		while (!item.empty() && item.front() == ' ') {
+			item.remove_prefix(1);
+		}
+		while (!item.empty() && item.back() == ' ') {
+			item.remove_suffix(1);
+		}
+		if (!item.empty()) {
+			visit(item);
+		}
+	}
+}
+
+void fillChordData(obs_data_t *data, const ChordEvent &chord)
+{
+	obs_data_set_string(data, "key_combination", chord.text.c_str());
+	if (!chord.action.empty()) {
+		obs_data_set_string(data, "action", chord.action.c_str());
+	}
+	if (chord.replacesPrevious) {
+		obs_data_set_int(data, "count", chord.repeatCount);
+		obs_data_set_bool(data, "replaces_previous", true);
+	}
+
+	// Add all key presses as an array
+	obs_data_array_t *key_presses_array = obs_data_array_create();
+	for (size_t i = 0; i < chord.keyCount; i++) {
+		obs_data_t *key_data = obs_data_create();
+		obs_data_set_string(key_data, "key", getKeyName(chord.keys[i]).data());
+		obs_data_array_push_back(key_presses_array, key_data);
+		obs_data_release(key_data);
+	}
+	obs_data_set_array(data, "key_presses", key_presses_array);
+	obs_data_array_release(key_presses_array);
+
+	if (chord.kind == ChordKind::Gesture) {
+		obs_data_array_t *path_array = obs_data_array_create();
+		for (size_t i = 0; i < chord.path.count; i++) {
+			const GesturePoint &point = chord.path.points[i];
+			obs_data_t *point_data = obs_data_create();
+			obs_data_set_int(point_data, "x", point.x);
+			obs_data_set_int(point_data, "y", point.y);
+			obs_data_set_int(point_data, "t_ms", point.ms);
+			obs_data_array_push_back(path_array, point_data);
+			obs_data_release(point_data);
+		}
+		obs_data_set_array(data, "path", path_array);
+		obs_data_array_release(path_array);
+	}
+}
+
+void emitPressedEvent(const char *eventType, const ChordEvent &chord)
+{
+	obs_data_t *event_data = obs_data_create();
+	fillChordData(event_data, chord);
+	obs_websocket_vendor_emit_event(websocketVendor, eventType, event_data);
+	obs_data_release(event_data);
+}
+
+void emitKeyBatchEvent(uint32_t subscriptionId, uint64_t dropped, const std::vector<ChordEvent> &events)
+{
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_int(event_data, "subscription_id", subscriptionId);
+	obs_data_set_int(event_data, "dropped", (long long)dropped);
+
+	obs_data_array_t *events_array = obs_data_array_create();
+	for (const ChordEvent &chord : events) {
+		obs_data_t *chord_data = obs_data_create();
+		obs_data_set_string(chord_data, "kind", subscriptionKindName(chord.kind));
+		fillChordData(chord_data, chord);
+		obs_data_set_int(chord_data, "timestamp_ms", (long long)(chord.timestamp / 1000000));
+		obs_data_array_push_back(events_array, chord_data);
+		obs_data_release(chord_data);
+	}
+	obs_data_set_array(event_data, "events", events_array);
+	obs_data_array_release(events_array);
+
+	obs_websocket_vendor_emit_event(websocketVendor, "key_batch", event_data);
+	obs_data_release(event_data);
+}
+
+// Runs once per OBS frame; sends at most one batch per subscription
+void keyBatchTick(void *, float)
+{
+	if (subscriptionCount.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+
+	uint64_t now = os_gettime_ns();
+	for (size_t i = 0;; i++) {
+		uint32_t subscriptionId;
+		uint64_t dropped;
+		{
+			std::lock_guard<std::mutex> lock(subscriptionMutex);
+			if (i >= subscriptions.size()) {
+				break;
+			}
+
+			Subscription &subscription = *subscriptions[i];
+			if (subscription.pending.empty() || now - subscription.lastSentTime < subscription.minIntervalNs) {
+				continue;
+			}
+
+			// Copy out so the JSON is built without holding the lock
+			batchEvents.assign(subscription.pending.begin(), subscription.pending.end());
+			subscription.pending.clear();
+			subscription.lastSentTime = now;
+			subscriptionId = subscription.id;
+			dropped = subscription.dropped;
+			subscription.dropped = 0;
+		}
+
+		emitKeyBatchEvent(subscriptionId, dropped, batchEvents);
+	}
+}
+
+void handleSubscribeRequest(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	auto subscription = std::make_unique<Subscription>();
+
+	// Lists are separated strings, since obs_data arrays can only hold objects
+	std::string_view kinds = obs_data_get_string(request_data, "kinds");
+	if (!kinds.empty()) {
+		bool valid = true;
+		subscription->kinds = 0;
+		forEachListItem(kinds, ',', [&](std::string_view kind) {
+			if (kind == "press") {
+				subscription->kinds |= SUBSCRIPTION_KIND_PRESS;
+			} else if (kind == "release") {
+				subscription->kinds |= SUBSCRIPTION_KIND_RELEASE;
+			} else if (kind == "mouse") {
+				subscription->kinds |= SUBSCRIPTION_KIND_MOUSE;
+			} else if (kind == "scroll") {
+				subscription->kinds |= SUBSCRIPTION_KIND_SCROLL;
+			} else if (kind == "gamepad") {
+				subscription->kinds |= SUBSCRIPTION_KIND_GAMEPAD;
+			} else if (kind == "gesture") {
+				subscription->kinds |= SUBSCRIPTION_KIND_GESTURE;
+			} else {
+				valid = false;
+			}
+		});
+		if (!valid || subscription->kinds == 0) {
+			obs_data_set_bool(response_data, "success", false);
+			obs_data_set_string(response_data, "error",
+					    "kinds must be a comma-separated list of press, release, mouse, scroll, gamepad, "
+					    "gesture");
+			return;
+		}
+	}
+
+	forEachListItem(obs_data_get_string(request_data, "patterns"), '|',
+			[&](std::string_view pattern) { subscription->patterns.emplace_back(pattern); });
+
+	long long maxRate = obs_data_get_int(request_data, "max_rate");
+	subscription->minIntervalNs = maxRate > 0 ? 1000000000ull / (uint64_t)maxRate : 0;
+	subscription->pending.reserve(MAX_BATCH_EVENTS);
+
+	std::lock_guard<std::mutex> lock(subscriptionMutex);
+	if (subscriptions.size() >= MAX_SUBSCRIPTIONS) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "error", "Too many subscriptions");
+		return;
+	}
+
+	subscription->id = nextSubscriptionId++;
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_int(response_data, "subscription_id", subscription->id);
+
+	subscriptions.push_back(std::move(subscription));
+	subscriptionCount.store(subscriptions.size(), std::memory_order_relaxed);
+}
+
+void handleUnsubscribeRequest(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	uint32_t id = (uint32_t)obs_data_get_int(request_data, "subscription_id");
+
+	std::lock_guard<std::mutex> lock(subscriptionMutex);
+	for (auto it = subscriptions.begin(); it != subscriptions.end(); ++it) {
+		if ((*it)->id == id) {
+			subscriptions.erase(it);
+			subscriptionCount.store(subscriptions.size(), std::memory_order_relaxed);
+			obs_data_set_bool(response_data, "success", true);
+			return;
+		}
+	}
+
+	obs_data_set_bool(response_data, "success", false);
+	obs_data_set_string(response_data, "error", "Unknown subscription_id");
+}
+
+} // namespace
+
+void startWebSocketSubscriptions(obs_websocket_vendor vendor)
+{
+	websocketVendor = vendor;
+	batchEvents.reserve(MAX_BATCH_EVENTS);
+
+	if (!obs_websocket_vendor_register_request(vendor, "subscribe", handleSubscribeRequest, nullptr) ||
+	    !obs_websocket_vendor_register_request(vendor, "unsubscribe", handleUnsubscribeRequest, nullptr)) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to register websocket subscription requests");
+	}
+
+	obs_add_tick_callback(keyBatchTick, nullptr);
+}
+
+void stopWebSocketSubscriptions()
+{
+	if (!websocketVendor) {
+		return;
+	}
+
+	obs_remove_tick_callback(keyBatchTick, nullptr);
+	obs_websocket_vendor_unregister_request(websocketVendor, "subscribe");
+	obs_websocket_vendor_unregister_request(websocketVendor, "unsubscribe");
+
+	std::lock_guard<std::mutex> lock(subscriptionMutex);
+	subscriptions.clear();
+	subscriptionCount.store(0, std::memory_order_relaxed);
+	websocketVendor = nullptr;
+}
+
+void setWebSocketBroadcast(bool enabled)
+{
+	broadcastEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void websocketChordSink(const ChordEvent &chord, void *)
+{
+	if (!websocketVendor) {
+		return;
+	}
+
+	// The broadcast event keeps its original contract: shown keyboard chords only. Controller
+	// chords get their own event so existing key_pressed consumers never see them.
+	if (broadcastEnabled.load(std::memory_order_relaxed)) {
+		if (chord.kind == ChordKind::Keyboard) {
+			emitPressedEvent("key_pressed", chord);
+		} else if (chord.kind == ChordKind::Gamepad) {
+			emitPressedEvent("gamepad_pressed", chord);
+		} else if (chord.kind == ChordKind::Gesture) {
+			emitPressedEvent("mouse_gesture", chord);
+		}
+	}
+
+	if (subscriptionCount.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(subscriptionMutex);
+	for (const auto &subscription : subscriptions) {
+		if (!subscriptionMatches(*subscription, chord)) {
+			continue;
+		}
+		if (subscription->pending.size() >= MAX_BATCH_EVENTS) {
+			subscription->dropped++;
+			continue;
+		}
+		subscription->pending.push_back(chord);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_WEBSOCKET_HPP
+#define STREAMUP_HOTKEY_DISPLAY_WEBSOCKET_HPP
+
+#include "obs-websocket-api.h"
+#include "streamup-hotkey-core-chord.hpp"
+
+// obs-websocket integration.
+//
+// With the broadcast setting on, every shown keyboard chord is broadcast as a "key_pressed" vendor
+// event, every gamepad chord ("LB + A") as a "gamepad_pressed" event and every mouse drag
+// ("Ctrl + Drag ↘ 240px") as a "mouse_gesture" event, all with the same fields. The broadcast is
+// opt-in: new installs start with it off, and settings saved before it existed keep it on so older
+// consumers still get their events. Consumers should register a subscription instead, which only
+// sends what they asked for:
+//
+//   subscribe    { "patterns": "Ctrl + *|Alt + Tab", "kinds": "press,scroll", "max_rate": 10 }
+//                -> { "success": true, "subscription_id": 3 }
+//   unsubscribe  { "subscription_id": 3 } -> { "success": true }
+//
+// Lists are plain strings because obs_data arrays cannot hold strings. Patterns are '|'-separated
+// globs over the formatted chord ('*' any run, '?' one character, case-insensitive); none means
+// every chord. Kinds are a comma-separated subset of press, release, mouse, scroll, gamepad and
+// gesture; none means all.
+// max_rate caps the batches per second (0 = one per OBS frame). Matching events are queued and sent
+// as one "key_batch" event per subscription per frame:
+//
+//   key_batch    { "subscription_id": 3, "dropped": 0, "events": [{ "kind", "key_combination",
+//                  "key_presses", "timestamp_ms" }, ...] }
+//
+// All of these events add "action" next to "key_combination" when the chord has a label from a
+// multi-key shortcut or the shortcut dictionary ("Command Palette"). Gestures add "path", the
+// simplified pointer path as [{ "x", "y", "t_ms" }, ...] relative to where the drag began. A newer
+// count of a merged mouse burst ("Ctrl + Scroll Up ×3") adds "count" and "replaces_previous": true;
+// it updates the burst's earlier event rather than being a new one.
+//
+// obs-websocket cannot address a vendor event to one client, so every connected client receives
+// every batch; clients pick theirs by subscription_id and should unsubscribe before disconnecting.
+// Without subscriptions and broadcast, nothing is sent at all.
+//
+// Unlike the core's own sinks, this one is not allocation-free: libobs builds every event as a new
+// obs_data tree. Matching subscriptions only copy the chord into a reserved queue on the dispatcher
+// thread and the batch is built on the tick; the broadcast builds its event right in the sink.
+
+// Registers the vendor requests and the per-frame batch tick
+void startWebSocketSubscriptions(obs_websocket_vendor vendor);
+void stopWebSocketSubscriptions();
+
+// Turns the per-chord key_pressed / gamepad_pressed / mouse_gesture broadcast on or off
+void setWebSocketBroadcast(bool enabled);
+
+// Event bus sink (dispatcher thread)
+void websocketChordSink(const ChordEvent &chord, void *userData);
+
+#endif // STREAMUP_HOTKEY_DISPLAY_WEBSOCKET_HPP
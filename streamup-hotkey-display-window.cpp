@@ -0,0 +1,233 @@
+#include "streamup-hotkey-display-window.hpp"
+#include <obs-module.h>
+#include <atomic>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+namespace {
+
+// Windows can disappear between a notification and the query about them. Xlib's default error
+// handler exits the process, so errors on the hook's own connection are ignored and everything
+// else goes to whichever handler was installed before.
+std::atomic<Display *> trackedDisplay{nullptr};
+XErrorHandler previousErrorHandler = nullptr;
+
+int ignoreTrackedDisplayErrors(Display *errorDisplay, XErrorEvent *error)
+{
+	if (errorDisplay == trackedDisplay.load(std::memory_order_relaxed)) {
+		return 0;
+	}
+	return previousErrorHandler ? previousErrorHandler(errorDisplay, error) : 0;
+}
+
+// Events wanted from every tracked window: title changes and destruction
+constexpr long TRACKED_WINDOW_EVENTS = PropertyChangeMask | StructureNotifyMask;
+
+} // namespace
+
+bool ActiveWindowTracker::start(Display *xDisplay, ActiveWindowCallback changeCallback, void *param)
+{
+	display = xDisplay;
+	root = DefaultRootWindow(display);
+	callback = changeCallback;
+	callbackParam = param;
+
+	trackedDisplay.store(display, std::memory_order_relaxed);
+	previousErrorHandler = XSetErrorHandler(ignoreTrackedDisplayErrors);
+
+	netActiveWindow = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
+	netWmName = XInternAtom(display, "_NET_WM_NAME", False);
+	utf8String = XInternAtom(display, "UTF8_STRING", False);
+
+	// Keep the key and button selection made by the hook
+	XWindowAttributes attributes;
+	if (!XGetWindowAttributes(display, root, &attributes)) {
+		blog(LOG_WARNING,
+		     "[StreamUP Hotkey Display] Cannot watch the active window, per-application profiles are disabled");
+		stop();
+		return false;
+	}
+	XSelectInput(display, root, attributes.your_event_mask | PropertyChangeMask);
+
+	activate(readActiveWindow());
+	return true;
+}
+
+void ActiveWindowTracker::stop()
+{
+	if (display) {
+		for (const auto &entry : windows) {
+			XSelectInput(display, entry.first, NoEventMask);
+		}
+	}
+	windows.clear();
+	activeWindow = 0;
+
+	if (trackedDisplay.load(std::memory_order_relaxed)) {
+		XSetErrorHandler(previousErrorHandler);
+		previousErrorHandler = nullptr;
+		trackedDisplay.store(nullptr, std::memory_order_relaxed);
+	}
+	callback = nullptr;
+	callbackParam = nullptr;
+	display = nullptr;
+}
+
+bool ActiveWindowTracker::handleEvent(const XEvent &event)
+{
+	if (!display) {
+		return false;
+	}
+
+	switch (event.type) {
+	case PropertyNotify:
+		break;
+	case DestroyNotify:
+		forget(event.xdestroywindow.window);
+		return true;
+	case ConfigureNotify:
+	case MapNotify:
+	case UnmapNotify:
+	case ReparentNotify:
+	case GravityNotify:
+	case CirculateNotify:
+		// Side effects of StructureNotifyMask on tracked windows
+		return true;
+	default:
+		return false;
+	}
+
+	const XPropertyEvent &property = event.xproperty;
+	if (property.window == root) {
+		if (property.atom == netActiveWindow) {
+			activate(readActiveWindow());
+		}
+		return true;
+	}
+
+	if (property.atom != netWmName && property.atom != XA_WM_NAME) {
+		return true;
+	}
+	auto it = windows.find(property.window);
+	if (it == windows.end()) {
+		return true;
+	}
+	readTitle(property.window, it->second.title);
+	if (property.window == activeWindow && callback) {
+		callback(it->second, callbackParam);
+	}
+	return true;
+}
+
+void ActiveWindowTracker::activate(Window window)
+{
+	if (window == activeWindow) {
+		return;
+	}
+	activeWindow = window;
+
+	// The desktop or no window at all: report an empty class so the default profile applies
+	static const ActiveWindowInfo noWindow;
+	const ActiveWindowInfo *info = window ? track(window) : nullptr;
+	if (callback) {
+		callback(info ? *info : noWindow, callbackParam);
+	}
+}
+
+ActiveWindowInfo *ActiveWindowTracker::track(Window window)
+{
+	auto it = windows.find(window);
+	if (it != windows.end()) {
+		return &it->second;
+	}
+
+	// Window ids are only reused after destruction, which evicts the entry; the bound is for
+	// sessions that focus many short-lived windows whose destruction was missed
+	if (windows.size() >= MAX_CACHED_WINDOWS) {
+		for (const auto &entry : windows) {
+			XSelectInput(display, entry.first, NoEventMask);
+		}
+		windows.clear();
+	}
+
+	// Select first so a title change between the reads below is not missed
+	XSelectInput(display, window, TRACKED_WINDOW_EVENTS);
+
+	ActiveWindowInfo info;
+	XClassHint classHint = {};
+	if (XGetClassHint(display, window, &classHint)) {
+		if (classHint.res_name) {
+			info.instanceName = classHint.res_name;
+			XFree(classHint.res_name);
+		}
+		if (classHint.res_class) {
+			info.className = classHint.res_class;
+			XFree(classHint.res_class);
+		}
+	}
+	readTitle(window, info.title);
+
+	return &windows.emplace(window, std::move(info)).first->second;
+}
+
+void ActiveWindowTracker::forget(Window window)
+{
+	windows.erase(window);
+	if (window == activeWindow) {
+		activeWindow = 0;
+	}
+}
+
+Window ActiveWindowTracker::readActiveWindow()
+{
+	Atom type = 0;
+	int format = 0;
+	unsigned long count = 0;
+	unsigned long remaining = 0;
+	unsigned char *data = nullptr;
+	Window window = 0;
+	if (XGetWindowProperty(display, root, netActiveWindow, 0, 1, False, XA_WINDOW, &type, &format, &count, &remaining,
+			       &data) == Success &&
+	    data) {
+		if (type == XA_WINDOW && format == 32 && count == 1) {
+			// Format 32 properties are returned as longs
+			window = (Window)*reinterpret_cast<unsigned long *>(data);
+		}
+		XFree(data);
+	}
+	return window;
+}
+
+void ActiveWindowTracker::readTitle(Window window, std::string &title)
+{
+	title.clear();
+
+	Atom type = 0;
+	int format = 0;
+	unsigned long count = 0;
+	unsigned long remaining = 0;
+	unsigned char *data = nullptr;
+	if (XGetWindowProperty(display, window, netWmName, 0, 256, False, utf8String, &type, &format, &count, &remaining,
+			       &data) == Success &&
+	    data) {
+		if (type == utf8String && format == 8) {
+			title.assign(reinterpret_cast<const char *>(data), count);
+		}
+		XFree(data);
+	}
+	if (!title.empty()) {
+		return;
+	}
+
+	char *name = nullptr;
+	if (XFetchName(display, window, &name) && name) {
+		title = name;
+		XFree(name);
+	}
+}
+
+ActiveWindowTracker &activeWindowTracker()
+{
+	static ActiveWindowTracker tracker;
+	return tracker;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_WINDOW_HPP
+#define STREAMUP_HOTKEY_DISPLAY_WINDOW_HPP
+
+#include <string>
+#include <unordered_map>
+#include <X11/Xlib.h>
+
+// Class and title of a top-level window
+struct ActiveWindowInfo {
+	std::string instanceName; // First part of WM_CLASS, e.g. "code"
+	std::string className;    // Second part of WM_CLASS, e.g. "Code"
+	std::string title;        // _NET_WM_NAME, or WM_NAME when the window has none
+};
+
+using ActiveWindowCallback = void (*)(const ActiveWindowInfo &window, void *param);
+
+// Follows the focused window through PropertyNotify events: _NET_ACTIVE_WINDOW on the root window
+// for focus changes, and the title properties on windows that have been focused before. Nothing
+// is polled. Class and title are cached per window and kept current by those events, so
+// switching back to a known window makes no X round trips.
+class ActiveWindowTracker {
+public:
+	// Must be called on the thread that owns the display connection, after the root window's
+	// other input has been selected (the tracker adds PropertyChangeMask to it). Reports the
+	// window that is focused at start.
+	bool start(Display *display, ActiveWindowCallback callback, void *param);
+	void stop();
+
+	// Returns true if the event was a window property or lifetime notification (and has been handled)
+	bool handleEvent(const XEvent &event);
+
+private:
+	static constexpr size_t MAX_CACHED_WINDOWS = 256;
+
+	void activate(Window window);
+	ActiveWindowInfo *track(Window window);
+	void forget(Window window);
+	Window readActiveWindow();
+	void readTitle(Window window, std::string &title);
+
+	Display *display = nullptr;
+	Window root = 0;
+	Atom netActiveWindow = 0;
+	Atom netWmName = 0;
+	Atom utf8String = 0;
+	ActiveWindowCallback callback = nullptr;
+	void *callbackParam = nullptr;
+
+	Window activeWindow = 0;
+	std::unordered_map<Window, ActiveWindowInfo> windows;
+};
+
+ActiveWindowTracker &activeWindowTracker();
+
+#endif // STREAMUP_HOTKEY_DISPLAY_WINDOW_HPP
@@ -0,0 +1,335 @@
+#include "streamup-hotkey-display-xkb.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+#include <obs-module.h>
+#include <cstring>
+#include <iterator>
+#include <X11/XKBlib.h>
+#include <X11/Xlib-xcb.h>
+#include <X11/keysym.h>
+#include <xkbcommon/xkbcommon.h>
+#include <xkbcommon/xkbcommon-x11.h>
+
+namespace {
+
+struct SpecialKeysym {
+	uint32_t keysym;
+	const char *name;
+};
+
+// Keys whose label is a word rather than the character they produce
+const SpecialKeysym specialKeysyms[] = {
+	{XK_Control_L, "Ctrl"},    {XK_Control_R, "Ctrl"},      {XK_Super_L, "Super"},
+	{XK_Super_R, "Super"},     {XK_Alt_L, "Alt"},           {XK_Alt_R, "Alt"},
+	{XK_Meta_L, "Alt"},        {XK_Meta_R, "Alt"},          {XK_ISO_Level3_Shift, "AltGr"},
+	{XK_Shift_L, "Shift"},     {XK_Shift_R, "Shift"},       {XK_Return, "Enter"},
+	{XK_space, "Space"},       {XK_BackSpace, "Backspace"}, {XK_Tab, "Tab"},
+	{XK_ISO_Left_Tab, "Tab"},  {XK_Escape, "Escape"},       {XK_Page_Up, "Page Up"},
+	{XK_Page_Down, "Page Down"}, {XK_End, "End"},           {XK_Home, "Home"},
+	{XK_Left, "Left Arrow"},   {XK_Up, "Up Arrow"},         {XK_Right, "Right Arrow"},
+	{XK_Down, "Down Arrow"},   {XK_Insert, "Insert"},       {XK_Delete, "Delete"},
+	{XK_Caps_Lock, "Caps Lock"}, {XK_Num_Lock, "Num Lock"}, {XK_Scroll_Lock, "Scroll Lock"},
+	{XK_Print, "Print Screen"}, {XK_Pause, "Pause"},        {XK_Menu, "Menu"},
+	{XK_KP_Enter, "Num Enter"}, {XK_F1, "F1"},              {XK_F2, "F2"},
+	{XK_F3, "F3"},             {XK_F4, "F4"},               {XK_F5, "F5"},
+	{XK_F6, "F6"},             {XK_F7, "F7"},               {XK_F8, "F8"},
+	{XK_F9, "F9"},             {XK_F10, "F10"},             {XK_F11, "F11"},
+	{XK_F12, "F12"}};
+
+// Spacing equivalents for common dead keys so their keycap shows a character
+const SpecialKeysym deadKeysyms[] = {
+	{XK_dead_grave, "`"},      {XK_dead_acute, "\xC2\xB4"},     {XK_dead_circumflex, "^"},
+	{XK_dead_tilde, "~"},      {XK_dead_diaeresis, "\xC2\xA8"}, {XK_dead_cedilla, "\xC2\xB8"},
+	{XK_dead_abovering, "\xC2\xB0"}};
+
+const char *findKeysymName(const SpecialKeysym *table, size_t count, uint32_t keysym)
+{
+	for (size_t i = 0; i < count; i++) {
+		if (table[i].keysym == keysym) {
+			return table[i].name;
+		}
+	}
+	return nullptr;
+}
+
+int modifierRankForKeysym(uint32_t keysym)
+{
+	switch (keysym) {
+	case XK_Control_L:
+	case XK_Control_R:
+		return 0;
+	case XK_Super_L:
+	case XK_Super_R:
+	case XK_Hyper_L:
+	case XK_Hyper_R:
+		return 1;
+	case XK_Alt_L:
+	case XK_Alt_R:
+	case XK_Meta_L:
+	case XK_Meta_R:
+		return 2;
+	case XK_Shift_L:
+	case XK_Shift_R:
+		return 3;
+	default:
+		return -1;
+	}
+}
+
+bool isNumpadKeysym(uint32_t keysym)
+{
+	return keysym >= XK_KP_Space && keysym <= XK_KP_9;
+}
+
+bool isDigitKeysym(uint32_t keysym)
+{
+	return keysym >= XK_0 && keysym <= XK_9;
+}
+
+bool isSingleKeysym(uint32_t keysym)
+{
+	switch (keysym) {
+	case XK_Insert:
+	case XK_Delete:
+	case XK_Home:
+	case XK_End:
+	case XK_Page_Up:
+	case XK_Page_Down:
+	case XK_Return:
+		return true;
+	default:
+		return keysym >= XK_F1 && keysym <= XK_F12;
+	}
+}
+
+uint32_t keysymAtLevel(xkb_keymap *keymap, xkb_keycode_t keycode, xkb_layout_index_t layout, xkb_level_index_t level)
+{
+	// Keys with fewer layouts than the keymap wrap around to their first layout
+	xkb_layout_index_t keyLayouts = xkb_keymap_num_layouts_for_key(keymap, keycode);
+	if (keyLayouts == 0) {
+		return 0;
+	}
+
+	const xkb_keysym_t *syms = nullptr;
+	int count = xkb_keymap_key_get_syms_by_level(keymap, keycode, layout % keyLayouts, level, &syms);
+	return count > 0 ? syms[0] : 0;
+}
+
+std::string printableLabel(uint32_t keysym)
+{
+	char buffer[16];
+	int length = xkb_keysym_to_utf8(xkb_keysym_to_upper(keysym), buffer, sizeof(buffer));
+	if (length > 1 && (unsigned char)buffer[0] >= 0x20 && buffer[0] != 0x7f) {
+		return std::string(buffer);
+	}
+	return std::string();
+}
+
+std::unique_ptr<XkbLayoutLabels> buildLayout(xkb_keymap *keymap, xkb_layout_index_t layout)
+{
+	auto table = std::make_unique<XkbLayoutLabels>();
+	table->keysyms.fill(0);
+	table->shiftedKeysyms.fill(0);
+	table->modifierRanks.fill(-1);
+
+	for (int keycode = 0; keycode < XKB_KEYCODE_COUNT; keycode++) {
+		uint32_t keysym = keysymAtLevel(keymap, keycode, layout, 0);
+		uint32_t shifted = keysymAtLevel(keymap, keycode, layout, 1);
+		table->keysyms[keycode] = keysym;
+		table->shiftedKeysyms[keycode] = shifted;
+
+		std::string &label = table->labelStorage[keycode];
+		uint8_t classes = 0;
+
+		if (keysym == 0) {
+			label = "Unknown";
+		} else if (const char *special = findKeysymName(specialKeysyms, std::size(specialKeysyms), keysym)) {
+			label = special;
+		} else if (isNumpadKeysym(keysym) || isNumpadKeysym(shifted)) {
+			// Label numpad keys by their Num Lock symbol
+			uint32_t numpadSym = isNumpadKeysym(shifted) && shifted >= XK_KP_Multiply ? shifted : keysym;
+			std::string symbol = printableLabel(numpadSym);
+			label = "Num " + (symbol.empty() ? std::string("Key") : symbol);
+			classes |= KEY_CLASS_NUMPAD;
+		} else if (const char *dead = findKeysymName(deadKeysyms, std::size(deadKeysyms), keysym)) {
+			label = dead;
+			classes |= KEY_CLASS_PUNCTUATION;
+		} else {
+			label = printableLabel(keysym);
+			if (!label.empty()) {
+				if (isDigitKeysym(keysym) || isDigitKeysym(shifted)) {
+					// Also covers AZERTY, where digits sit on the shifted level
+					classes |= KEY_CLASS_NUMBER;
+				} else if (xkb_keysym_to_upper(keysym) != xkb_keysym_to_lower(keysym)) {
+					classes |= KEY_CLASS_LETTER;
+				} else {
+					classes |= KEY_CLASS_PUNCTUATION;
+				}
+			} else {
+				char name[64];
+				label = xkb_keysym_get_name(keysym, name, sizeof(name)) > 0 ? name : "Unknown";
+			}
+		}
+
+		int rank = modifierRankForKeysym(keysym);
+		if (rank >= 0) {
+			classes |= KEY_CLASS_MODIFIER;
+			if (rank == 3) {
+				classes |= KEY_CLASS_SHIFT;
+			}
+		}
+		if (isSingleKeysym(keysym)) {
+			classes |= KEY_CLASS_SINGLE;
+		}
+		if (keysym == XK_space || keysym == XK_Tab || keysym == XK_BackSpace || keysym == XK_Return) {
+			classes |= KEY_CLASS_PUNCTUATION;
+		}
+
+		table->classes[keycode] = classes;
+		table->modifierRanks[keycode] = (int8_t)rank;
+		table->labels[keycode] = label;
+	}
+
+	return table;
+}
+
+} // namespace
+
+bool XkbKeymapCache::start(Display *xDisplay)
+{
+	display = xDisplay;
+
+	int opcode = 0;
+	int errorBase = 0;
+	int major = XkbMajorVersion;
+	int minor = XkbMinorVersion;
+	if (!XkbQueryExtension(display, &opcode, &xkbEventBase, &errorBase, &major, &minor)) {
+		blog(LOG_ERROR, "[StreamUP Hotkey Display] XKB extension is not available on this X server");
+		xkbEventBase = -1;
+		return false;
+	}
+
+	xcb_connection_t *connection = XGetXCBConnection(display);
+	if (!xkb_x11_setup_xkb_extension(connection, XKB_X11_MIN_MAJOR_XKB_VERSION, XKB_X11_MIN_MINOR_XKB_VERSION,
+					 XKB_X11_SETUP_XKB_EXTENSION_NO_FLAGS, nullptr, nullptr, nullptr, nullptr)) {
+		blog(LOG_ERROR, "[StreamUP Hotkey Display] Failed to set up xkbcommon on the X connection");
+		return false;
+	}
+
+	deviceId = xkb_x11_get_core_keyboard_device_id(connection);
+	context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+	if (deviceId < 0 || !context) {
+		blog(LOG_ERROR, "[StreamUP Hotkey Display] Failed to query the core keyboard device");
+		stop();
+		return false;
+	}
+
+	// Only keymap and layout (group) changes are interesting; labels never change otherwise
+	unsigned long keymapEvents = XkbNewKeyboardNotifyMask | XkbMapNotifyMask;
+	XkbSelectEvents(display, XkbUseCoreKbd, keymapEvents, keymapEvents);
+	XkbSelectEventDetails(display, XkbUseCoreKbd, XkbStateNotify, XkbGroupStateMask, XkbGroupStateMask);
+
+	XkbStateRec state;
+	if (XkbGetState(display, XkbUseCoreKbd, &state) == Success) {
+		currentGroup = state.group;
+	}
+
+	rebuildKeymap();
+	return active() != nullptr;
+}
+
+void XkbKeymapCache::stop()
+{
+	activeLayout.store(nullptr, std::memory_order_release);
+	for (auto &table : layouts) {
+		retiredLayouts.push_back(std::move(table));
+	}
+	layouts.clear();
+	rebuildDue = 0;
+
+	if (context) {
+		xkb_context_unref(context);
+		context = nullptr;
+	}
+	deviceId = -1;
+	xkbEventBase = -1;
+	display = nullptr;
+}
+
+bool XkbKeymapCache::handleEvent(const XEvent &event)
+{
+	if (xkbEventBase < 0 || event.type != xkbEventBase) {
+		return false;
+	}
+
+	const XkbEvent *xkbEvent = reinterpret_cast<const XkbEvent *>(&event);
+	switch (xkbEvent->any.xkb_type) {
+	case XkbNewKeyboardNotify:
+	case XkbMapNotify:
+		// Every notification of the burst pushes the rebuild back
+		rebuildDue = hotkeyCoreTimeNs() + REBUILD_DELAY_NS;
+		break;
+	case XkbStateNotify:
+		if (xkbEvent->state.changed & XkbGroupStateMask) {
+			selectLayout(xkbEvent->state.group);
+		}
+		break;
+	default:
+		break;
+	}
+	return true;
+}
+
+bool XkbKeymapCache::rebuildIfDue(uint64_t now)
+{
+	if (rebuildDue == 0 || now < rebuildDue) {
+		return false;
+	}
+	rebuildDue = 0;
+	rebuildKeymap();
+	return true;
+}
+
+void XkbKeymapCache::rebuildKeymap()
+{
+	if (!display || !context) {
+		return;
+	}
+
+	xcb_connection_t *connection = XGetXCBConnection(display);
+	xkb_keymap *keymap = xkb_x11_keymap_new_from_device(context, connection, deviceId, XKB_KEYMAP_COMPILE_NO_FLAGS);
+	if (!keymap) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to load the active XKB keymap");
+		return;
+	}
+
+	std::vector<std::unique_ptr<XkbLayoutLabels>> built;
+	xkb_layout_index_t layoutCount = xkb_keymap_num_layouts(keymap);
+	for (xkb_layout_index_t layout = 0; layout < layoutCount; layout++) {
+		built.push_back(buildLayout(keymap, layout));
+	}
+
+	blog(LOG_INFO, "[StreamUP Hotkey Display] Built key labels for %u keyboard layout(s), active: %s", layoutCount,
+	     layoutCount > 0 && xkb_keymap_layout_get_name(keymap, currentGroup % layoutCount)
+		     ? xkb_keymap_layout_get_name(keymap, currentGroup % layoutCount)
+		     : "unknown");
+	xkb_keymap_unref(keymap);
+
+	for (auto &table : layouts) {
+		retiredLayouts.push_back(std::move(table));
+	}
+	layouts = std::move(built);
+	selectLayout(currentGroup);
+}
+
+void XkbKeymapCache::selectLayout(unsigned int group)
+{
+	currentGroup = group;
+	const XkbLayoutLabels *table = layouts.empty() ? nullptr : layouts[group % layouts.size()].get();
+	activeLayout.store(table, std::memory_order_release);
+}
+
+XkbKeymapCache &xkbKeymapCache()
+{
+	static XkbKeymapCache cache;
+	return cache;
+}
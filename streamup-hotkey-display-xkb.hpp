@@ -0,0 +1,81 @@
+#pragma once
+
+#ifndef STREAMUP_HOTKEY_DISPLAY_XKB_HPP
+#define STREAMUP_HOTKEY_DISPLAY_XKB_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <X11/Xlib.h>
+
+#include "streamup-hotkey-core-filter.hpp"
+
+struct xkb_context;
+struct xkb_keymap;
+
+constexpr int XKB_KEYCODE_COUNT = 256;
+
+// Labels and core key classes (KEY_CLASS_*) for every keycode of one layout (XKB group), indexed by keycode
+struct XkbLayoutLabels {
+	std::array<std::string_view, XKB_KEYCODE_COUNT> labels;
+	std::array<uint32_t, XKB_KEYCODE_COUNT> keysyms;        // First shift level
+	std::array<uint32_t, XKB_KEYCODE_COUNT> shiftedKeysyms; // Second shift level
+	std::array<uint8_t, XKB_KEYCODE_COUNT> classes{};
+	std::array<int8_t, XKB_KEYCODE_COUNT> modifierRanks;
+
+	// Backing storage for labels; the table is heap allocated and never moved
+	std::array<std::string, XKB_KEYCODE_COUNT> labelStorage;
+};
+
+// Caches label tables for every layout of the active XKB keymap. Tables are built when the
+// hook starts and rebuilt only on keymap change notifications; switching between layouts
+// is a pointer swap to an already built table.
+//
+// getKeyName() hands out views into the tables, which sinks on the dispatcher thread use after
+// the capture thread has moved on. Replaced tables are therefore only retired, and freed by
+// releaseRetired() once the caller knows no reader is left (ChordDispatcher::quiesce()).
+class XkbKeymapCache {
+public:
+	// A keymap change arrives as a burst of notifications; the rebuild waits for it to settle
+	static constexpr uint64_t REBUILD_DELAY_NS = 50000000; // 50ms
+
+	// Must be called on the thread that owns the display connection
+	bool start(Display *display);
+	// Retires the tables; call releaseRetired() afterwards
+	void stop();
+
+	// Returns true if the event was an XKB notification (and has been handled)
+	bool handleEvent(const XEvent &event);
+
+	// hotkeyCoreTimeNs() at which a pending rebuild is due, 0 when none is pending
+	uint64_t rebuildDueTime() const { return rebuildDue; }
+	// Returns true when it rebuilt the tables, retiring the previous ones
+	bool rebuildIfDue(uint64_t now);
+	void releaseRetired() { retiredLayouts.clear(); }
+
+	const XkbLayoutLabels *active() const { return activeLayout.load(std::memory_order_acquire); }
+
+private:
+	void rebuildKeymap();
+	void selectLayout(unsigned int group);
+
+	Display *display = nullptr;
+	xkb_context *context = nullptr;
+	int32_t deviceId = -1;
+	int xkbEventBase = -1;
+	unsigned int currentGroup = 0;
+	uint64_t rebuildDue = 0;
+
+	std::vector<std::unique_ptr<XkbLayoutLabels>> layouts;
+	// Every generation replaced since the last releaseRetired(), for readers of the old pointers
+	std::vector<std::unique_ptr<XkbLayoutLabels>> retiredLayouts;
+	std::atomic<const XkbLayoutLabels *> activeLayout{nullptr};
+};
+
+XkbKeymapCache &xkbKeymapCache();
+
+#endif // STREAMUP_HOTKEY_DISPLAY_XKB_HPP
@@ -8,14 +8,36 @@
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <memory>
 #include <mutex>
 #include <algorithm>
 #include <thread>
 #include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 #include <QMainWindow>
 #include <QDockWidget>
 #include <util/platform.h>
 #include "obs-websocket-api.h"
+#include "streamup-hotkey-display-keynames.hpp"
+#include "streamup-hotkey-display-websocket.hpp"
+#include "streamup-hotkey-core-actions.hpp"
+#include "streamup-hotkey-core-bus.hpp"
+#include "streamup-hotkey-core-coalesce.hpp"
+#include "streamup-hotkey-core-dispatcher.hpp"
+#include "streamup-hotkey-core-engine.hpp"
+#include "streamup-hotkey-core-history.hpp"
+#include "streamup-hotkey-core-latency.hpp"
+#include "streamup-hotkey-core-motion.hpp"
+#include "streamup-hotkey-core-profile.hpp"
+#include "streamup-hotkey-core-sequence.hpp"
+#include "streamup-hotkey-core-subtitles.hpp"
+#include "streamup-hotkey-core-template.hpp"
+#ifndef _WIN32
+#include "streamup-hotkey-core-http.hpp"
+#include "streamup-hotkey-core-socket.hpp"
+#endif
 
 #ifdef _WIN32
 #include <windows.h>
@@ -28,7 +50,12 @@
 
 #ifdef __linux__
 #include <X11/Xlib.h>
-#include <X11/Xutil.h>
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+#include "streamup-hotkey-display-window.hpp"
+#include "streamup-hotkey-display-xkb.hpp"
+#include "streamup-hotkey-core-evdev.hpp"
+#include "streamup-hotkey-core-shm.hpp"
 #endif
 
 #define QT_UTF8(str) QString::fromUtf8(str)
@@ -49,10 +76,6 @@ std::thread linuxHookThread;
 std::atomic<bool> linuxHookRunning{false};
 #endif
 
-std::unordered_set<int> pressedKeys;
-std::unordered_set<int> activeModifiers;
-std::mutex keyStateMutex; // Protects pressedKeys, activeModifiers, and loggedCombinations
-
 #ifdef _WIN32
 std::unordered_set<int> modifierKeys = {VK_CONTROL, VK_LCONTROL, VK_RCONTROL, VK_MENU, VK_LMENU, VK_RMENU,
 					VK_SHIFT,   VK_LSHIFT,   VK_RSHIFT,   VK_LWIN, VK_RWIN};
@@ -113,42 +136,8 @@ std::unordered_set<int> punctuationKeys = {
 	kVK_Tab,                kVK_Delete,            kVK_ForwardDelete};
 #endif
 
-#ifdef __linux__
-std::unordered_set<int> modifierKeys = {XK_Control_L, XK_Control_R, XK_Super_L, XK_Super_R,
-					XK_Alt_L,     XK_Alt_R,     XK_Shift_L, XK_Shift_R};
-
-std::unordered_set<int> singleKeys = {XK_Insert, XK_Delete, XK_Home, XK_End, XK_Page_Up, XK_Page_Down, XK_F1,
-				      XK_F2,     XK_F3,     XK_F4,   XK_F5,  XK_F6,      XK_F7,        XK_F8,
-				      XK_F9,     XK_F10,    XK_F11,  XK_F12, XK_Return};
-
-// Additional key categories for single key capture
-std::unordered_set<int> numpadKeys = {XK_KP_0,        XK_KP_1,      XK_KP_2,       XK_KP_3,
-				      XK_KP_4,        XK_KP_5,      XK_KP_6,       XK_KP_7,
-				      XK_KP_8,        XK_KP_9,      XK_KP_Add,     XK_KP_Subtract,
-				      XK_KP_Multiply, XK_KP_Divide, XK_KP_Decimal, XK_KP_Enter};
-
-std::unordered_set<int> numberKeys = {XK_0, XK_1, XK_2, XK_3, XK_4, XK_5, XK_6, XK_7, XK_8, XK_9};
-
-std::unordered_set<int> letterKeys = {XK_a, XK_b, XK_c, XK_d, XK_e, XK_f, XK_g, XK_h, XK_i,
-				      XK_j, XK_k, XK_l, XK_m, XK_n, XK_o, XK_p, XK_q, XK_r,
-				      XK_s, XK_t, XK_u, XK_v, XK_w, XK_x, XK_y, XK_z,
-				      XK_A, XK_B, XK_C, XK_D, XK_E, XK_F, XK_G, XK_H, XK_I,
-				      XK_J, XK_K, XK_L, XK_M, XK_N, XK_O, XK_P, XK_Q, XK_R,
-				      XK_S, XK_T, XK_U, XK_V, XK_W, XK_X, XK_Y, XK_Z};
-
-std::unordered_set<int> punctuationKeys = {
-	XK_semicolon, XK_comma,     XK_period,    XK_slash,      XK_backslash,   XK_apostrophe,
-	XK_grave,     XK_bracketleft, XK_bracketright, XK_equal,      XK_minus,       XK_space,
-	XK_Tab,       XK_BackSpace, XK_Return};
-#endif
-
-std::unordered_set<std::string> loggedCombinations;
 
-// Single key capture settings
-bool captureNumpad = false;
-bool captureNumbers = false;
-bool captureLetters = false;
-bool capturePunctuation = false;
+// Single key capture whitelist (platform key codes; keysyms on Linux)
 std::unordered_set<int> whitelistedKeySet;
 
 // Logging settings
@@ -158,219 +147,518 @@ HotkeyDisplayDock *hotkeyDisplayDock = nullptr;
 StreamupHotkeyDisplaySettings *settingsDialog = nullptr;
 obs_websocket_vendor websocket_vendor = nullptr;
 
-// Key name lookup tables for performance
+// Maps platform key codes onto the core key classes. Runs on the capture path.
+KeyInfo classifyKey(int keyCode)
+{
+	KeyInfo key;
+
+#ifdef __linux__
+	// Linux key codes are raw X keycodes; their meaning depends on the active XKB layout
+	const XkbLayoutLabels *layout = xkbKeymapCache().active();
+	if (!layout || keyCode < 0 || keyCode >= XKB_KEYCODE_COUNT) {
+		return key;
+	}
+	key.classes = layout->classes[keyCode];
+	key.modifierRank = layout->modifierRanks[keyCode];
+
+	// The whitelist holds keysyms; match whatever either shift level of this key produces
+	if (whitelistedKeySet.count((int)layout->keysyms[keyCode]) > 0 ||
+	    whitelistedKeySet.count((int)layout->shiftedKeysyms[keyCode]) > 0) {
+		key.classes |= KEY_CLASS_WHITELISTED;
+	}
+#else
+	if (modifierKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_MODIFIER;
+		switch (keyCode) {
 #ifdef _WIN32
-static const std::unordered_map<int, const char *> keyNameMap = {
-	{VK_LBUTTON, "Left Click"},  {VK_RBUTTON, "Right Click"},  {VK_MBUTTON, "Middle Click"},
-	{VK_XBUTTON1, "X Button 1"}, {VK_XBUTTON2, "X Button 2"},  {VK_CONTROL, "Ctrl"},
-	{VK_LCONTROL, "Ctrl"},       {VK_RCONTROL, "Ctrl"},        {VK_MENU, "Alt"},
-	{VK_LMENU, "Alt"},           {VK_RMENU, "Alt"},            {VK_SHIFT, "Shift"},
-	{VK_LSHIFT, "Shift"},        {VK_RSHIFT, "Shift"},         {VK_LWIN, "Win"},
-	{VK_RWIN, "Win"},            {VK_RETURN, "Enter"},         {VK_SPACE, "Space"},
-	{VK_BACK, "Backspace"},      {VK_TAB, "Tab"},              {VK_ESCAPE, "Escape"},
-	{VK_PRIOR, "Page Up"},       {VK_NEXT, "Page Down"},       {VK_END, "End"},
-	{VK_HOME, "Home"},           {VK_LEFT, "Left Arrow"},      {VK_UP, "Up Arrow"},
-	{VK_RIGHT, "Right Arrow"},   {VK_DOWN, "Down Arrow"},      {VK_INSERT, "Insert"},
-	{VK_DELETE, "Delete"},       {VK_F1, "F1"},                {VK_F2, "F2"},
-	{VK_F3, "F3"},               {VK_F4, "F4"},                {VK_F5, "F5"},
-	{VK_F6, "F6"},               {VK_F7, "F7"},                {VK_F8, "F8"},
-	{VK_F9, "F9"},               {VK_F10, "F10"},              {VK_F11, "F11"},
-	{VK_F12, "F12"}};
+		case VK_CONTROL:
+		case VK_LCONTROL:
+		case VK_RCONTROL:
+			key.modifierRank = MODIFIER_RANK_CTRL;
+			break;
+		case VK_LWIN:
+		case VK_RWIN:
+			key.modifierRank = MODIFIER_RANK_SUPER;
+			break;
+		case VK_MENU:
+		case VK_LMENU:
+		case VK_RMENU:
+			key.modifierRank = MODIFIER_RANK_ALT;
+			break;
+		case VK_SHIFT:
+		case VK_LSHIFT:
+		case VK_RSHIFT:
+#else
+		case kVK_Control:
+		case kVK_RightControl:
+			key.modifierRank = MODIFIER_RANK_CTRL;
+			break;
+		case kVK_Command:
+		case kVK_RightCommand:
+			key.modifierRank = MODIFIER_RANK_SUPER;
+			break;
+		case kVK_Option:
+		case kVK_RightOption:
+			key.modifierRank = MODIFIER_RANK_ALT;
+			break;
+		case kVK_Shift:
+		case kVK_RightShift:
 #endif
+			key.modifierRank = MODIFIER_RANK_SHIFT;
+			key.classes |= KEY_CLASS_SHIFT;
+			break;
+		default:
+			break;
+		}
+	}
 
-#ifdef __APPLE__
-static const std::unordered_map<int, const char *> keyNameMap = {
-	{kVK_Control, "Ctrl"},          {kVK_RightControl, "Ctrl"},   {kVK_Command, "Cmd"},
-	{kVK_RightCommand, "Cmd"},      {kVK_Option, "Alt"},          {kVK_RightOption, "Alt"},
-	{kVK_Shift, "Shift"},           {kVK_RightShift, "Shift"},    {kVK_ANSI_KeypadEnter, "Enter"},
-	{kVK_Return, "Enter"},          {kVK_Space, "Space"},         {kVK_Delete, "Backspace"},
-	{kVK_Tab, "Tab"},               {kVK_Escape, "Escape"},       {kVK_PageUp, "Page Up"},
-	{kVK_PageDown, "Page Down"},    {kVK_End, "End"},             {kVK_Home, "Home"},
-	{kVK_LeftArrow, "Left Arrow"},  {kVK_UpArrow, "Up Arrow"},    {kVK_RightArrow, "Right Arrow"},
-	{kVK_DownArrow, "Down Arrow"},  {kVK_Help, "Insert"},         {kVK_F1, "F1"},
-	{kVK_F2, "F2"},                 {kVK_F3, "F3"},               {kVK_F4, "F4"},
-	{kVK_F5, "F5"},                 {kVK_F6, "F6"},               {kVK_F7, "F7"},
-	{kVK_F8, "F8"},                 {kVK_F9, "F9"},               {kVK_F10, "F10"},
-	{kVK_F11, "F11"},               {kVK_F12, "F12"}};
+	if (numpadKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_NUMPAD;
+	}
+	if (numberKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_NUMBER;
+	}
+	if (letterKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_LETTER;
+	}
+	if (punctuationKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_PUNCTUATION;
+	}
+	if (singleKeys.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_SINGLE;
+	}
+	if (whitelistedKeySet.count(keyCode) > 0) {
+		key.classes |= KEY_CLASS_WHITELISTED;
+	}
 #endif
 
-#ifdef __linux__
-static const std::unordered_map<int, const char *> keyNameMap = {
-	{XK_Control_L, "Ctrl"},    {XK_Control_R, "Ctrl"},   {XK_Super_L, "Super"},
-	{XK_Super_R, "Super"},     {XK_Alt_L, "Alt"},        {XK_Alt_R, "Alt"},
-	{XK_Shift_L, "Shift"},     {XK_Shift_R, "Shift"},    {XK_Return, "Enter"},
-	{XK_space, "Space"},       {XK_BackSpace, "Backspace"}, {XK_Tab, "Tab"},
-	{XK_Escape, "Escape"},     {XK_Page_Up, "Page Up"},  {XK_Page_Down, "Page Down"},
-	{XK_End, "End"},           {XK_Home, "Home"},        {XK_Left, "Left Arrow"},
-	{XK_Up, "Up Arrow"},       {XK_Right, "Right Arrow"}, {XK_Down, "Down Arrow"},
-	{XK_Insert, "Insert"},     {XK_Delete, "Delete"},    {XK_F1, "F1"},
-	{XK_F2, "F2"},             {XK_F3, "F3"},            {XK_F4, "F4"},
-	{XK_F5, "F5"},             {XK_F6, "F6"},            {XK_F7, "F7"},
-	{XK_F8, "F8"},             {XK_F9, "F9"},            {XK_F10, "F10"},
-	{XK_F11, "F11"},           {XK_F12, "F12"}};
-#endif
+	return key;
+}
+
+// Per-application capture settings. Only the Linux backend follows the focused window; elsewhere
+// the default profile (the global settings) stays active.
+CaptureProfileSwitcher captureProfiles;
+
+// Platform-neutral capture core; the hooks below only translate OS events into engine calls
+HotkeyEngine hotkeyEngine(classifyKey, getKeyName, chordDispatcher());
+ChordEventBus chordEventBus;
+ChordLog chordLog; // Backs the dock's history view
 
-bool isModifierKeyPressed()
+// Drag gestures (opt-in). The tracker belongs to whichever thread runs the mouse hook.
+MotionTracker mouseMotion;
+std::atomic<bool> mouseMotionEnabled{false};
+std::atomic<uint32_t> mouseMotionRate{StyleConstants::DEFAULT_MOUSE_MOTION_RATE}; // Samples per second
+
+// Hook thread. Drops a drag in progress once motion capture is switched off.
+bool mouseMotionActive()
 {
-	std::lock_guard<std::mutex> lock(keyStateMutex);
-	for (const int key : activeModifiers) {
-		if (pressedKeys.count(key)) {
-			return true;
-		}
+	if (mouseMotionEnabled.load(std::memory_order_relaxed)) {
+		return true;
 	}
+	mouseMotion.reset();
 	return false;
 }
 
-std::string getKeyName(int vkCode)
+void finishMouseDrag(MotionButton button, int32_t x, int32_t y, uint64_t timestamp)
 {
-	// Try lookup table first (O(1) average case)
-	auto it = keyNameMap.find(vkCode);
-	if (it != keyNameMap.end()) {
-		return it->second;
+	MotionGesture gesture;
+	if (mouseMotion.buttonUp(button, x, y, timestamp, gesture)) {
+		hotkeyEngine.mouseGesture(gesture, timestamp);
 	}
+}
 
-	// Fallback for keys not in lookup table
-#ifdef _WIN32
-	UINT scanCode = MapVirtualKey(vkCode, MAPVK_VK_TO_VSC);
-	char keyName[128];
-	if (GetKeyNameTextA(scanCode << 16, keyName, sizeof(keyName)) > 0) {
-		return std::string(keyName);
+// Event bus sinks. They run on the dispatcher thread, so everything that allocates (Qt strings,
+// obs_data, logging) happens here instead of on the capture path.
+// Releases only feed websocket subscriptions and the held time of output templates; they are never
+// shown or recorded.
+void logChordSink(const ChordEvent &chord, void *)
+{
+	// Count updates of a merged burst would log the same action again
+	if (enableLogging && chord.kind != ChordKind::Release && !chord.replacesPrevious) {
+		ChordText display;
+		formatChordDisplay(chord, display);
+		const char *what = "Mouse action detected";
+		if (chord.kind == ChordKind::Keyboard) {
+			what = "Keys pressed";
+		} else if (chord.kind == ChordKind::Gamepad) {
+			what = "Gamepad input";
+		} else if (chord.kind == ChordKind::Gesture) {
+			what = "Mouse gesture";
+		}
+		blog(LOG_INFO, "[StreamUP Hotkey Display] %s: %s", what, display.c_str());
 	}
-#endif
-
-	return "Unknown";
 }
 
-std::string getCurrentCombination()
+// Dispatcher thread only: {apm} and {held_ms} of the output templates
+ChordRateMeter shownChordRate;
+uint64_t shownChordHash = 0;
+uint64_t shownChordTime = 0; // 0 once the shown chord's held time has been sent
+
+void dockChordSink(const ChordEvent &chord, void *)
 {
-	std::lock_guard<std::mutex> lock(keyStateMutex);
+	HotkeyDisplayDock *dock = hotkeyDisplayDock;
+	if (!dock) {
+		return;
+	}
 
-	std::vector<int> orderedKeys;
-#ifdef _WIN32
-	orderedKeys = {VK_CONTROL, VK_LCONTROL, VK_RCONTROL, VK_LWIN,   VK_RWIN,  VK_MENU,
-		       VK_LMENU,   VK_RMENU,    VK_SHIFT,    VK_LSHIFT, VK_RSHIFT};
-#endif
+	if (chord.kind == ChordKind::Release) {
+		// The release repeats the chord, so the held time is known now and not when it was shown
+		if (shownChordTime != 0 && chord.hash == shownChordHash && dock->outputsWantHeldTime()) {
+			int64_t heldMs = (int64_t)((chord.timestamp - shownChordTime) / 1000000);
+			shownChordTime = 0;
+			dock->postHeldTime(heldMs);
+		}
+		return;
+	}
 
-#ifdef __APPLE__
-	orderedKeys = {kVK_Control,      kVK_Command,      kVK_Option,      kVK_Shift,
-		       kVK_RightControl, kVK_RightCommand, kVK_RightOption, kVK_RightShift};
-#endif
+	if (!chord.replacesPrevious) {
+		shownChordRate.add(chord.timestamp);
+	}
+	const CaptureProfile *profile = captureProfiles.active();
+	dock->postChord(chord, profile ? std::string_view(profile->prefix) : std::string_view(),
+			profile ? std::string_view(profile->windowClass) : std::string_view(),
+			shownChordRate.perMinute(chord.timestamp));
+	shownChordHash = chord.hash;
+	shownChordTime = chord.timestamp;
+}
+
+void historyChordSink(const ChordEvent &chord, void *)
+{
+	if (chord.kind != ChordKind::Release) {
+		chordLog.record(chord);
+	}
+}
 
 #ifdef __linux__
-	orderedKeys = {XK_Control_L, XK_Control_R, XK_Super_L, XK_Super_R, XK_Alt_L, XK_Alt_R, XK_Shift_L, XK_Shift_R};
+// Local companion apps read chords straight from shared memory (see streamup-hotkey-core-shm.hpp)
+ShmRingWriter sharedEventRing;
+
+void sharedRingChordSink(const ChordEvent &chord, void *)
+{
+	uint8_t flags = chord.replacesPrevious ? SHM_RECORD_REPLACES_PREVIOUS : 0;
+	sharedEventRing.write((uint8_t)chord.kind, flags, chord.timestamp, chord.keys, chord.keyCount, chord.text.c_str(),
+			      chord.text.size());
+}
 #endif
 
-	std::vector<std::string> keys;
-	keys.reserve(pressedKeys.size()); // Pre-allocate space for efficiency
+#ifndef _WIN32
+// Optional NDJSON stream for local scripts (see streamup-hotkey-core-socket.hpp)
+ChordSocketServer chordSocketServer(getKeyName);
 
-	// Add modifier keys in order
-	for (const int key : orderedKeys) {
-		if (pressedKeys.count(key)) {
-			keys.push_back(getKeyName(key));
-		}
+void socketChordSink(const ChordEvent &chord, void *)
+{
+	chordSocketServer.publish(chord);
+}
+
+void applyEventSocketSetting(bool enabled)
+{
+	if (enabled == chordSocketServer.isRunning()) {
+		return;
 	}
 
-	// Add non-modifier keys
-	for (const int key : pressedKeys) {
-		if (modifierKeys.find(key) == modifierKeys.end()) {
-			keys.push_back(getKeyName(key));
-		}
+	if (!enabled) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Event socket stopped (%llu events dropped for slow clients)",
+		     (unsigned long long)chordSocketServer.droppedCount());
+		chordSocketServer.stop();
+		return;
 	}
 
-	// Join keys with " + " separator
-	std::string combination;
-	if (!keys.empty()) {
-		combination = keys[0];
-		for (size_t i = 1; i < keys.size(); ++i) {
-			combination += " + " + keys[i];
-		}
+	std::string path = ChordSocketServer::defaultPath();
+	if (chordSocketServer.start(path)) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Event socket listening on %s", path.c_str());
+	} else {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to open event socket %s", path.c_str());
 	}
+}
+
+// Optional overlay page and SSE stream for browser sources (see streamup-hotkey-core-http.hpp)
+ChordHttpServer overlayServer(getKeyName);
 
-	return combination;
+void overlayChordSink(const ChordEvent &chord, void *)
+{
+	overlayServer.publish(chord);
 }
 
-bool shouldCaptureSingleKey(int keyCode)
+void applyOverlayServerSetting(bool enabled, int port)
 {
-	// Check if key is in the whitelist
-	if (whitelistedKeySet.count(keyCode) > 0) {
-		return true;
+	if (port < 1 || port > 65535) {
+		port = StyleConstants::DEFAULT_OVERLAY_PORT;
+	}
+	if (enabled == overlayServer.isRunning() && (!enabled || port == overlayServer.port())) {
+		return;
 	}
 
-	// Check category-based capture settings
-	if (captureNumpad && numpadKeys.count(keyCode) > 0) {
-		return true;
+	if (overlayServer.isRunning()) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Browser overlay stopped (%llu events dropped for slow clients)",
+		     (unsigned long long)overlayServer.droppedCount());
+		overlayServer.stop();
 	}
-	if (captureNumbers && numberKeys.count(keyCode) > 0) {
-		return true;
+	if (!enabled) {
+		return;
 	}
-	if (captureLetters && letterKeys.count(keyCode) > 0) {
-		return true;
+
+	// Read once per start; edits to the shipped page take effect the next time the server starts
+	char *pagePath = obs_module_file("overlay.html");
+	char *page = pagePath ? os_quick_read_utf8_file(pagePath) : nullptr;
+	if (!page) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to read the browser overlay page");
 	}
-	if (capturePunctuation && punctuationKeys.count(keyCode) > 0) {
-		return true;
+
+	if (overlayServer.start((uint16_t)port, page ? page : "")) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Browser overlay listening on http://127.0.0.1:%d/", port);
+	} else {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to listen on 127.0.0.1:%d for the browser overlay", port);
 	}
+	bfree(page);
+	bfree(pagePath);
+}
+#endif
 
-	// Check if it's in the default singleKeys set (F1-F12, Insert, Delete, etc.)
-	if (singleKeys.count(keyCode) > 0) {
-		return true;
+// Opt-in low-latency capture. Each capture thread applies the config to itself when it sees
+// lowLatencyChanged; the dispatcher does the same through ChordDispatcher::setLowLatency().
+std::mutex lowLatencyMutex;
+LowLatencyConfig lowLatencyConfig; // Protected by lowLatencyMutex
+std::atomic<bool> lowLatencyEnabled{false};
+std::atomic<bool> lowLatencyChanged{false};
+LatencyHistogram captureWakeDelay; // Lateness of the capture thread's timer wakeups
+
+constexpr uint64_t LATENCY_REPORT_INTERVAL_NS = 30ull * 1000000000ull;
+
+void logLatencySummary(const char *what, const LatencyHistogram::Summary &summary)
+{
+	if (summary.count > 0) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] %s: %llu samples, p50 <= %llu us, p99 <= %llu us, max %llu us", what,
+		     (unsigned long long)summary.count, (unsigned long long)summary.p50Us, (unsigned long long)summary.p99Us,
+		     (unsigned long long)summary.maxUs);
 	}
+}
 
-	return false;
+// Logs the scheduling delays measured since the last report
+void reportCaptureLatency()
+{
+	ThreadLatencyResult dispatcher = chordDispatcher().appliedLatency();
+	blog(LOG_INFO, "[StreamUP Hotkey Display] Low-latency mode: dispatcher thread %s%s",
+	     threadPriorityLevelName(dispatcher.level), dispatcher.pinned ? ", pinned" : "");
+	logLatencySummary("Capture thread wakeup delay", captureWakeDelay.takeSummary());
+	logLatencySummary("Capture to dispatch delay", chordDispatcher().takeDispatchDelay());
 }
 
-bool shouldLogCombination()
+// Called on the capture thread that owns the hook
+void applyCaptureThreadLatency(const char *threadName)
 {
-	std::lock_guard<std::mutex> lock(keyStateMutex);
+	LowLatencyConfig config;
+	{
+		std::lock_guard<std::mutex> lock(lowLatencyMutex);
+		config = lowLatencyConfig;
+	}
 
-	// Check if SHIFT is the only modifier
-	bool onlyShiftPressed = false;
-#ifdef _WIN32
-	onlyShiftPressed = activeModifiers.size() == 1 &&
-	    (activeModifiers.count(VK_SHIFT) > 0 || activeModifiers.count(VK_LSHIFT) > 0 || activeModifiers.count(VK_RSHIFT) > 0);
-#elif defined(__APPLE__)
-	onlyShiftPressed = activeModifiers.size() == 1 && (activeModifiers.count(kVK_Shift) > 0 || activeModifiers.count(kVK_RightShift) > 0);
-#elif defined(__linux__)
-	onlyShiftPressed = activeModifiers.size() == 1 && (activeModifiers.count(XK_Shift_L) > 0 || activeModifiers.count(XK_Shift_R) > 0);
+	ThreadLatencyResult result = applyThreadLatencyMode(config);
+	if (!config.enabled) {
+		return;
+	}
+	if (result.level == ThreadPriorityLevel::Normal) {
+		blog(LOG_WARNING,
+		     "[StreamUP Hotkey Display] %s could not raise its priority (needs RLIMIT_RTPRIO, RLIMIT_NICE or "
+		     "CAP_SYS_NICE), running at normal priority",
+		     threadName);
+	} else {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] %s running at %s priority", threadName,
+		     threadPriorityLevelName(result.level));
+	}
+	if (config.cpu >= 0 && !result.pinned) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] %s could not be pinned to CPU %d", threadName, config.cpu);
+	}
+}
+
+void applyLowLatencySetting(const LowLatencyConfig &config)
+{
+	{
+		std::lock_guard<std::mutex> lock(lowLatencyMutex);
+		if (config.enabled == lowLatencyConfig.enabled && config.cpu == lowLatencyConfig.cpu) {
+			return;
+		}
+		lowLatencyConfig = config;
+	}
+
+	if (!config.enabled && lowLatencyEnabled) {
+		reportCaptureLatency();
+	}
+	lowLatencyEnabled = config.enabled;
+	lowLatencyChanged = true;
+	chordDispatcher().setLowLatency(config);
+
+#ifdef __linux__
+	if (sharedEventRing.isOpen() && !sharedEventRing.setMemoryLocked(config.enabled)) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Could not lock the shared-memory event ring (RLIMIT_MEMLOCK)");
+	}
 #endif
+	blog(LOG_INFO, "[StreamUP Hotkey Display] Low-latency capture %s", config.enabled ? "enabled" : "disabled");
+}
 
-	if (onlyShiftPressed) {
-		// Allow SHIFT + any non-modifier key (F keys, letters, numbers, etc.)
-		// Only block SHIFT by itself (no other keys pressed)
-		for (const int key : pressedKeys) {
-			if (modifierKeys.find(key) == modifierKeys.end()) {
-				return true; // Found a non-modifier key, so allow logging
-			}
+// Keystroke subtitles written next to each recording
+SubtitleWriter subtitleWriter;
+std::atomic<int> subtitleFormatSetting{(int)SubtitleFormat::Off};
+std::atomic<int> subtitleCueMs{StyleConstants::DEFAULT_ONSCREEN_TIME};
+
+void subtitleChordSink(const ChordEvent &chord, void *)
+{
+	if (chord.kind != ChordKind::Release) {
+		subtitleWriter.push(chord, (uint64_t)subtitleCueMs.load(std::memory_order_relaxed) * 1000000ull);
+	}
+}
+
+SubtitleFormat parseSubtitleFormat(const char *name)
+{
+	if (strcmp(name, "srt") == 0) {
+		return SubtitleFormat::Srt;
+	}
+	if (strcmp(name, "vtt") == 0) {
+		return SubtitleFormat::WebVtt;
+	}
+	if (strcmp(name, "binary") == 0) {
+		return SubtitleFormat::Binary;
+	}
+	return SubtitleFormat::Off;
+}
+
+// Same path as the recording with the subtitle extension, e.g. "2024-05-01 20-15-03.srt"
+std::string subtitlePathForRecording(SubtitleFormat format)
+{
+	std::string path;
+	if (obs_output_t *output = obs_frontend_get_recording_output()) {
+		obs_data_t *outputSettings = obs_output_get_settings(output);
+		path = obs_data_get_string(outputSettings, "path");
+		if (path.empty()) {
+			path = obs_data_get_string(outputSettings, "url");
 		}
-		return false; // Only SHIFT is pressed, no action key
+		obs_data_release(outputSettings);
+		obs_output_release(output);
 	}
-	return true;
+
+	if (path.empty()) {
+		// Custom outputs may not expose a file path; fall back to the recording directory
+		char *directory = obs_frontend_get_current_record_output_path();
+		if (!directory) {
+			return path;
+		}
+		char fileName[64];
+		time_t now = time(nullptr);
+		strftime(fileName, sizeof(fileName), "/%Y-%m-%d %H-%M-%S keys", localtime(&now));
+		path = std::string(directory) + fileName;
+		bfree(directory);
+	} else {
+		size_t separator = path.find_last_of("/\\");
+		size_t dot = path.find_last_of('.');
+		if (dot != std::string::npos && (separator == std::string::npos || dot > separator)) {
+			path.erase(dot);
+		}
+	}
+
+	return path + subtitleFileExtension(format);
 }
 
-void emitWebSocketEvent(const std::string &keyCombination)
+void startRecordingSubtitles()
 {
-	if (!websocket_vendor) {
+	SubtitleFormat format = (SubtitleFormat)subtitleFormatSetting.load(std::memory_order_relaxed);
+	if (format == SubtitleFormat::Off) {
 		return;
 	}
 
-	obs_data_t *event_data = obs_data_create();
-	obs_data_set_string(event_data, "key_combination", keyCombination.c_str());
+	uint64_t startTime = hotkeyCoreTimeNs();
+	std::string path = subtitlePathForRecording(format);
+	FILE *file = path.empty() ? nullptr : os_fopen(path.c_str(), "wb");
+	if (subtitleWriter.start(file, format, startTime)) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Writing keystroke subtitles to %s", path.c_str());
+	} else {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to create keystroke subtitle file %s", path.c_str());
+	}
+}
 
-	// Add all key presses as an array
-	obs_data_array_t *key_presses_array = obs_data_array_create();
-	{
-		std::lock_guard<std::mutex> lock(keyStateMutex);
-		for (const int key : pressedKeys) {
-			obs_data_t *key_data = obs_data_create();
-			obs_data_set_string(key_data, "key", getKeyName(key).c_str());
-			obs_data_array_push_back(key_presses_array, key_data);
-			obs_data_release(key_data);
+void stopRecordingSubtitles()
+{
+	if (!subtitleWriter.isActive()) {
+		return;
+	}
+
+	uint64_t droppedCues = subtitleWriter.stop(hotkeyCoreTimeNs());
+	if (droppedCues > 0) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] %llu keystroke subtitles were dropped",
+		     (unsigned long long)droppedCues);
+	}
+}
+
+// Multi-stroke shortcuts ("Ctrl + K, Ctrl + C"); the dictionary is compiled from the settings
+SequenceMatcher sequenceMatcher;
+
+// Memory-mapped shortcut-to-action dictionary, swapped as a whole when the setting changes
+std::mutex actionDictionaryMutex;
+std::unique_ptr<ActionDictionary> actionDictionary;
+std::string actionDictionaryPath; // UI thread only
+
+void applyActionDictionarySetting(const std::string &path)
+{
+	if (path == actionDictionaryPath) {
+		return;
+	}
+	actionDictionaryPath = path;
+
+	// Map the new file before taking the lock; the old mapping is released outside it
+	std::unique_ptr<ActionDictionary> dictionary;
+	if (!path.empty()) {
+		dictionary = std::make_unique<ActionDictionary>();
+		if (dictionary->open(path)) {
+			blog(LOG_INFO, "[StreamUP Hotkey Display] Loaded %u shortcut actions from %s", dictionary->entryCount(),
+			     path.c_str());
+		} else {
+			blog(LOG_WARNING, "[StreamUP Hotkey Display] Failed to load shortcut dictionary %s", path.c_str());
+			dictionary.reset();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(actionDictionaryMutex);
+	actionDictionary.swap(dictionary);
+}
+
+ChordEvent labelledChord; // Dispatcher thread only
+
+void publishChordEvent(const ChordEvent &chord)
+{
+	// The last step of a sequence is shown as the whole sequence
+	const ChordEvent *shown = &chord;
+	if (sequenceMatcher.feed(chord, labelledChord)) {
+		shown = &labelledChord;
+	}
+
+	// Add what the chord does, e.g. "Ctrl + Shift + P (Command Palette)"
+	if (shown->kind != ChordKind::Release && shown->action.empty()) {
+		// The focused application's section first, then the global one
+		const CaptureProfile *profile = captureProfiles.active();
+		std::string_view application = profile ? std::string_view(profile->application) : std::string_view();
+		std::lock_guard<std::mutex> lock(actionDictionaryMutex);
+		std::string_view label = actionDictionary ? actionDictionary->lookup(shown->hash, application) : std::string_view();
+		if (!label.empty()) {
+			if (shown != &labelledChord) {
+				labelledChord = chord;
+				shown = &labelledChord;
+			}
+			labelledChord.action.assign(label);
 		}
 	}
-	obs_data_set_array(event_data, "key_presses", key_presses_array);
-	obs_data_array_release(key_presses_array);
 
-	obs_websocket_vendor_emit_event(websocket_vendor, "key_pressed", event_data);
-	obs_data_release(event_data);
+	chordEventBus.publish(*shown);
+}
+
+// Merges bursts of scroll notches and repeated clicks before they reach the bus
+ChordCoalescer mouseCoalescer(publishChordEvent);
+
+void dispatchChordEvent(const ChordEvent &chord)
+{
+	mouseCoalescer.push(chord, hotkeyCoreTimeNs());
+}
+
+uint64_t flushChordEvents(uint64_t now)
+{
+	return mouseCoalescer.flush(now);
 }
 
 #ifdef _WIN32
@@ -379,52 +667,9 @@ LRESULT CALLBACK KeyboardProc(int nCode, WPARAM wParam, LPARAM lParam)
 	if (nCode == HC_ACTION) {
 		KBDLLHOOKSTRUCT *p = (KBDLLHOOKSTRUCT *)lParam;
 		if (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN) {
-			{
-				std::lock_guard<std::mutex> lock(keyStateMutex);
-				pressedKeys.insert(p->vkCode);
-				if (modifierKeys.count(p->vkCode)) {
-					activeModifiers.insert(p->vkCode);
-				}
-			}
-
-			if ((pressedKeys.size() > 1 && isModifierKeyPressed() && shouldLogCombination()) ||
-			    (shouldCaptureSingleKey(p->vkCode) && !activeModifiers.count(VK_SHIFT) && !activeModifiers.count(VK_LSHIFT) &&
-			     !activeModifiers.count(VK_RSHIFT))) {
-				std::string keyCombination = getCurrentCombination();
-				bool shouldLog = false;
-				{
-					std::lock_guard<std::mutex> lock(keyStateMutex);
-					if (loggedCombinations.find(keyCombination) == loggedCombinations.end()) {
-						loggedCombinations.insert(keyCombination);
-						shouldLog = true;
-					}
-				}
-				if (shouldLog) {
-					if (enableLogging) {
-						blog(LOG_INFO, "[StreamUP Hotkey Display] Keys pressed: %s", keyCombination.c_str());
-					}
-					if (hotkeyDisplayDock) {
-						hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-					}
-					emitWebSocketEvent(keyCombination);
-				}
-			}
+			hotkeyEngine.keyEvent(p->vkCode, true, false, hotkeyCoreTimeNs());
 		} else if (wParam == WM_KEYUP || wParam == WM_SYSKEYUP) {
-			bool shouldClearCombinations = false;
-			{
-				std::lock_guard<std::mutex> lock(keyStateMutex);
-				pressedKeys.erase(p->vkCode);
-				if (modifierKeys.count(p->vkCode)) {
-					activeModifiers.erase(p->vkCode);
-				}
-
-				// Check if we should clear combinations while holding the lock
-				if (activeModifiers.empty() ||
-				    std::none_of(activeModifiers.begin(), activeModifiers.end(),
-				                 [](int key) { return pressedKeys.count(key) > 0; })) {
-					loggedCombinations.clear();
-				}
-			}
+			hotkeyEngine.keyEvent(p->vkCode, false, false, hotkeyCoreTimeNs());
 		}
 	}
 	return CallNextHookEx(keyboardHook, nCode, wParam, lParam);
@@ -435,61 +680,71 @@ LRESULT CALLBACK MouseProc(int nCode, WPARAM wParam, LPARAM lParam)
 	if (nCode == HC_ACTION) {
 		MSLLHOOKSTRUCT *p = (MSLLHOOKSTRUCT *)lParam;
 
-		// Only proceed if a modifier key is pressed
-		if (isModifierKeyPressed()) {
-			std::string keyCombination = getCurrentCombination(); // Get current key combination with any modifiers
+		// Drags: every move only updates the tracker's latest position
+		if (mouseMotionActive()) {
+			uint64_t now = hotkeyCoreTimeNs();
+			switch (wParam) {
+			case WM_MOUSEMOVE:
+				mouseMotion.move(p->pt.x, p->pt.y, now);
+				break;
+			case WM_LBUTTONDOWN:
+				mouseMotion.buttonDown(MotionButton::Left, p->pt.x, p->pt.y, now);
+				break;
+			case WM_RBUTTONDOWN:
+				mouseMotion.buttonDown(MotionButton::Right, p->pt.x, p->pt.y, now);
+				break;
+			case WM_MBUTTONDOWN:
+				mouseMotion.buttonDown(MotionButton::Middle, p->pt.x, p->pt.y, now);
+				break;
+			case WM_LBUTTONUP:
+				finishMouseDrag(MotionButton::Left, p->pt.x, p->pt.y, now);
+				break;
+			case WM_RBUTTONUP:
+				finishMouseDrag(MotionButton::Right, p->pt.x, p->pt.y, now);
+				break;
+			case WM_MBUTTONUP:
+				finishMouseDrag(MotionButton::Middle, p->pt.x, p->pt.y, now);
+				break;
+			}
+		}
 
-			bool actionDetected = false;
+		// Only proceed if a modifier key is pressed
+		if (hotkeyEngine.anyModifierPressed()) {
+			const char *action = nullptr;
 
 			// Handle mouse button clicks
 			switch (wParam) {
 			case WM_LBUTTONDOWN:
-				keyCombination += " + Left Click";
-				actionDetected = true;
+				action = " + Left Click";
 				break;
 			case WM_RBUTTONDOWN:
-				keyCombination += " + Right Click";
-				actionDetected = true;
+				action = " + Right Click";
 				break;
 			case WM_MBUTTONDOWN:
-				keyCombination += " + Middle Click";
-				actionDetected = true;
+				action = " + Middle Click";
 				break;
 			case WM_XBUTTONDOWN:
 				if (HIWORD(p->mouseData) == XBUTTON1) {
-					keyCombination += " + X Button 1";
+					action = " + X Button 1";
 				} else if (HIWORD(p->mouseData) == XBUTTON2) {
-					keyCombination += " + X Button 2";
+					action = " + X Button 2";
+				} else {
+					action = "";
 				}
-				actionDetected = true;
 				break;
 			}
 
 			// Handle scroll actions
+			bool scroll = wParam == WM_MOUSEWHEEL || wParam == WM_MOUSEHWHEEL;
 			if (wParam == WM_MOUSEWHEEL) {
-				if (GET_WHEEL_DELTA_WPARAM(p->mouseData) > 0)
-					keyCombination += " + Scroll Up";
-				else
-					keyCombination += " + Scroll Down";
-				actionDetected = true;
+				action = GET_WHEEL_DELTA_WPARAM(p->mouseData) > 0 ? " + Scroll Up" : " + Scroll Down";
 			} else if (wParam == WM_MOUSEHWHEEL) {
-				if (GET_WHEEL_DELTA_WPARAM(p->mouseData) > 0)
-					keyCombination += " + Scroll Right";
-				else
-					keyCombination += " + Scroll Left";
-				actionDetected = true;
+				action = GET_WHEEL_DELTA_WPARAM(p->mouseData) > 0 ? " + Scroll Right" : " + Scroll Left";
 			}
 
-			// Log and display the key combination if an action was detected
-			if (actionDetected) {
-				if (enableLogging) {
-			if (enableLogging) {
-					blog(LOG_INFO, "[StreamUP Hotkey Display] Mouse action detected: %s", keyCombination.c_str());
-				}
-			}
-				if (hotkeyDisplayDock) {
-					hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-				}
+			// Display the key combination if an action was detected
+			if (action) {
+				hotkeyEngine.mouseAction(action, hotkeyCoreTimeNs(), scroll);
 			}
 		}
 	}
@@ -500,6 +755,7 @@ LRESULT CALLBACK MouseProc(int nCode, WPARAM wParam, LPARAM lParam)
 
 #ifdef __APPLE__
 CFMachPortRef eventTap = nullptr;
+bool eventTapTracksDrags = false; // The tap also receives mouse-up and dragged events
 
 CGEventRef CGEventCallback(CGEventTapProxy proxy, CGEventType type, CGEventRef event, void *refcon);
 
@@ -528,7 +784,7 @@ void startMacOSKeyboardHook()
 		if (hotkeyDisplayDock) {
 			QString errorTitle = QString::fromUtf8(obs_module_text("Error.Accessibility.Permission"));
 			QString errorInstructions = QString::fromUtf8(obs_module_text("Error.Accessibility.Instructions"));
-			hotkeyDisplayDock->setLog(errorTitle + "\n\n" + errorInstructions);
+			hotkeyDisplayDock->showMessage(errorTitle + "\n\n" + errorInstructions);
 		}
 		return;
 	}
@@ -537,6 +793,14 @@ void startMacOSKeyboardHook()
 	CGEventMask eventMask = CGEventMaskBit(kCGEventKeyDown) | CGEventMaskBit(kCGEventKeyUp) |
 				CGEventMaskBit(kCGEventLeftMouseDown) | CGEventMaskBit(kCGEventRightMouseDown) |
 				CGEventMaskBit(kCGEventOtherMouseDown) | CGEventMaskBit(kCGEventScrollWheel);
+	// Every pointer move during a drag would wake the callback, so only while drags are captured.
+	// The tap is created again when the setting changes.
+	eventTapTracksDrags = mouseMotionEnabled.load(std::memory_order_relaxed);
+	if (eventTapTracksDrags) {
+		eventMask |= CGEventMaskBit(kCGEventLeftMouseUp) | CGEventMaskBit(kCGEventRightMouseUp) |
+			     CGEventMaskBit(kCGEventOtherMouseUp) | CGEventMaskBit(kCGEventLeftMouseDragged) |
+			     CGEventMaskBit(kCGEventRightMouseDragged) | CGEventMaskBit(kCGEventOtherMouseDragged);
+	}
 
 	eventTap = CGEventTapCreate(kCGSessionEventTap, kCGHeadInsertEventTap, kCGEventTapOptionDefault,
 				    eventMask, CGEventCallback, nullptr);
@@ -544,7 +808,7 @@ void startMacOSKeyboardHook()
 	if (!eventTap) {
 		blog(LOG_ERROR, "[StreamUP Hotkey Display] Failed to create event tap!");
 		if (hotkeyDisplayDock) {
-			hotkeyDisplayDock->setLog(QString::fromUtf8(obs_module_text("Error.EventTap.Failed")));
+			hotkeyDisplayDock->showMessage(QString::fromUtf8(obs_module_text("Error.EventTap.Failed")));
 		}
 		return;
 	}
@@ -560,6 +824,8 @@ void startMacOSKeyboardHook()
 void stopMacOSKeyboardHook()
 {
 	if (eventTap) {
+		// Also removes its source from the run loop, so the tap stops receiving events
+		CFMachPortInvalidate(eventTap);
 		CFRelease(eventTap);
 		eventTap = nullptr;
 	}
@@ -570,96 +836,89 @@ CGEventRef CGEventCallback(CGEventTapProxy proxy, CGEventType type, CGEventRef e
 	(void)proxy;
 	(void)refcon;
 
-	// Handle keyboard events
-	if (type == kCGEventKeyDown || type == kCGEventKeyUp) {
-		CGKeyCode keyCode = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
-		bool keyDown = (type == kCGEventKeyDown);
-
-		if (keyDown) {
-			{
-				std::lock_guard<std::mutex> lock(keyStateMutex);
-				pressedKeys.insert(keyCode);
-				if (modifierKeys.count(keyCode)) {
-					activeModifiers.insert(keyCode);
-				}
+	// Drags: dragged events only update the tracker's latest position
+	if (type != kCGEventKeyDown && type != kCGEventKeyUp && mouseMotionActive()) {
+		CGPoint location = CGEventGetLocation(event);
+		int32_t x = (int32_t)location.x;
+		int32_t y = (int32_t)location.y;
+		bool middle = CGEventGetIntegerValueField(event, kCGMouseEventButtonNumber) == 2;
+		uint64_t now = hotkeyCoreTimeNs();
+		switch (type) {
+		case kCGEventLeftMouseDragged:
+		case kCGEventRightMouseDragged:
+		case kCGEventOtherMouseDragged:
+			mouseMotion.move(x, y, now);
+			break;
+		case kCGEventLeftMouseDown:
+			mouseMotion.buttonDown(MotionButton::Left, x, y, now);
+			break;
+		case kCGEventRightMouseDown:
+			mouseMotion.buttonDown(MotionButton::Right, x, y, now);
+			break;
+		case kCGEventOtherMouseDown:
+			if (middle) {
+				mouseMotion.buttonDown(MotionButton::Middle, x, y, now);
 			}
-		} else {
-			{
-				std::lock_guard<std::mutex> lock(keyStateMutex);
-				pressedKeys.erase(keyCode);
-				if (modifierKeys.count(keyCode)) {
-					activeModifiers.erase(keyCode);
-				}
-
-				// Check if we should clear combinations while holding the lock
-				if (activeModifiers.empty() ||
-				    std::none_of(activeModifiers.begin(), activeModifiers.end(),
-				                 [](int key) { return pressedKeys.count(key) > 0; })) {
-					loggedCombinations.clear();
-				}
+			break;
+		case kCGEventLeftMouseUp:
+			finishMouseDrag(MotionButton::Left, x, y, now);
+			break;
+		case kCGEventRightMouseUp:
+			finishMouseDrag(MotionButton::Right, x, y, now);
+			break;
+		case kCGEventOtherMouseUp:
+			if (middle) {
+				finishMouseDrag(MotionButton::Middle, x, y, now);
 			}
+			break;
+		default:
+			break;
 		}
+	}
 
-		if ((pressedKeys.size() > 1 && isModifierKeyPressed() && shouldLogCombination()) ||
-		    (shouldCaptureSingleKey(keyCode) && !activeModifiers.count(kVK_Shift) && !activeModifiers.count(kVK_RightShift))) {
-			std::string keyCombination = getCurrentCombination();
-			bool shouldLog = false;
-			{
-				std::lock_guard<std::mutex> lock(keyStateMutex);
-				if (loggedCombinations.find(keyCombination) == loggedCombinations.end()) {
-					loggedCombinations.insert(keyCombination);
-					shouldLog = true;
-				}
-			}
-			if (shouldLog) {
-				if (enableLogging) {
-				blog(LOG_INFO, "[StreamUP Hotkey Display] Keys pressed: %s", keyCombination.c_str());
-				}
-				if (hotkeyDisplayDock) {
-					hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-				}
-				emitWebSocketEvent(keyCombination);
-			}
-		}
+	// Handle keyboard events
+	if (type == kCGEventKeyDown || type == kCGEventKeyUp) {
+		CGKeyCode keyCode = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
+		bool autoRepeat = CGEventGetIntegerValueField(event, kCGKeyboardEventAutorepeat) != 0;
+		hotkeyEngine.keyEvent(keyCode, type == kCGEventKeyDown, autoRepeat, hotkeyCoreTimeNs());
 	}
 	// Handle mouse events (only when modifier keys are pressed)
 	else if (type == kCGEventLeftMouseDown || type == kCGEventRightMouseDown ||
 	         type == kCGEventOtherMouseDown || type == kCGEventScrollWheel) {
-		if (isModifierKeyPressed()) {
-			std::string keyCombination = getCurrentCombination();
+		if (hotkeyEngine.anyModifierPressed()) {
+			char buttonText[32];
+			const char *action = nullptr;
 
 			// Add mouse action to combination
 			if (type == kCGEventLeftMouseDown) {
-				keyCombination += " + Left Click";
+				action = " + Left Click";
 			} else if (type == kCGEventRightMouseDown) {
-				keyCombination += " + Right Click";
+				action = " + Right Click";
 			} else if (type == kCGEventOtherMouseDown) {
 				int64_t buttonNumber = CGEventGetIntegerValueField(event, kCGMouseEventButtonNumber);
 				if (buttonNumber == 2) {
-					keyCombination += " + Middle Click";
+					action = " + Middle Click";
 				} else {
-					keyCombination += " + Button " + std::to_string(buttonNumber + 1);
+					snprintf(buttonText, sizeof(buttonText), " + Button %d", (int)buttonNumber + 1);
+					action = buttonText;
 				}
 			} else if (type == kCGEventScrollWheel) {
 				int64_t deltaY = CGEventGetIntegerValueField(event, kCGScrollWheelEventDeltaAxis1);
 				int64_t deltaX = CGEventGetIntegerValueField(event, kCGScrollWheelEventDeltaAxis2);
 
 				if (deltaY > 0) {
-					keyCombination += " + Scroll Up";
+					action = " + Scroll Up";
 				} else if (deltaY < 0) {
-					keyCombination += " + Scroll Down";
+					action = " + Scroll Down";
 				} else if (deltaX > 0) {
-					keyCombination += " + Scroll Right";
+					action = " + Scroll Right";
 				} else if (deltaX < 0) {
-					keyCombination += " + Scroll Left";
+					action = " + Scroll Left";
 				}
 			}
 
-			if (enableLogging) {
-			blog(LOG_INFO, "[StreamUP Hotkey Display] Mouse action detected: %s", keyCombination.c_str());
-			if (hotkeyDisplayDock) {
-				hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-			}
+			if (action) {
+				hotkeyEngine.mouseAction(action, hotkeyCoreTimeNs(), type == kCGEventScrollWheel);
 			}
 		}
 	}
@@ -668,150 +927,285 @@ CGEventRef CGEventCallback(CGEventTapProxy proxy, CGEventType type, CGEventRef e
 #endif
 
 #ifdef __linux__
+// Connecting to X and building the keymap tables happen on the hook thread; the dock is told when they finish
+void notifyCaptureStarted(bool success)
+{
+	if (HotkeyDisplayDock *dock = hotkeyDisplayDock) {
+		QMetaObject::invokeMethod(dock, [dock, success]() { dock->onCaptureStarted(success); }, Qt::QueuedConnection);
+	}
+}
+
+// Window tracker callback (hook thread). Resolving the profile happens here, once per focus or
+// title change; key events only load the resulting pointer.
+void activeWindowChanged(const ActiveWindowInfo &window, void *)
+{
+	captureProfiles.activateWindow(window.instanceName, window.className, window.title);
+}
+
+// Gamepad capture reads /dev/input on the hook thread, so the dispatcher keeps a single
+// producer. Settings reach the thread through these flags.
+std::atomic<bool> gamepadCaptureEnabled{false};
+std::atomic<int> gamepadDeadzonePercent{StyleConstants::DEFAULT_GAMEPAD_DEADZONE};
+std::atomic<bool> gamepadSettingsChanged{false};
+
+void gamepadDeviceChanged(const GamepadDeviceInfo &device, bool connected, void *)
+{
+	blog(LOG_INFO, "[StreamUP Hotkey Display] Gamepad %s: %s (%s)", connected ? "connected" : "disconnected",
+	     device.name.c_str(), device.path.c_str());
+}
+
+// Called on the hook thread
+void applyGamepadSettings(GamepadDeviceMonitor &monitor)
+{
+	GamepadAxisSettings axisSettings;
+	axisSettings.stickDeadzone = (float)gamepadDeadzonePercent / 100.0f;
+	monitor.setAxisSettings(axisSettings);
+
+	if (gamepadCaptureEnabled == monitor.isRunning()) {
+		return;
+	}
+	if (!gamepadCaptureEnabled) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Gamepad capture stopped (%llu of %llu axis reports used)",
+		     (unsigned long long)monitor.axisReportsAccepted(), (unsigned long long)monitor.axisReports());
+		monitor.stop();
+		return;
+	}
+
+	if (!monitor.start("/dev/input", gamepadDeviceChanged, nullptr)) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Gamepad capture unavailable: cannot watch /dev/input");
+		return;
+	}
+	blog(LOG_INFO, "[StreamUP Hotkey Display] Gamepad capture started, %zu controller(s) found", monitor.deviceCount());
+	if (monitor.deviceCount() == 0 && monitor.inaccessibleCount() > 0) {
+		blog(LOG_WARNING,
+		     "[StreamUP Hotkey Display] %zu input devices are not readable; add your user to the \"input\" group "
+		     "to capture controllers",
+		     monitor.inaccessibleCount());
+	}
+}
+
 void linuxKeyboardHookThreadFunc()
 {
 	display = XOpenDisplay(nullptr);
 	if (!display) {
 		blog(LOG_ERROR, "[StreamUP Hotkey Display] Failed to open X display!");
 		linuxHookRunning = false;
+		notifyCaptureStarted(false);
 		return;
 	}
 
 	Window root = DefaultRootWindow(display);
 	XSelectInput(display, root, KeyPressMask | KeyReleaseMask | ButtonPressMask);
 
-	// Set up non-blocking event checking
-	int fd = ConnectionNumber(display);
-	fd_set readfds;
-	struct timeval tv;
+	// Held keys then repeat as KeyPress only, without a synthetic KeyRelease in between
+	Bool detectableAutoRepeat = False;
+	XkbSetDetectableAutoRepeat(display, True, &detectableAutoRepeat);
+	if (!detectableAutoRepeat) {
+		blog(LOG_INFO, "[StreamUP Hotkey Display] Detectable autorepeat not supported, filtering repeats by timestamp");
+	}
+
+	// Key labels and classes come from the active XKB keymap; tables are rebuilt on layout changes
+	if (!xkbKeymapCache().start(display)) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Keyboard layout unavailable, key names will show as Unknown");
+	}
+
+	// Per-application profiles follow _NET_ACTIVE_WINDOW notifications on the same connection
+	activeWindowTracker().start(display, activeWindowChanged, nullptr);
+
+	// Wait on the X connection and on every open controller with one poll()
+	GamepadDeviceMonitor gamepadMonitor(chordDispatcher());
+	gamepadSettingsChanged = true;
+	std::vector<pollfd> pollFds;
+	constexpr uint64_t POLL_TIMEOUT_NS = 100000000; // 100ms
+
+	// Drags are sampled with XQueryPointer at the drag sample rate rather than followed through
+	// motion events, so their cost does not depend on the mouse's polling rate
+	unsigned int pointerButtons = 0;
+	uint64_t nextPointerSample = 0;
+
+	// A new thread starts with the scheduling OBS gave it, which only an enabled mode changes
+	if (lowLatencyEnabled) {
+		lowLatencyChanged = true;
+	}
+	uint64_t lastLatencyReport = hotkeyCoreTimeNs();
 
 	blog(LOG_INFO, "[StreamUP Hotkey Display] Linux keyboard hook thread started");
+	notifyCaptureStarted(true);
 
 	XEvent event;
 	while (linuxHookRunning) {
-		// Use select to check for events with timeout
-		FD_ZERO(&readfds);
-		FD_SET(fd, &readfds);
-		tv.tv_sec = 0;
-		tv.tv_usec = 100000; // 100ms timeout
+		if (lowLatencyChanged.exchange(false)) {
+			applyCaptureThreadLatency("X11 capture thread");
+		}
+		if (gamepadSettingsChanged.exchange(false)) {
+			applyGamepadSettings(gamepadMonitor);
+		}
+
+		pollFds.clear();
+		pollFds.push_back({ConnectionNumber(display), POLLIN, 0});
+		gamepadMonitor.appendPollFds(pollFds);
 
-		int result = select(fd + 1, &readfds, nullptr, nullptr, &tv);
+		uint64_t waitStart = hotkeyCoreTimeNs();
+		bool samplingPointer = mouseMotionActive();
+		uint64_t timeoutNs = POLL_TIMEOUT_NS;
+		if (samplingPointer) {
+			timeoutNs = nextPointerSample > waitStart ? std::min(nextPointerSample - waitStart, POLL_TIMEOUT_NS) : 0;
+		} else {
+			pointerButtons = 0;
+		}
+		uint64_t rebuildDue = xkbKeymapCache().rebuildDueTime();
+		if (rebuildDue != 0) {
+			timeoutNs = std::min(timeoutNs, rebuildDue > waitStart ? rebuildDue - waitStart : 0);
+		}
+		// Events Xlib has already read off the connection would not wake poll()
+		if (XQLength(display) > 0) {
+			timeoutNs = 0;
+		}
+
+		timespec timeout = {(time_t)(timeoutNs / 1000000000), (long)(timeoutNs % 1000000000)};
+		int result = ppoll(pollFds.data(), (nfds_t)pollFds.size(), &timeout, nullptr);
 		if (result < 0) {
-			blog(LOG_ERROR, "[StreamUP Hotkey Display] select() error in X11 event loop");
+			if (errno == EINTR) {
+				continue;
+			}
+			blog(LOG_ERROR, "[StreamUP Hotkey Display] poll() error in X11 event loop");
 			break;
 		}
 
+		if (xkbKeymapCache().rebuildIfDue(hotkeyCoreTimeNs())) {
+			// Sinks may still be naming keys from the replaced tables
+			chordDispatcher().quiesce();
+			xkbKeymapCache().releaseRetired();
+		}
+
+		if (samplingPointer && hotkeyCoreTimeNs() >= nextPointerSample) {
+			Window rootReturn;
+			Window childReturn;
+			int pointerX = 0;
+			int pointerY = 0;
+			int windowX = 0;
+			int windowY = 0;
+			unsigned int buttons = 0;
+			if (XQueryPointer(display, root, &rootReturn, &childReturn, &pointerX, &pointerY, &windowX, &windowY,
+					  &buttons)) {
+				uint64_t now = hotkeyCoreTimeNs();
+				mouseMotion.move(pointerX, pointerY, now);
+
+				constexpr struct {
+					unsigned int mask;
+					MotionButton button;
+				} DRAG_BUTTONS[] = {{Button1Mask, MotionButton::Left},
+						    {Button3Mask, MotionButton::Right},
+						    {Button2Mask, MotionButton::Middle}};
+				for (const auto &dragButton : DRAG_BUTTONS) {
+					bool down = (buttons & dragButton.mask) != 0;
+					if (down && !(pointerButtons & dragButton.mask)) {
+						mouseMotion.buttonDown(dragButton.button, pointerX, pointerY, now);
+					} else if (!down && (pointerButtons & dragButton.mask)) {
+						finishMouseDrag(dragButton.button, pointerX, pointerY, now);
+					}
+				}
+				pointerButtons = buttons;
+			}
+			nextPointerSample = hotkeyCoreTimeNs() + 1000000000ull / mouseMotionRate.load(std::memory_order_relaxed);
+		}
+
 		if (result == 0) {
-			// Timeout - check if we should continue running
-			continue;
+			// Timeout: how much later than requested the thread ran is its scheduling delay
+			uint64_t now = hotkeyCoreTimeNs();
+			if (now > waitStart + timeoutNs) {
+				captureWakeDelay.record(now - waitStart - timeoutNs);
+			}
+			if (lowLatencyEnabled && now - lastLatencyReport >= LATENCY_REPORT_INTERVAL_NS) {
+				reportCaptureLatency();
+				lastLatencyReport = now;
+			}
+			// The round trips above (XQueryPointer, the keymap rebuild) queue whatever events
+			// arrived meanwhile inside Xlib, where the next poll() would not see them
+			if (XQLength(display) == 0) {
+				continue;
+			}
+		} else {
+			gamepadMonitor.handleReadable(pollFds.data() + 1, pollFds.size() - 1);
 		}
 
 		// Process all pending events
 		while (linuxHookRunning && XPending(display)) {
 			XNextEvent(display, &event);
+			if (xkbKeymapCache().handleEvent(event) || activeWindowTracker().handleEvent(event)) {
+				continue;
+			}
 			if (event.type == KeyPress) {
-				KeySym keysym = XLookupKeysym(&event.xkey, 0);
-				int keyCode = XKeysymToKeycode(display, keysym);
-				{
-					std::lock_guard<std::mutex> lock(keyStateMutex);
-					pressedKeys.insert(keyCode);
-					if (modifierKeys.count(keyCode)) {
-						activeModifiers.insert(keyCode);
-					}
-				}
-
-				if ((pressedKeys.size() > 1 && isModifierKeyPressed() && shouldLogCombination()) ||
-				    (shouldCaptureSingleKey(keyCode) && !activeModifiers.count(XK_Shift_L) &&
-				     !activeModifiers.count(XK_Shift_R))) {
-					std::string keyCombination = getCurrentCombination();
-					bool shouldLog = false;
-					{
-						std::lock_guard<std::mutex> lock(keyStateMutex);
-						if (loggedCombinations.find(keyCombination) == loggedCombinations.end()) {
-							loggedCombinations.insert(keyCombination);
-							shouldLog = true;
-						}
-					}
-					if (shouldLog) {
-				if (enableLogging) {
-						blog(LOG_INFO, "[StreamUP Hotkey Display] Keys pressed: %s", keyCombination.c_str());
-				}
-						if (hotkeyDisplayDock) {
-							hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-						}
-						emitWebSocketEvent(keyCombination);
-					}
-				}
+				hotkeyEngine.keyEvent((int)event.xkey.keycode, true, false, hotkeyCoreTimeNs());
 			} else if (event.type == KeyRelease) {
-				KeySym keysym = XLookupKeysym(&event.xkey, 0);
-				int keyCode = XKeysymToKeycode(display, keysym);
-				{
-					std::lock_guard<std::mutex> lock(keyStateMutex);
-					pressedKeys.erase(keyCode);
-					if (modifierKeys.count(keyCode)) {
-						activeModifiers.erase(keyCode);
-					}
-
-					// Check if we should clear combinations while holding the lock
-					if (activeModifiers.empty() ||
-					    std::none_of(activeModifiers.begin(), activeModifiers.end(),
-					                 [](int key) { return pressedKeys.count(key) > 0; })) {
-						loggedCombinations.clear();
+				// Without detectable autorepeat every repeat is a release/press pair with the same
+				// timestamp; fold the pair into a repeat instead of a release and a new press
+				if (!detectableAutoRepeat && XEventsQueued(display, QueuedAfterReading) > 0) {
+					XEvent next;
+					XPeekEvent(display, &next);
+					if (next.type == KeyPress && next.xkey.keycode == event.xkey.keycode &&
+					    next.xkey.time == event.xkey.time) {
+						XNextEvent(display, &next);
+						hotkeyEngine.keyEvent((int)event.xkey.keycode, true, true, hotkeyCoreTimeNs());
+						continue;
 					}
 				}
+				hotkeyEngine.keyEvent((int)event.xkey.keycode, false, false, hotkeyCoreTimeNs());
 			} else if (event.type == ButtonPress) {
 				// Handle mouse button clicks (only when modifier keys are pressed)
-				if (isModifierKeyPressed()) {
-					std::string keyCombination = getCurrentCombination();
+				if (hotkeyEngine.anyModifierPressed()) {
+					char buttonText[32];
+					const char *action = nullptr;
 
 					// X11 button numbers: 1=Left, 2=Middle, 3=Right, 4=ScrollUp, 5=ScrollDown, 8=Back, 9=Forward
 					unsigned int button = event.xbutton.button;
 					switch (button) {
 					case 1:
-						keyCombination += " + Left Click";
+						action = " + Left Click";
 						break;
 					case 2:
-						keyCombination += " + Middle Click";
+						action = " + Middle Click";
 						break;
 					case 3:
-						keyCombination += " + Right Click";
+						action = " + Right Click";
 						break;
 					case 4:
-						keyCombination += " + Scroll Up";
+						action = " + Scroll Up";
 						break;
 					case 5:
-						keyCombination += " + Scroll Down";
+						action = " + Scroll Down";
 						break;
 					case 6:
-						keyCombination += " + Scroll Left";
+						action = " + Scroll Left";
 						break;
 					case 7:
-						keyCombination += " + Scroll Right";
+						action = " + Scroll Right";
 						break;
 					case 8:
-						keyCombination += " + Back Button";
+						action = " + Back Button";
 						break;
 					case 9:
-						keyCombination += " + Forward Button";
+						action = " + Forward Button";
 						break;
 					default:
-						keyCombination += " + Button " + std::to_string(button);
+						snprintf(buttonText, sizeof(buttonText), " + Button %d", (int)button);
+						action = buttonText;
 						break;
 					}
 
-			if (enableLogging) {
-					blog(LOG_INFO, "[StreamUP Hotkey Display] Mouse action detected: %s",
-					     keyCombination.c_str());
-					if (hotkeyDisplayDock) {
-						hotkeyDisplayDock->setLog(QString::fromStdString(keyCombination));
-					}
-			}
+					// Buttons 4-7 are the wheel axes
+					hotkeyEngine.mouseAction(action, hotkeyCoreTimeNs(), button >= 4 && button <= 7);
 				}
 			}
 		}
 	}
 
+	gamepadMonitor.stop();
 	if (display) {
+		activeWindowTracker().stop();
+		xkbKeymapCache().stop();
+		chordDispatcher().quiesce();
+		xkbKeymapCache().releaseRetired();
 		XCloseDisplay(display);
 		display = nullptr;
 	}
@@ -826,6 +1220,11 @@ void startLinuxKeyboardHook()
 		return;
 	}
 
+	// A thread that failed to open the display has already exited but was never joined
+	if (linuxHookThread.joinable()) {
+		linuxHookThread.join();
+	}
+
 	linuxHookRunning = true;
 	linuxHookThread = std::thread(linuxKeyboardHookThreadFunc);
 }
@@ -833,6 +1232,9 @@ void startLinuxKeyboardHook()
 void stopLinuxKeyboardHook()
 {
 	if (!linuxHookRunning) {
+		if (linuxHookThread.joinable()) {
+			linuxHookThread.join();
+		}
 		return;
 	}
 
@@ -886,6 +1288,8 @@ obs_data_t *SaveLoadSettingsCallback(obs_data_t *save_data, bool saving)
 			bfree(dirPath);
 
 			data = obs_data_create();
+			// Installs that predate the setting keep the websocket broadcast; new ones opt in
+			obs_data_set_bool(data, "websocketBroadcast", false);
 
 			if (obs_data_save_json(data, configPath)) {
 				blog(LOG_INFO, "[StreamUP Hotkey Display] Default settings saved to %s", configPath);
@@ -993,16 +1397,94 @@ void loadSingleKeyCaptureSettings(obs_data_t *settings)
 		return;
 	}
 
-	captureNumpad = obs_data_get_bool(settings, "captureNumpad");
-	captureNumbers = obs_data_get_bool(settings, "captureNumbers");
-	captureLetters = obs_data_get_bool(settings, "captureLetters");
-	capturePunctuation = obs_data_get_bool(settings, "capturePunctuation");
+	HotkeyFilterSettings filterSettings;
+	filterSettings.captureNumpad = obs_data_get_bool(settings, "captureNumpad");
+	filterSettings.captureNumbers = obs_data_get_bool(settings, "captureNumbers");
+	filterSettings.captureLetters = obs_data_get_bool(settings, "captureLetters");
+	filterSettings.capturePunctuation = obs_data_get_bool(settings, "capturePunctuation");
+	hotkeyEngine.setFilterSettings(filterSettings);
+
+	// Per-application profiles start from the global settings
+	CaptureProfile defaultProfile;
+	defaultProfile.filter = filterSettings;
+	std::vector<std::string> profileErrors;
+	std::vector<CaptureProfile> profiles =
+		parseCaptureProfiles(obs_data_get_string(settings, "appProfiles"), defaultProfile, &profileErrors);
+	for (const std::string &error : profileErrors) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] Application profiles, %s", error.c_str());
+	}
+	captureProfiles.setProfiles(defaultProfile, profiles);
+	// The replaced profiles are freed once neither the hooks nor the dispatcher can still hold them
+	hotkeyEngine.quiesce();
+	chordDispatcher().quiesce();
+	captureProfiles.releaseRetired();
 
 	QString whitelist = QString::fromUtf8(obs_data_get_string(settings, "whitelistedKeys"));
 	parseWhitelistKeys(whitelist);
 
 	// Load logging settings (default to false)
 	enableLogging = obs_data_get_bool(settings, "enableLogging");
+
+	// Per-chord websocket broadcast, on for settings saved before it could be turned off
+	setWebSocketBroadcast(!obs_data_has_user_value(settings, "websocketBroadcast") ||
+			      obs_data_get_bool(settings, "websocketBroadcast"));
+
+	// Mouse burst merging (0 disables it)
+	int coalesceWindow = obs_data_has_user_value(settings, "coalesceWindow")
+				     ? (int)obs_data_get_int(settings, "coalesceWindow")
+				     : StyleConstants::DEFAULT_COALESCE_WINDOW;
+	mouseCoalescer.setWindow((uint64_t)std::max(coalesceWindow, 0));
+
+#ifndef _WIN32
+	applyEventSocketSetting(obs_data_get_bool(settings, "eventSocketEnabled"));
+	applyOverlayServerSetting(obs_data_get_bool(settings, "overlayServerEnabled"),
+				  obs_data_has_user_value(settings, "overlayServerPort")
+					  ? (int)obs_data_get_int(settings, "overlayServerPort")
+					  : StyleConstants::DEFAULT_OVERLAY_PORT);
+#endif
+
+	LowLatencyConfig latencyConfig;
+	latencyConfig.enabled = obs_data_get_bool(settings, "lowLatencyMode");
+	latencyConfig.cpu = obs_data_has_user_value(settings, "lowLatencyCpu") ? (int)obs_data_get_int(settings, "lowLatencyCpu")
+									       : -1;
+	applyLowLatencySetting(latencyConfig);
+
+	// Drag gestures
+	int motionRate = obs_data_has_user_value(settings, "mouseMotionRate") ? (int)obs_data_get_int(settings, "mouseMotionRate")
+									      : StyleConstants::DEFAULT_MOUSE_MOTION_RATE;
+	MotionSettings motionSettings;
+	motionSettings.outputRate = (uint32_t)std::max(motionRate, 1);
+	mouseMotion.setSettings(motionSettings);
+	mouseMotionRate = motionSettings.outputRate;
+	mouseMotionEnabled = obs_data_get_bool(settings, "captureMouseDrags");
+#ifdef __APPLE__
+	if (eventTap && eventTapTracksDrags != mouseMotionEnabled) {
+		stopMacOSKeyboardHook();
+		startMacOSKeyboardHook();
+	}
+#endif
+
+#ifdef __linux__
+	gamepadCaptureEnabled = obs_data_get_bool(settings, "captureGamepad");
+	gamepadDeadzonePercent = obs_data_has_user_value(settings, "gamepadDeadzone")
+					 ? (int)obs_data_get_int(settings, "gamepadDeadzone")
+					 : StyleConstants::DEFAULT_GAMEPAD_DEADZONE;
+	gamepadSettingsChanged = true;
+#endif
+
+	// Takes effect with the next recording
+	subtitleFormatSetting = (int)parseSubtitleFormat(obs_data_get_string(settings, "subtitleFormat"));
+	int onScreenTime = (int)obs_data_get_int(settings, "onScreenTime");
+	subtitleCueMs = onScreenTime > 0 ? onScreenTime : StyleConstants::DEFAULT_ONSCREEN_TIME;
+
+	// Multi-stroke sequences
+	sequenceMatcher.compile(parseSequenceDefinitions(obs_data_get_string(settings, "keySequences")));
+	int sequenceTimeout = obs_data_has_user_value(settings, "sequenceTimeout")
+				      ? (int)obs_data_get_int(settings, "sequenceTimeout")
+				      : StyleConstants::DEFAULT_SEQUENCE_TIMEOUT;
+	sequenceMatcher.setStepTimeout((uint64_t)std::max(sequenceTimeout, 0));
+
+	applyActionDictionarySetting(obs_data_get_string(settings, "actionDictionary"));
 }
 
 void loadDockSettings(HotkeyDisplayDock *dock, obs_data_t *settings)
@@ -1012,44 +1494,74 @@ void loadDockSettings(HotkeyDisplayDock *dock, obs_data_t *settings)
 	}
 
 	// Load settings with defaults
-	dock->sceneName = QString::fromUtf8(obs_data_get_string(settings, "sceneName"));
-	dock->textSource = QString::fromUtf8(obs_data_get_string(settings, "textSource"));
+	dock->setOutputTargets(loadOutputTargets(settings));
 	dock->onScreenTime = obs_data_get_int(settings, "onScreenTime");
-	dock->prefix = QString::fromUtf8(obs_data_get_string(settings, "prefix"));
-	dock->suffix = QString::fromUtf8(obs_data_get_string(settings, "suffix"));
 	dock->setDisplayInTextSource(obs_data_get_bool(settings, "displayInTextSource"));
 
 	// Apply defaults if empty
-	if (dock->sceneName.isEmpty()) {
-		dock->sceneName = StyleConstants::DEFAULT_SCENE_NAME;
-	}
-	if (dock->textSource.isEmpty()) {
-		dock->textSource = StyleConstants::DEFAULT_TEXT_SOURCE;
-	}
 	if (dock->onScreenTime == 0) {
 		dock->onScreenTime = StyleConstants::DEFAULT_ONSCREEN_TIME;
 	}
 }
 
-void applyDockUISettings(HotkeyDisplayDock *dock, bool hookEnabled)
+// Set by obs_module_load when the hook was enabled last session; consumed on FINISHED_LOADING
+static bool deferredHookStart = false;
+
+static void frontendEventCallback(enum obs_frontend_event event, void *)
 {
-	if (!dock) {
+	switch (event) {
+	case OBS_FRONTEND_EVENT_RECORDING_STARTED:
+		startRecordingSubtitles();
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_STOPPED:
+		stopRecordingSubtitles();
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_PAUSED:
+		subtitleWriter.pause(hotkeyCoreTimeNs());
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_UNPAUSED:
+		subtitleWriter.resume(hotkeyCoreTimeNs());
+		break;
+	default:
+		break;
+	}
+
+	if (!hotkeyDisplayDock) {
 		return;
 	}
 
-	const char *actionText = hookEnabled ? obs_module_text("Dock.Button.Disable") : obs_module_text("Dock.Button.Enable");
-	const char *state = hookEnabled ? "active" : "inactive";
+	switch (event) {
+	case OBS_FRONTEND_EVENT_FINISHED_LOADING:
+		// Output targets resolve as the index reaches their scenes
+		hotkeyDisplayDock->getSceneSourceIndex().start();
+		hotkeyDisplayDock->resolveOutputTargets();
 
-	dock->getToggleAction()->setChecked(hookEnabled);
-	dock->getToggleAction()->setText(actionText);
-	QLabel *label = dock->getLabel();
-	label->setProperty("hotkeyState", state);
-	label->style()->unpolish(label);
-	label->style()->polish(label);
+		// Hook startup waits until every plugin has loaded so it does not add to OBS startup time
+		if (deferredHookStart) {
+			deferredHookStart = false;
+			hotkeyDisplayDock->startDeferredCapture();
+		}
+		break;
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+	case OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED:
+		// Re-resolve cached scene item handles for every output target
+		hotkeyDisplayDock->getSceneSourceIndex().start(); // No-op unless a collection change stopped it
+		hotkeyDisplayDock->resolveOutputTargets();
+		break;
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+	case OBS_FRONTEND_EVENT_EXIT:
+		// Drop handles before the scenes they point to are destroyed
+		hotkeyDisplayDock->unresolveOutputTargets();
+		hotkeyDisplayDock->getSceneSourceIndex().stop();
+		break;
+	default:
+		break;
+	}
 }
 
 bool obs_module_load()
 {
+	uint64_t loadStart = os_gettime_ns();
 	blog(LOG_INFO, "[StreamUP Hotkey Display] loaded version %s", PROJECT_VERSION);
 
 	websocket_vendor = obs_websocket_register_vendor("streamup-hotkey-display");
@@ -1057,34 +1569,54 @@ bool obs_module_load()
 		blog(LOG_ERROR, "[StreamUP Hotkey Display] Failed to register websocket vendor!");
 		return false;
 	}
+	startWebSocketSubscriptions(websocket_vendor);
+
+	// Must run before any hook can start publishing
+	hotkeyEngine.setProfileSwitcher(&captureProfiles);
+	chordEventBus.subscribe(historyChordSink, nullptr);
+	chordEventBus.subscribe(logChordSink, nullptr);
+	chordEventBus.subscribe(dockChordSink, nullptr);
+	chordEventBus.subscribe(websocketChordSink, nullptr);
+	chordEventBus.subscribe(subtitleChordSink, nullptr);
+#ifndef _WIN32
+	chordEventBus.subscribe(socketChordSink, nullptr);
+	chordEventBus.subscribe(overlayChordSink, nullptr);
+#endif
+#ifdef __linux__
+	if (sharedEventRing.open(shmRingDefaultName())) {
+		chordEventBus.subscribe(sharedRingChordSink, nullptr);
+	} else {
+		blog(LOG_WARNING,
+		     "[StreamUP Hotkey Display] Failed to create the shared-memory event ring (is another OBS instance using it?)");
+	}
+#endif
+	chordDispatcher().start(dispatchChordEvent, flushChordEvents);
 
-	LoadHotkeyDisplayDock();
-
+	// The only settings read during startup; the dock constructor no longer touches disk
 	obs_data_t *settings = SaveLoadSettingsCallback(nullptr, false);
+	loadSingleKeyCaptureSettings(settings);
+
+	LoadHotkeyDisplayDock();
+	obs_frontend_add_event_callback(frontendEventCallback, nullptr);
 
 	if (settings && hotkeyDisplayDock) {
 		loadDockSettings(hotkeyDisplayDock, settings);
-		loadSingleKeyCaptureSettings(settings);
-		bool hookEnabled = obs_data_get_bool(settings, "hookEnabled");
-		hotkeyDisplayDock->setHookEnabled(hookEnabled);
-		applyDockUISettings(hotkeyDisplayDock, hookEnabled);
-		obs_data_release(settings);
-	} else if (hotkeyDisplayDock) {
-		// Apply defaults if no settings loaded
-		hotkeyDisplayDock->sceneName = StyleConstants::DEFAULT_SCENE_NAME;
-		hotkeyDisplayDock->textSource = StyleConstants::DEFAULT_TEXT_SOURCE;
-		hotkeyDisplayDock->onScreenTime = StyleConstants::DEFAULT_ONSCREEN_TIME;
-		hotkeyDisplayDock->prefix = "";
-		hotkeyDisplayDock->suffix = "";
-		hotkeyDisplayDock->setDisplayInTextSource(false);
-		applyDockUISettings(hotkeyDisplayDock, false);
+		if (obs_data_get_bool(settings, "hookEnabled")) {
+			deferredHookStart = true;
+			hotkeyDisplayDock->setStartingState();
+		}
 	}
+	obs_data_release(settings);
+
+	blog(LOG_INFO, "[StreamUP Hotkey Display] obs_module_load took %.2f ms", (double)(os_gettime_ns() - loadStart) / 1000000.0);
 
 	return true;
 }
 
 void obs_module_unload()
 {
+	obs_frontend_remove_event_callback(frontendEventCallback, nullptr);
+
 #ifdef _WIN32
 	if (keyboardHook) {
 		UnhookWindowsHookEx(keyboardHook);
@@ -1100,6 +1632,26 @@ void obs_module_unload()
 	stopLinuxKeyboardHook();
 #endif
 
+	// Hooks are gone, so nothing publishes anymore
+	if (lowLatencyEnabled) {
+		reportCaptureLatency();
+	}
+	uint64_t droppedEvents = chordDispatcher().stop();
+	if (droppedEvents > 0) {
+		blog(LOG_WARNING, "[StreamUP Hotkey Display] %llu key events were dropped because the dispatcher fell behind",
+		     (unsigned long long)droppedEvents);
+	}
+	stopRecordingSubtitles();
+	applyActionDictionarySetting("");
+#ifndef _WIN32
+	applyEventSocketSetting(false);
+	applyOverlayServerSetting(false, 0);
+#endif
+#ifdef __linux__
+	sharedEventRing.close();
+#endif
+
+	stopWebSocketSubscriptions();
 	if (websocket_vendor) {
 		obs_websocket_vendor_unregister_request(websocket_vendor, "streamup_hotkey_display");
 		websocket_vendor = nullptr;
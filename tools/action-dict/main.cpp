@@ -0,0 +1,98 @@
+// Converts a hand-written shortcut dictionary into the binary file the plugin memory-maps.
+//
+//   streamup-hotkey-actions-build <source.txt> <output.suhkact>
+//   streamup-hotkey-actions-build --lookup <output.suhkact> <chord> [application]
+
+#include "streamup-hotkey-core-actions.hpp"
+#include "streamup-hotkey-core-chord.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace {
+
+bool readFile(const char *path, std::string &contents)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+
+	char buffer[65536];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+		contents.append(buffer, count);
+	}
+	bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+bool writeFile(const char *path, const std::string &contents)
+{
+	FILE *file = fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+
+	bool ok = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+	return fclose(file) == 0 && ok;
+}
+
+int printUsage(const char *program)
+{
+	printf("usage: %s <source.txt> <output.suhkact>\n", program);
+	printf("       %s --lookup <output.suhkact> <chord> [application]\n", program);
+	return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	if (argc >= 4 && strcmp(argv[1], "--lookup") == 0) {
+		ActionDictionary dictionary;
+		if (!dictionary.open(argv[2])) {
+			fprintf(stderr, "%s is not a valid dictionary\n", argv[2]);
+			return 1;
+		}
+
+		std::string chord = normaliseChordText(argv[3]);
+		std::string_view label = dictionary.lookup(hashChordText(chord), argc >= 5 ? argv[4] : "");
+		if (label.empty()) {
+			fprintf(stderr, "No action for %s\n", chord.c_str());
+			return 1;
+		}
+		printf("%.*s\n", (int)label.size(), label.data());
+		return 0;
+	}
+
+	if (argc != 3) {
+		return printUsage(argv[0]);
+	}
+
+	std::string source;
+	if (!readFile(argv[1], source)) {
+		fprintf(stderr, "Cannot read %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<std::string> errors;
+	std::vector<ActionDictionaryEntry> entries = parseActionDictionarySource(source, &errors);
+	for (const std::string &error : errors) {
+		fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+	}
+
+	std::string output;
+	if (!buildActionDictionary(entries, output)) {
+		fprintf(stderr, "No perfect hash found for %zu entries\n", entries.size());
+		return 1;
+	}
+	if (!writeFile(argv[2], output)) {
+		fprintf(stderr, "Cannot write %s\n", argv[2]);
+		return 1;
+	}
+
+	printf("Wrote %zu entries (%zu bytes) to %s\n", entries.size(), output.size(), argv[2]);
+	return errors.empty() ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+// Exercises evdev gamepad capture without a physical controller: creates a uinput virtual pad
+// after the monitor has started (so hotplug is covered too), plays a fixed script of buttons,
+// stick jitter and trigger pulls, and checks the chords that come out of the dispatcher.
+//
+//   streamup-hotkey-gamepad-test [input-directory]
+//
+// Needs write access to /dev/uinput and read access to the new event node (root, or the
+// "input" group with a matching udev rule). Exits with 77 when uinput is unavailable.
+
+#include "streamup-hotkey-core-evdev.hpp"
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <mutex>
+#include <string>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int EXIT_SKIPPED = 77;
+constexpr int STICK_RANGE = 32767;
+
+std::mutex chordsMutex;
+std::vector<std::string> chords;
+
+void recordChord(const ChordEvent &event)
+{
+	std::string line = event.kind == ChordKind::Release ? "release " : "";
+	line += std::string(event.text.view());
+	printf("  %s\n", line.c_str());
+	std::lock_guard<std::mutex> lock(chordsMutex);
+	chords.push_back(line);
+}
+
+void deviceChanged(const GamepadDeviceInfo &device, bool connected, void *)
+{
+	printf("%s %s (%s)\n", connected ? "Connected" : "Disconnected", device.name.c_str(), device.path.c_str());
+}
+
+class VirtualPad {
+public:
+	~VirtualPad()
+	{
+		if (fd >= 0) {
+			ioctl(fd, UI_DEV_DESTROY);
+			close(fd);
+		}
+	}
+
+	bool create()
+	{
+		fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) {
+			return false;
+		}
+
+		ioctl(fd, UI_SET_EVBIT, EV_KEY);
+		for (int code : {BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST, BTN_TL, BTN_TR, BTN_SELECT, BTN_START, BTN_MODE,
+				 BTN_THUMBL, BTN_THUMBR}) {
+			ioctl(fd, UI_SET_KEYBIT, code);
+		}
+		ioctl(fd, UI_SET_EVBIT, EV_ABS);
+		setupAxis(ABS_X, -STICK_RANGE - 1, STICK_RANGE);
+		setupAxis(ABS_Y, -STICK_RANGE - 1, STICK_RANGE);
+		setupAxis(ABS_RX, -STICK_RANGE - 1, STICK_RANGE);
+		setupAxis(ABS_RY, -STICK_RANGE - 1, STICK_RANGE);
+		setupAxis(ABS_Z, 0, 255);
+		setupAxis(ABS_RZ, 0, 255);
+		setupAxis(ABS_HAT0X, -1, 1);
+		setupAxis(ABS_HAT0Y, -1, 1);
+
+		uinput_setup setup = {};
+		setup.id.bustype = BUS_VIRTUAL;
+		setup.id.vendor = 0x045e; // Same ids as an Xbox 360 pad
+		setup.id.product = 0x028e;
+		snprintf(setup.name, sizeof(setup.name), "StreamUP virtual gamepad");
+		return ioctl(fd, UI_DEV_SETUP, &setup) == 0 && ioctl(fd, UI_DEV_CREATE) == 0;
+	}
+
+	void emit(uint16_t type, uint16_t code, int32_t value)
+	{
+		input_event event = {};
+		event.type = type;
+		event.code = code;
+		event.value = value;
+		if (write(fd, &event, sizeof(event)) != (ssize_t)sizeof(event)) {
+			perror("uinput write");
+		}
+	}
+
+	void button(uint16_t code, bool pressed) { emit(EV_KEY, code, pressed ? 1 : 0); }
+	void axis(uint16_t code, int32_t value) { emit(EV_ABS, code, value); }
+	void report() { emit(EV_SYN, SYN_REPORT, 0); }
+
+private:
+	void setupAxis(uint16_t code, int32_t minimum, int32_t maximum)
+	{
+		ioctl(fd, UI_SET_ABSBIT, code);
+		uinput_abs_setup setup = {};
+		setup.code = code;
+		setup.absinfo.minimum = minimum;
+		setup.absinfo.maximum = maximum;
+		ioctl(fd, UI_ABS_SETUP, &setup);
+	}
+
+	int fd = -1;
+};
+
+// Runs the capture side for a while, like the plugin's hook thread does
+void pump(GamepadDeviceMonitor &monitor, int milliseconds)
+{
+	auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+	std::vector<pollfd> fds;
+	while (std::chrono::steady_clock::now() < end) {
+		fds.clear();
+		monitor.appendPollFds(fds);
+		if (poll(fds.data(), fds.size(), 5) > 0) {
+			monitor.handleReadable(fds.data(), fds.size());
+		}
+	}
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::string directory = argc > 1 ? argv[1] : "/dev/input";
+	if (access("/dev/uinput", W_OK) != 0) {
+		fprintf(stderr, "Skipped: /dev/uinput is not writable (%s)\n", strerror(errno));
+		return EXIT_SKIPPED;
+	}
+
+	ChordDispatcher &dispatcher = chordDispatcher();
+	dispatcher.start(recordChord);
+
+	GamepadDeviceMonitor monitor(dispatcher);
+	if (!monitor.start(directory, deviceChanged, nullptr)) {
+		fprintf(stderr, "Cannot watch %s: %s\n", directory.c_str(), strerror(errno));
+		dispatcher.stop();
+		return 1;
+	}
+	size_t devicesBefore = monitor.deviceCount();
+
+	VirtualPad pad;
+	if (!pad.create()) {
+		fprintf(stderr, "Cannot create a uinput device: %s\n", strerror(errno));
+		dispatcher.stop();
+		return EXIT_SKIPPED;
+	}
+	for (int waited = 0; monitor.deviceCount() == devicesBefore && waited < 2000; waited += 50) {
+		pump(monitor, 50);
+	}
+	if (monitor.deviceCount() == devicesBefore) {
+		fprintf(stderr, "The virtual pad did not appear in %s (%zu nodes not readable)\n", directory.c_str(),
+			monitor.inaccessibleCount());
+		dispatcher.stop();
+		return 1;
+	}
+
+	printf("Chords:\n");
+	auto step = [&](auto action) {
+		action();
+		pad.report();
+		pump(monitor, 20);
+	};
+
+	step([&] { pad.button(BTN_SOUTH, true); });
+	step([&] { pad.button(BTN_SOUTH, false); });
+	step([&] { pad.button(BTN_TL, true); });
+	step([&] { pad.button(BTN_SOUTH, true); });
+	step([&] { pad.button(BTN_SOUTH, false); });
+	step([&] { pad.button(BTN_TL, false); });
+
+	// One second of a noisy resting stick at 1 kHz: nothing may come out of this
+	for (int i = 0; i < 1000; i++) {
+		pad.axis(ABS_X, (i * 7919) % 1200 - 600);
+		pad.axis(ABS_Y, (i * 104729) % 1200 - 600);
+		pad.report();
+		if (i % 5 == 4) {
+			pump(monitor, 5);
+		}
+	}
+
+	// A sweep to full up and back, then a trigger pull and the D-pad hat
+	for (int value = 0; value >= -STICK_RANGE; value -= 1024) {
+		step([&] { pad.axis(ABS_Y, value); });
+	}
+	step([&] { pad.axis(ABS_Y, 0); });
+	for (int value = 0; value <= 255; value += 15) {
+		step([&] { pad.axis(ABS_RZ, value); });
+	}
+	step([&] { pad.axis(ABS_RZ, 0); });
+	step([&] { pad.axis(ABS_HAT0Y, -1); });
+	step([&] { pad.axis(ABS_HAT0Y, 0); });
+
+	uint64_t reports = monitor.axisReports();
+	uint64_t accepted = monitor.axisReportsAccepted();
+	monitor.stop();
+	dispatcher.stop();
+
+	printf("Axis reports: %llu received, %llu past the change threshold\n", (unsigned long long)reports,
+	       (unsigned long long)accepted);
+
+	const std::vector<std::string> expected = {
+		"A",
+		"release A",
+		"LB",
+		"LB + A",
+		"release LB + A",
+		"L Stick Up",
+		"release L Stick Up",
+		"RT",
+		"release RT",
+		"D-Pad Up",
+		"release D-Pad Up",
+	};
+	std::lock_guard<std::mutex> lock(chordsMutex);
+	if (chords != expected) {
+		fprintf(stderr, "Unexpected chords; expected:\n");
+		for (const std::string &line : expected) {
+			fprintf(stderr, "  %s\n", line.c_str());
+		}
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
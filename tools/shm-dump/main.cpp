@@ -0,0 +1,93 @@
+// Reference consumer for the shared-memory event ring: prints every chord the plugin shows.
+//
+//   streamup-hotkey-shm-dump [--from-oldest] [ring-name]
+
+#include "streamup-hotkey-core-shm.hpp"
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void handleSignal(int)
+{
+	stopRequested = 1;
+}
+
+const char *kindName(uint8_t kind)
+{
+	switch (kind) {
+	case SHM_RECORD_KEYBOARD:
+		return "press";
+	case SHM_RECORD_MOUSE:
+		return "mouse";
+	case SHM_RECORD_SCROLL:
+		return "scroll";
+	case SHM_RECORD_RELEASE:
+		return "release";
+	case SHM_RECORD_GAMEPAD:
+		return "gamepad";
+	case SHM_RECORD_GESTURE:
+		return "gesture";
+	default:
+		return "unknown";
+	}
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	bool fromOldest = false;
+	std::string name = shmRingDefaultName();
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--from-oldest") == 0) {
+			fromOldest = true;
+		} else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+			printf("usage: %s [--from-oldest] [ring-name]\n", argv[0]);
+			return 0;
+		} else {
+			name = argv[i];
+		}
+	}
+
+	signal(SIGINT, handleSignal);
+	signal(SIGTERM, handleSignal);
+
+	ShmRingReader reader;
+	while (!reader.open(name, fromOldest)) {
+		if (stopRequested) {
+			return 0;
+		}
+		fprintf(stderr, "Waiting for %s (is the plugin loaded and capturing?)\n", name.c_str());
+		sleep(1);
+	}
+	fprintf(stderr, "Reading %s\n", name.c_str());
+
+	ShmRingEvent event;
+	uint64_t reportedLost = 0;
+	while (!stopRequested) {
+		while (reader.next(event)) {
+			// Count updates of a merged burst are marked so they can be told from new entries
+			printf("%llu %llu.%06llu %-7s %s%s\n", (unsigned long long)event.sequence,
+			       (unsigned long long)(event.timestampNs / 1000000000ull),
+			       (unsigned long long)(event.timestampNs % 1000000000ull / 1000ull), kindName(event.kind),
+			       (event.flags & SHM_RECORD_REPLACES_PREVIOUS) ? "~ " : "", event.text);
+		}
+		fflush(stdout);
+
+		if (reader.lostCount() != reportedLost) {
+			fprintf(stderr, "Lost %llu records\n", (unsigned long long)(reader.lostCount() - reportedLost));
+			reportedLost = reader.lostCount();
+		}
+
+		// Wake up periodically so signals are noticed
+		reader.wait(500);
+	}
+
+	return 0;
+}